@@ -0,0 +1,13 @@
+$input v_color0, v_color1, v_texcoord0
+
+#include "../bgfx_shader.sh"
+
+SAMPLER2D(s_texColor, 0);
+
+void main()
+{
+	// v_color0 is the light color, v_color1 the dark color; v_color1.a is 1 for premultiplied alpha.
+	vec4 texColor = texture2D(s_texColor, v_texcoord0);
+	gl_FragColor.a = texColor.a * v_color0.a;
+	gl_FragColor.rgb = ((texColor.a - 1.0) * v_color1.a + 1.0 - texColor.rgb) * v_color1.rgb + texColor.rgb * v_color0.rgb;
+}
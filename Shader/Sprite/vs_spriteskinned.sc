@@ -0,0 +1,27 @@
+$input a_position, a_texcoord0, a_texcoord1, a_weight, a_indices
+$output v_color0, v_texcoord0
+
+#include "../bgfx_shader.sh"
+
+uniform vec4 u_bones[120];
+uniform vec4 u_skinColor;
+
+vec2 skin(vec2 local, float bone)
+{
+	int i = int(bone) * 2;
+	vec3 p = vec3(local, 1.0);
+	return vec2(dot(u_bones[i].xyz, p), dot(u_bones[i + 1].xyz, p));
+}
+
+void main()
+{
+	vec2 position = skin(a_position.xy, a_indices.x) * a_weight.x
+		+ skin(a_position.zw, a_indices.y) * a_weight.y
+		+ skin(a_texcoord1.xy, a_indices.z) * a_weight.z
+		+ skin(a_texcoord1.zw, a_indices.w) * a_weight.w;
+	vec4 world = mul(u_model[0], vec4(position, 0.0, 1.0));
+	gl_Position = mul(u_viewProj, vec4(world.xy, 0.0, 1.0));
+	gl_Position.z = world.z;
+	v_color0 = u_skinColor;
+	v_texcoord0 = a_texcoord0;
+}
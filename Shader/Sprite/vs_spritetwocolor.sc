@@ -0,0 +1,13 @@
+$input a_position, a_texcoord0, a_color0, a_color1
+$output v_color0, v_color1, v_texcoord0
+
+#include "../bgfx_shader.sh"
+
+void main()
+{
+	gl_Position = mul(u_viewProj, vec4(a_position.xy, 0.0, 1.0));
+	gl_Position.z = a_position.z;
+	v_color0 = a_color0;
+	v_color1 = a_color1;
+	v_texcoord0 = a_texcoord0;
+}
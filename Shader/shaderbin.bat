@@ -15,6 +15,9 @@ shaderc.exe -f .\Sprite\fs_spritelight.sc -o .\shader\glsl\fs_spritelight.bin  -
 ::shaderc.exe -f .\Sprite\vs_spritemodel.sc -o .\shader\glsl\vs_spritemodel.bin.h --bin2c spritemodedx11  -i .\ --varyingdef .\Draw\varying.def.sc --platform windows -p vs_4_0 -O 3 --type vertex -O3
 shaderc.exe -f .\Sprite\vs_spritemodel.sc -o .\shader\glsl\vs_spritemodel.bin  -i .\ --varyingdef .\Draw\varying.def.sc --platform linux -p 120 --type vertex -O3
 shaderc.exe -f .\Sprite\fs_spritegray.sc -o .\shader\glsl\fs_spritegray.bin  -i .\ --varyingdef .\Sprite\varying.def.sc --platform linux -p 120 --type fragment -O3
+shaderc.exe -f .\Sprite\vs_spritetwocolor.sc -o .\shader\glsl\vs_spritetwocolor.bin  -i .\ --varyingdef .\Sprite\varying.def.sc --platform linux -p 120 --type vertex -O3
+shaderc.exe -f .\Sprite\vs_spriteskinned.sc -o .\shader\glsl\vs_spriteskinned.bin  -i .\ --varyingdef .\Sprite\varying.def.sc --platform linux -p 120 --type vertex -O3
+shaderc.exe -f .\Sprite\fs_spritetwocolor.sc -o .\shader\glsl\fs_spritetwocolor.bin  -i .\ --varyingdef .\Sprite\varying.def.sc --platform linux -p 120 --type fragment -O3
 shaderc.exe -f .\Sprite\fs_spritealphatest.sc -o .\shader\glsl\fs_spritealphatest.bin  -i .\ --varyingdef .\Sprite\varying.def.sc --platform linux -p 120 --type fragment -O3
 shaderc.exe -f .\Label\vs_labelposition.sc -o .\shader\glsl\vs_labelposition.bin  -i .\ --varyingdef .\Label\varying.def.sc --platform linux -p 120 --type vertex -O3
 shaderc.exe -f .\Label\vs_label.sc -o .\shader\glsl\vs_label.bin  -i .\ --varyingdef .\Label\varying.def.sc --platform linux -p 120 --type vertex -O3
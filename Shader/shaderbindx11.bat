@@ -16,6 +16,9 @@ shaderc.exe -f .\Sprite\vs_spritemodel.sc -o .\shader\dx11\vs_spritemodel.bin  -
 shaderc.exe -f .\Sprite\fs_sprite.sc -o .\shader\dx11\fs_sprite.bin  -i .\ --varyingdef .\Sprite\varying.def.sc --platform windows -p ps_4_0 -O 3 --type fragment -O3
 shaderc.exe -f .\Sprite\fs_spritelight.sc -o .\shader\dx11\fs_spritelight.bin  -i .\ --varyingdef .\Sprite\varying.def.sc --platform windows -p ps_4_0 -O 3 --type fragment -O3
 shaderc.exe -f .\Sprite\fs_spritegray.sc -o .\shader\dx11\fs_spritegray.bin  -i .\ --varyingdef .\Sprite\varying.def.sc --platform windows -p ps_4_0 -O 3 --type fragment -O3
+shaderc.exe -f .\Sprite\vs_spritetwocolor.sc -o .\shader\dx11\vs_spritetwocolor.bin  -i .\ --varyingdef .\Sprite\varying.def.sc --platform windows -p vs_4_0 -O 3 --type vertex -O3
+shaderc.exe -f .\Sprite\vs_spriteskinned.sc -o .\shader\dx11\vs_spriteskinned.bin  -i .\ --varyingdef .\Sprite\varying.def.sc --platform windows -p vs_4_0 -O 3 --type vertex -O3
+shaderc.exe -f .\Sprite\fs_spritetwocolor.sc -o .\shader\dx11\fs_spritetwocolor.bin  -i .\ --varyingdef .\Sprite\varying.def.sc --platform windows -p ps_4_0 -O 3 --type fragment -O3
 shaderc.exe -f .\Sprite\fs_spritealphatest.sc -o .\shader\dx11\fs_spritealphatest.bin  -i .\ --varyingdef .\Sprite\varying.def.sc --platform windows -p ps_4_0 -O 3 --type fragment -O3
 shaderc.exe -f .\Label\vs_labelposition.sc -o .\shader\dx11\vs_labelposition.bin  -i .\ --varyingdef .\Label\varying.def.sc --platform windows -p vs_4_0 -O 3 --type vertex -O3
 shaderc.exe -f .\Label\vs_label.sc -o .\shader\dx11\vs_label.bin  -i .\ --varyingdef .\Label\varying.def.sc --platform windows -p vs_4_0 -O 3 --type vertex -O3
@@ -12,6 +12,9 @@ shaderc.exe -f .\Simple\vs_poscolor.sc -o .\shader\essl\vs_poscolor.bin  -i .\ -
 shaderc.exe -f .\Simple\fs_poscolor.sc -o .\shader\essl\fs_poscolor.bin  -i .\ --varyingdef .\Simple\varying.def.sc --platform ios -p 120 --type fragment -O3
 shaderc.exe -f .\Sprite\vs_spritemodel.sc -o .\shader\essl\vs_spritemodel.bin  -i .\ --varyingdef .\Sprite\varying.def.sc --platform ios -p 120 --type vertex -O3
 shaderc.exe -f .\Sprite\fs_spritegray.sc -o .\shader\essl\fs_spritegray.bin  -i .\ --varyingdef .\Sprite\varying.def.sc --platform ios -p 120 --type fragment -O3
+shaderc.exe -f .\Sprite\vs_spritetwocolor.sc -o .\shader\essl\vs_spritetwocolor.bin  -i .\ --varyingdef .\Sprite\varying.def.sc --platform ios -p 120 --type vertex -O3
+shaderc.exe -f .\Sprite\vs_spriteskinned.sc -o .\shader\essl\vs_spriteskinned.bin  -i .\ --varyingdef .\Sprite\varying.def.sc --platform ios -p 120 --type vertex -O3
+shaderc.exe -f .\Sprite\fs_spritetwocolor.sc -o .\shader\essl\fs_spritetwocolor.bin  -i .\ --varyingdef .\Sprite\varying.def.sc --platform ios -p 120 --type fragment -O3
 shaderc.exe -f .\Sprite\fs_spritealphatest.sc -o .\shader\essl\fs_spritealphatest.bin  -i .\ --varyingdef .\Sprite\varying.def.sc --platform ios -p 120 --type fragment -O3
 shaderc.exe -f .\Label\vs_labelposition.sc -o .\shader\essl\vs_labelposition.bin  -i .\ --varyingdef .\Label\varying.def.sc --platform ios -p 120 --type vertex -O3
 shaderc.exe -f .\Label\vs_label.sc -o .\shader\essl\vs_label.bin  -i .\ --varyingdef .\Label\varying.def.sc --platform ios -p 120 --type vertex -O3
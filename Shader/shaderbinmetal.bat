@@ -14,6 +14,9 @@ shaderc.exe -f .\Sprite\vs_sprite.sc -o .\shader\metal\vs_sprite.bin  -i .\ --va
 shaderc.exe -f .\Sprite\vs_spritemodel.sc -o .\shader\metal\vs_spritemodel.bin  -i .\ --varyingdef .\Sprite\varying.def.sc --platform ios -p metal --type vertex -O3
 shaderc.exe -f .\Sprite\fs_sprite.sc -o .\shader\metal\fs_sprite.bin  -i .\ --varyingdef .\Sprite\varying.def.sc --platform ios -p metal --type fragment -O3
 shaderc.exe -f .\Sprite\fs_spritegray.sc -o .\shader\metal\fs_spritegray.bin  -i .\ --varyingdef .\Sprite\varying.def.sc --platform ios -p metal --type fragment -O3
+shaderc.exe -f .\Sprite\vs_spritetwocolor.sc -o .\shader\metal\vs_spritetwocolor.bin  -i .\ --varyingdef .\Sprite\varying.def.sc --platform ios -p metal --type vertex -O3
+shaderc.exe -f .\Sprite\vs_spriteskinned.sc -o .\shader\metal\vs_spriteskinned.bin  -i .\ --varyingdef .\Sprite\varying.def.sc --platform ios -p metal --type vertex -O3
+shaderc.exe -f .\Sprite\fs_spritetwocolor.sc -o .\shader\metal\fs_spritetwocolor.bin  -i .\ --varyingdef .\Sprite\varying.def.sc --platform ios -p metal --type fragment -O3
 shaderc.exe -f .\Sprite\fs_spritealphatest.sc -o .\shader\metal\fs_spritealphatest.bin  -i .\ --varyingdef .\Sprite\varying.def.sc --platform ios -p metal --type fragment -O3
 shaderc.exe -f .\Label\vs_labelposition.sc -o .\shader\metal\vs_labelposition.bin  -i .\ --varyingdef .\Label\varying.def.sc --platform ios -p metal --type vertex -O3
 shaderc.exe -f .\Label\vs_label.sc -o .\shader\metal\vs_label.bin  -i .\ --varyingdef .\Label\varying.def.sc --platform ios -p metal --type vertex -O3
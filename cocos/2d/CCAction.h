@@ -181,7 +181,8 @@ protected:
 #endif
 private:
     CC_DISALLOW_COPY_AND_ASSIGN(Action);
-    COCOS_TYPE_OVERRIDE(Action);
+    COCOS_TYPE_OVERRIDE(Action, Ref);
+    COCOS_POOLED(Action);
 protected:
 	void sendUpdateEventToScript(float dt, Action *actionObject);
 };
@@ -233,7 +234,7 @@ protected:
     float _duration;
 private:
     CC_DISALLOW_COPY_AND_ASSIGN(FiniteTimeAction);
-    COCOS_TYPE_OVERRIDE(FiniteTimeAction);
+    COCOS_TYPE_OVERRIDE(FiniteTimeAction, Action);
 };
 
 class ActionInterval;
@@ -305,7 +306,7 @@ protected:
 
 private:
     CC_DISALLOW_COPY_AND_ASSIGN(Speed);
-    COCOS_TYPE_OVERRIDE(Speed);
+    COCOS_TYPE_OVERRIDE(Speed, Action);
 };
 
 /** @class Follow
@@ -447,7 +448,7 @@ protected:
 
 private:
     CC_DISALLOW_COPY_AND_ASSIGN(Follow);
-    COCOS_TYPE_OVERRIDE(Follow);
+    COCOS_TYPE_OVERRIDE(Follow, Action);
 };
 
 // end of actions group
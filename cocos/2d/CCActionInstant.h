@@ -69,7 +69,7 @@ public:
     virtual void update(float time) override;
 
 private:
-    COCOS_TYPE_OVERRIDE(ActionInstant);
+    COCOS_TYPE_OVERRIDE(ActionInstant, FiniteTimeAction);
 };
 
 /** @class Show
@@ -100,7 +100,7 @@ CC_CONSTRUCTOR_ACCESS:
 
 private:
     CC_DISALLOW_COPY_AND_ASSIGN(Show);
-    COCOS_TYPE_OVERRIDE(Show);
+    COCOS_TYPE_OVERRIDE(Show, ActionInstant);
 };
 
 /** @class Hide
@@ -131,7 +131,7 @@ CC_CONSTRUCTOR_ACCESS:
 
 private:
     CC_DISALLOW_COPY_AND_ASSIGN(Hide);
-    COCOS_TYPE_OVERRIDE(Hide);
+    COCOS_TYPE_OVERRIDE(Hide, ActionInstant);
 };
 
 /** @class ToggleVisibility
@@ -162,7 +162,7 @@ CC_CONSTRUCTOR_ACCESS:
 
 private:
     CC_DISALLOW_COPY_AND_ASSIGN(ToggleVisibility);
-    COCOS_TYPE_OVERRIDE(ToggleVisibility);
+    COCOS_TYPE_OVERRIDE(ToggleVisibility, ActionInstant);
 };
 
 /** @class RemoveSelf
@@ -200,7 +200,7 @@ protected:
 
 private:
     CC_DISALLOW_COPY_AND_ASSIGN(RemoveSelf);
-    COCOS_TYPE_OVERRIDE(RemoveSelf);
+    COCOS_TYPE_OVERRIDE(RemoveSelf, ActionInstant);
 };
 
 /** @class FlipX
@@ -239,7 +239,7 @@ protected:
 
 private:
     CC_DISALLOW_COPY_AND_ASSIGN(FlipX);
-    COCOS_TYPE_OVERRIDE(FlipX);
+    COCOS_TYPE_OVERRIDE(FlipX, ActionInstant);
 };
 
 /** @class FlipY
@@ -278,7 +278,7 @@ protected:
 
 private:
     CC_DISALLOW_COPY_AND_ASSIGN(FlipY);
-    COCOS_TYPE_OVERRIDE(FlipY);
+    COCOS_TYPE_OVERRIDE(FlipY, ActionInstant);
 };
 
 /** @class Place
@@ -317,7 +317,7 @@ protected:
 
 private:
     CC_DISALLOW_COPY_AND_ASSIGN(Place);
-    COCOS_TYPE_OVERRIDE(Place);
+    COCOS_TYPE_OVERRIDE(Place, ActionInstant);
 };
 
 
@@ -404,7 +404,7 @@ protected:
 
 private:
     CC_DISALLOW_COPY_AND_ASSIGN(CallFunc);
-    COCOS_TYPE_OVERRIDE(CallFunc);
+    COCOS_TYPE_OVERRIDE(CallFunc, ActionInstant);
 };
 
 /** @class CallFuncN
@@ -441,7 +441,7 @@ protected:
 
 private:
     CC_DISALLOW_COPY_AND_ASSIGN(CallFuncN);
-    COCOS_TYPE_OVERRIDE(CallFuncN);
+    COCOS_TYPE_OVERRIDE(CallFuncN, CallFunc);
 };
 
 // end of actions group
@@ -142,7 +142,7 @@ protected:
     bool _ignoreContentScaleFactor;
     /** Quad command. */
     SmartPtr<SpriteProgram> program_;
-    COCOS_TYPE_OVERRIDE(AtlasNode);
+    COCOS_TYPE_OVERRIDE(AtlasNode, Node);
 private:
     CC_DISALLOW_COPY_AND_ASSIGN(AtlasNode);
 
@@ -151,7 +151,7 @@ protected:
 
 private:
     CC_DISALLOW_COPY_AND_ASSIGN(ClippingNode);
-    COCOS_TYPE_OVERRIDE(ClippingNode);
+    COCOS_TYPE_OVERRIDE(ClippingNode, Node);
 };
 /** @} */
 NS_CC_END
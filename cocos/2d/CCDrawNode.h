@@ -316,7 +316,7 @@ protected:
     };
 private:
     CC_DISALLOW_COPY_AND_ASSIGN(DrawNode);
-    COCOS_TYPE_OVERRIDE(DrawNode);
+    COCOS_TYPE_OVERRIDE(DrawNode, Node);
 };
 /** @} */
 NS_CC_END
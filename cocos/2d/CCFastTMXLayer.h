@@ -343,7 +343,7 @@ protected:
     IndexBuffer* _indexBuffer;
 
     Map<int , Primitive*> _primitives;
-    COCOS_TYPE_OVERRIDE(TMXLayer);
+    COCOS_TYPE_OVERRIDE(TMXLayer, Node);
 public:
     /** Possible orientations of the TMX map */
     static const int FAST_TMX_ORIENTATION_ORTHO;
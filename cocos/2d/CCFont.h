@@ -44,7 +44,7 @@ public:
 
     virtual int getFontMaxHeight() const { return 0; }
 private:
-    COCOS_TYPE_OVERRIDE(Font);
+    COCOS_TYPE_OVERRIDE(Font, Ref);
 };
 
 NS_CC_END
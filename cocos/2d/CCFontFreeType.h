@@ -110,7 +110,7 @@ private:
 
     GlyphCollection _usedGlyphs;
     std::string _customGlyphs;
-    COCOS_TYPE_OVERRIDE(FontFreeType);
+    COCOS_TYPE_OVERRIDE(FontFreeType, Font);
 };
 
 /// @endcond
@@ -815,7 +815,7 @@ protected:
 
     SmartPtr<SpriteProgram> program_;
 
-    COCOS_TYPE_OVERRIDE(Label);
+    COCOS_TYPE_OVERRIDE(Label, Node);
 private:
     CC_DISALLOW_COPY_AND_ASSIGN(Label);
 };
@@ -75,7 +75,7 @@ CC_CONSTRUCTOR_ACCESS:
     virtual ~Layer();
 
     virtual bool init() override;
-    COCOS_TYPE_OVERRIDE(Layer);
+    COCOS_TYPE_OVERRIDE(Layer, Node);
 private:
     CC_DISALLOW_COPY_AND_ASSIGN(Layer);
 
@@ -172,7 +172,7 @@ protected:
     Color4F  _squareColors[4];
     SmartPtr<SpriteProgram> program_;
     Vec3 _noMVPVertices[4];
-    COCOS_TYPE_OVERRIDE(LayerColor);
+    COCOS_TYPE_OVERRIDE(LayerColor, Layer);
 private:
     CC_DISALLOW_COPY_AND_ASSIGN(LayerColor);
 
@@ -323,7 +323,7 @@ protected:
     GLubyte _endOpacity;
     Vec2   _alongVector;
     bool    _compressedInterpolation;
-    COCOS_TYPE_OVERRIDE(LayerGradient);
+    COCOS_TYPE_OVERRIDE(LayerGradient, LayerColor);
 };
 
 
@@ -438,7 +438,7 @@ CC_CONSTRUCTOR_ACCESS:
 protected:
     unsigned int _enabledLayer;
     Vector<Layer*>    _layers;
-    COCOS_TYPE_OVERRIDE(LayerMultiplex);
+    COCOS_TYPE_OVERRIDE(LayerMultiplex, Layer);
 private:
     CC_DISALLOW_COPY_AND_ASSIGN(LayerMultiplex);
 };
@@ -114,7 +114,7 @@ protected:
     bool            _enabled;
     // callback
     ccMenuCallback _callback;
-    COCOS_TYPE_OVERRIDE(MenuItem);
+    COCOS_TYPE_OVERRIDE(MenuItem, Node);
 private:
     CC_DISALLOW_COPY_AND_ASSIGN(MenuItem);
 };
@@ -185,7 +185,7 @@ protected:
     Color3B _disabledColor;
     /** Label that is rendered. It can be any Node that implements the LabelProtocol. */
     Node* _label;
-    COCOS_TYPE_OVERRIDE(MenuItemLabel);
+    COCOS_TYPE_OVERRIDE(MenuItemLabel, MenuItem);
 private:
     CC_DISALLOW_COPY_AND_ASSIGN(MenuItemLabel);
 };
@@ -216,7 +216,7 @@ CC_CONSTRUCTOR_ACCESS:
 
     /** Initializes a menu item from a string and atlas with a target/selector. */
     bool initWithString(const std::string& value, const std::string& charMapFile, int itemWidth, int itemHeight, char startCharMap, const ccMenuCallback& callback);
-    COCOS_TYPE_OVERRIDE(MenuItemAtlasFont);
+    COCOS_TYPE_OVERRIDE(MenuItemAtlasFont, MenuItemLabel);
 private:
     CC_DISALLOW_COPY_AND_ASSIGN(MenuItemAtlasFont);
 };
@@ -290,7 +290,7 @@ CC_CONSTRUCTOR_ACCESS:
 protected:
     int _fontSize;
     std::string _fontName;
-    COCOS_TYPE_OVERRIDE(MenuItemFont);
+    COCOS_TYPE_OVERRIDE(MenuItemFont, MenuItemLabel);
 private:
     CC_DISALLOW_COPY_AND_ASSIGN(MenuItemFont);
 };
@@ -365,7 +365,7 @@ protected:
     Node* _selectedImage;
     /** The image used when the item is disabled. */
     Node* _disabledImage;
-    COCOS_TYPE_OVERRIDE(MenuItemSprite);
+    COCOS_TYPE_OVERRIDE(MenuItemSprite, MenuItem);
 private:
     CC_DISALLOW_COPY_AND_ASSIGN(MenuItemSprite);
 };
@@ -417,7 +417,7 @@ CC_CONSTRUCTOR_ACCESS:
 
     /** Initializes a menu item with a normal, selected  and disabled image with a callable object. */
     bool initWithNormalImage(const std::string& normalImage, const std::string& selectedImage, const std::string& disabledImage, const ccMenuCallback& callback);
-    COCOS_TYPE_OVERRIDE(MenuItemImage);
+    COCOS_TYPE_OVERRIDE(MenuItemImage, MenuItemSprite);
 private:
     CC_DISALLOW_COPY_AND_ASSIGN(MenuItemImage);
 };
@@ -518,7 +518,7 @@ protected:
      @since v0.7.2
      */
     Vector<MenuItem*> _subItems;
-    COCOS_TYPE_OVERRIDE(MenuItemToggle);
+    COCOS_TYPE_OVERRIDE(MenuItemToggle, MenuItem);
 private:
     CC_DISALLOW_COPY_AND_ASSIGN(MenuItemToggle);
 
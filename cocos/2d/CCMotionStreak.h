@@ -207,7 +207,7 @@ protected:
     Tex2F* _texCoords;
 
     SmartPtr<SpriteProgram> program_;
-    COCOS_TYPE_OVERRIDE(MotionStreak);
+    COCOS_TYPE_OVERRIDE(MotionStreak, Node);
 private:
     CC_DISALLOW_COPY_AND_ASSIGN(MotionStreak);
 };
@@ -106,7 +106,7 @@ Node::Node()
 , _displayedColor(Color3B::WHITE)
 , _realColor(Color3B::WHITE)
 , _cameraMask(0)
-, flags_(Node::Visible | Node::TraverseEnabled)
+, flags_(Node::Visible | Node::TraverseEnabled | Node::Affine2D)
 {
     // set default scheduler and actionManager
     _director = &SharedDirector;
@@ -1113,6 +1113,7 @@ void Node::insertChild(Node* child, int32_t z)
     _reorderChildDirty = true;
     _children.pushBack(child);
     child->_setLocalZOrder(z);
+    child->flags_.setOn(Node::Reorder);
 }
 
 void Node::reorderChild(Node *child, int32_t zOrder)
@@ -1121,6 +1122,7 @@ void Node::reorderChild(Node *child, int32_t zOrder)
     _reorderChildDirty = true;
     child->updateOrderOfArrival();
     child->_setLocalZOrder(zOrder);
+    child->flags_.setOn(Node::Reorder);
 }
 
 void Node::sortAllChildren()
@@ -1259,7 +1261,14 @@ void Node::visit(IRenderer* renderer, const Mat4 &parentTransform, uint32_t pare
 
 Mat4 Node::transform(const Mat4& parentTransform)
 {
-    return parentTransform * this->getNodeToParentTransform();
+    const Mat4& transform = this->getNodeToParentTransform();
+    if (flags_.isOn(Node::Affine2D))
+    {
+        Mat4 ret;
+        Mat4::multiplyAffine2D(parentTransform, transform, &ret);
+        return ret;
+    }
+    return parentTransform * transform;
 }
 
 // MARK: events
@@ -1614,10 +1623,21 @@ AffineTransform Node::getNodeToParentAffineTransform() const
 Mat4 Node::getNodeToParentTransform(Node* ancestor) const
 {
     Mat4 t(this->getNodeToParentTransform());
+    bool affine2D = flags_.isOn(Node::Affine2D);
 
     for (Node *p = _parent;  p != nullptr && p != ancestor ; p = p->getParent())
     {
-        t = p->getNodeToParentTransform() * t;
+        const Mat4& parentTransform = p->getNodeToParentTransform();
+        if (affine2D)
+        {
+            // the product stays affine as long as every ancestor is
+            Mat4::multiplyAffine2D(parentTransform, t, &t);
+            affine2D = p->flags_.isOn(Node::Affine2D);
+        }
+        else
+        {
+            t = parentTransform * t;
+        }
     }
 
     return t;
@@ -1659,45 +1679,81 @@ const Mat4& Node::getNodeToParentTransform() const
             y += -anchorPoint.y;
         }
 
-        // Build Transform Matrix = translation * rotation * scale
-        Mat4 translation;
-        //move to anchor point first, then rotate
-        Mat4::createTranslation(x + anchorPoint.x, y + anchorPoint.y, z, &translation);
-
-        Mat4::createRotation(_rotationQuat, &_transform);
-
-        if (_rotationZ_X != _rotationZ_Y)
+        if (_rotationX == 0.0f && _rotationY == 0.0f)
         {
-            // Rotation values
-            // Change rotation code to handle X and Y
-            // If we skew with the exact same value for both x and y then we're simply just rotating
-            float radiansX = -CC_DEGREES_TO_RADIANS(_rotationZ_X);
-            float radiansY = -CC_DEGREES_TO_RADIANS(_rotationZ_Y);
-            float cx = cosf(radiansX);
-            float sx = sinf(radiansX);
-            float cy = cosf(radiansY);
-            float sy = sinf(radiansY);
-
-            float m0 = _transform.m[0], m1 = _transform.m[1], m4 = _transform.m[4], m5 = _transform.m[5], m8 = _transform.m[8], m9 = _transform.m[9];
-            _transform.m[0] = cy * m0 - sx * m1, _transform.m[4] = cy * m4 - sx * m5, _transform.m[8] = cy * m8 - sx * m9;
-            _transform.m[1] = sy * m0 + cx * m1, _transform.m[5] = sy * m4 + cx * m5, _transform.m[9] = sy * m8 + cx * m9;
-        }
-        _transform = translation * _transform;
-        //move by (-anchorPoint.x, -anchorPoint.y, 0) after rotation
-        _transform.translate(-anchorPoint.x, -anchorPoint.y, 0);
+            // Only rotated around z: the rotation is a 2x2 block, so the matrix is
+            // written directly instead of multiplying translation and rotation matrices.
+            float z2 = _rotationQuat.z + _rotationQuat.z;
+            float r0 = 1.0f - _rotationQuat.z * z2, r1 = _rotationQuat.w * z2;
+            float r4 = -r1, r5 = r0;
 
+            if (_rotationZ_X != _rotationZ_Y)
+            {
+                float radiansX = -CC_DEGREES_TO_RADIANS(_rotationZ_X);
+                float radiansY = -CC_DEGREES_TO_RADIANS(_rotationZ_Y);
+                float cx = cosf(radiansX);
+                float sx = sinf(radiansX);
+                float cy = cosf(radiansY);
+                float sy = sinf(radiansY);
+
+                float m0 = r0, m1 = r1, m4 = r4, m5 = r5;
+                r0 = cy * m0 - sx * m1, r4 = cy * m4 - sx * m5;
+                r1 = sy * m0 + cx * m1, r5 = sy * m4 + cx * m5;
+            }
 
-        if (_scaleX != 1.f)
-        {
-            _transform.m[0] *= _scaleX, _transform.m[1] *= _scaleX, _transform.m[2] *= _scaleX;
-        }
-        if (_scaleY != 1.f)
-        {
-            _transform.m[4] *= _scaleY, _transform.m[5] *= _scaleY, _transform.m[6] *= _scaleY;
+            // translation * rotation, moved by (-anchorPoint.x, -anchorPoint.y, 0) after rotation, then scaled
+            float* m = _transform.m;
+            m[0] = r0 * _scaleX, m[1] = r1 * _scaleX, m[2] = 0.0f, m[3] = 0.0f;
+            m[4] = r4 * _scaleY, m[5] = r5 * _scaleY, m[6] = 0.0f, m[7] = 0.0f;
+            m[8] = 0.0f, m[9] = 0.0f, m[10] = _scaleZ, m[11] = 0.0f;
+            m[12] = x + anchorPoint.x - r0 * anchorPoint.x - r4 * anchorPoint.y;
+            m[13] = y + anchorPoint.y - r1 * anchorPoint.x - r5 * anchorPoint.y;
+            m[14] = z, m[15] = 1.0f;
+            flags_.setOn(Node::Affine2D);
         }
-        if (_scaleZ != 1.f)
+        else
         {
-            _transform.m[8] *= _scaleZ, _transform.m[9] *= _scaleZ, _transform.m[10] *= _scaleZ;
+            // Build Transform Matrix = translation * rotation * scale
+            Mat4 translation;
+            //move to anchor point first, then rotate
+            Mat4::createTranslation(x + anchorPoint.x, y + anchorPoint.y, z, &translation);
+
+            Mat4::createRotation(_rotationQuat, &_transform);
+
+            if (_rotationZ_X != _rotationZ_Y)
+            {
+                // Rotation values
+                // Change rotation code to handle X and Y
+                // If we skew with the exact same value for both x and y then we're simply just rotating
+                float radiansX = -CC_DEGREES_TO_RADIANS(_rotationZ_X);
+                float radiansY = -CC_DEGREES_TO_RADIANS(_rotationZ_Y);
+                float cx = cosf(radiansX);
+                float sx = sinf(radiansX);
+                float cy = cosf(radiansY);
+                float sy = sinf(radiansY);
+
+                float m0 = _transform.m[0], m1 = _transform.m[1], m4 = _transform.m[4], m5 = _transform.m[5], m8 = _transform.m[8], m9 = _transform.m[9];
+                _transform.m[0] = cy * m0 - sx * m1, _transform.m[4] = cy * m4 - sx * m5, _transform.m[8] = cy * m8 - sx * m9;
+                _transform.m[1] = sy * m0 + cx * m1, _transform.m[5] = sy * m4 + cx * m5, _transform.m[9] = sy * m8 + cx * m9;
+            }
+            _transform = translation * _transform;
+            //move by (-anchorPoint.x, -anchorPoint.y, 0) after rotation
+            _transform.translate(-anchorPoint.x, -anchorPoint.y, 0);
+
+
+            if (_scaleX != 1.f)
+            {
+                _transform.m[0] *= _scaleX, _transform.m[1] *= _scaleX, _transform.m[2] *= _scaleX;
+            }
+            if (_scaleY != 1.f)
+            {
+                _transform.m[4] *= _scaleY, _transform.m[5] *= _scaleY, _transform.m[6] *= _scaleY;
+            }
+            if (_scaleZ != 1.f)
+            {
+                _transform.m[8] *= _scaleZ, _transform.m[9] *= _scaleZ, _transform.m[10] *= _scaleZ;
+            }
+            flags_.setOff(Node::Affine2D);
         }
 
         // FIXME:: Try to inline skew
@@ -1738,7 +1794,10 @@ const Mat4& Node::getNodeToParentTransform() const
             _additionalTransform[1] = _transform;
 
         if (flags_.isOn(Node::WorldDirty))
+        {
             _transform = _additionalTransform[1] * _additionalTransform[0];
+            flags_.setFlag(Node::Affine2D, _transform.isAffine2D());
+        }
     }
 
     flags_.setOff(Node::TransformDirty);
@@ -1750,6 +1809,7 @@ const Mat4& Node::getNodeToParentTransform() const
 void Node::setNodeToParentTransform(const Mat4& transform)
 {
     _transform = transform;
+    flags_.setFlag(Node::Affine2D, transform.isAffine2D());
     flags_.setOff(Node::TransformDirty);
     flags_.setOn(Node::WorldDirty);
 
@@ -1804,7 +1864,8 @@ const Mat4& Node::getParentToNodeTransform() const
 {
     if ( flags_.isOn(Node::TransformDirty) )
     {
-        _inverse = getNodeToParentTransform().getInversed();
+        const Mat4& transform = getNodeToParentTransform();
+        _inverse = flags_.isOn(Node::Affine2D) ? transform.getInversedAffine2D() : transform.getInversed();
         //_inverseDirty = false;
     }
 
@@ -1829,7 +1890,8 @@ AffineTransform Node::getWorldToNodeAffineTransform() const
 
 Mat4 Node::getWorldToNodeTransform() const
 {
-    return getNodeToWorldTransform().getInversed();
+    Mat4 t(getNodeToWorldTransform());
+    return t.isAffine2D() ? t.getInversedAffine2D() : t.getInversed();
 }
 
 
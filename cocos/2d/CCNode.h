@@ -30,6 +30,7 @@
 
 #include "base/CCVector.h"
 #include "math/CCAffineTransform.h"
+#include "base/FrameAllocator.h"
 
 NS_CC_BEGIN
 
@@ -835,16 +836,57 @@ public:
 
     /**
     * Sorts helper function
-    *
+    * Nodes added or reordered since the last sort are flagged with Node::Reorder. When they are few,
+    * they are pulled out, sorted apart and merged back by binary search among the others, which
+    * kept their order, instead of sorting the whole array again.
     */
     template<typename _T> inline
     static void sortNodes(cocos2d::Vector<_T*>& nodes)
     {
         static_assert(std::is_base_of<Node, _T>::value, "Node::sortNodes: Only accept derived of Node!");
-#if CC_64BITS
-        std::sort(std::begin(nodes), std::end(nodes), [](_T* n1, _T* n2) {
+        auto less = [](_T* n1, _T* n2) {
             return (n1->_localZOrderAndArrival < n2->_localZOrderAndArrival);
-        });
+        };
+        const size_t size = nodes.size();
+        auto first = std::begin(nodes);
+        _T** moved = SharedFrameAllocator.allocate<_T*>(size);
+        size_t movedCount = 0;
+        size_t kept = 0;
+        bool ordered = true;
+        for (size_t i = 0; i < size; i++)
+        {
+            _T* node = first[i];
+            if (node->flags_.isOn(Node::Reorder))
+            {
+                node->flags_.setOff(Node::Reorder);
+                moved[movedCount++] = node;
+            }
+            else
+            {
+                // sorted again without flagging the moved nodes, fall back to a full sort
+                ordered = ordered && (kept == 0 || !less(node, first[kept - 1]));
+                first[kept++] = node;
+            }
+        }
+        if (ordered && movedCount <= size / 4)
+        {
+            std::sort(moved, moved + movedCount, less);
+            // from the back, kept nodes above the moved one shift up to make its room
+            size_t write = size;
+            for (size_t i = movedCount; i > 0; i--)
+            {
+                _T* node = moved[i - 1];
+                auto place = std::upper_bound(first, first + kept, node, less);
+                std::move_backward(place, first + kept, first + write);
+                write -= (first + kept) - place;
+                kept = place - first;
+                first[--write] = node;
+            }
+            return;
+        }
+        std::copy(moved, moved + movedCount, first + kept);
+#if CC_64BITS
+        std::sort(std::begin(nodes), std::end(nodes), less);
 #else
         std::stable_sort(std::begin(nodes), std::end(nodes), [](_T* n1, _T* n2) {
             return n1->_localZOrder < n2->_localZOrder;
@@ -1869,7 +1911,7 @@ protected:
         Scheduling = 1 << 7,
         CascadeOpacity = 1 << 8, //PassOpacity
         CascadeColor = 1 << 9, //PassColor3
-        Reorder = 1 << 10,
+        Reorder = 1 << 10, // added or reordered since the parent last sorted its children
         Cleanup = 1 << 11,
         TouchEnabled = 1 << 12,
         SwallowTouches = 1 << 13,
@@ -1877,9 +1919,11 @@ protected:
         KeyboardEnabled = 1 << 15,
         TraverseEnabled = 1 << 16,
         RenderGrouped = 1 << 17,
-        UserFlag = 1 << 18
+        Affine2D = 1 << 18, // _transform stays in the xy plane, see Mat4::isAffine2D
+        UserFlag = 1 << 19
     };
-    COCOS_TYPE_OVERRIDE(Node);
+    COCOS_TYPE_OVERRIDE(Node, Ref);
+    COCOS_POOLED(Node);
 private:
     CC_DISALLOW_COPY_AND_ASSIGN(Node);
 };
@@ -105,7 +105,7 @@ protected:
 
 private:
     CC_DISALLOW_COPY_AND_ASSIGN(NodeGrid);
-    COCOS_TYPE_OVERRIDE(NodeGrid);
+    COCOS_TYPE_OVERRIDE(NodeGrid, Node);
 };
 /** @} */
 NS_CC_END
@@ -972,7 +972,7 @@ protected:
 
 private:
     CC_DISALLOW_COPY_AND_ASSIGN(ParticleSystem);
-    COCOS_TYPE_OVERRIDE(ParticleSystem);
+    COCOS_TYPE_OVERRIDE(ParticleSystem, Node);
 };
 
 // end of _2d group
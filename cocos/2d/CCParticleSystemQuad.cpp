@@ -318,6 +318,7 @@ void ParticleSystemQuad::updateParticleQuads()
     {
         Vec3 p1(currentPosition.x, currentPosition.y, 0);
         Mat4 worldToNodeTM = getWorldToNodeTransform();
+        const bool affine2D = worldToNodeTM.isAffine2D();
         worldToNodeTM.transformPoint(&p1);
         Vec3 p2;
         Vec2 newPos;
@@ -331,7 +332,10 @@ void ParticleSystemQuad::updateParticleQuads()
         for (int i = 0 ; i < _particleCount; ++i, ++startX, ++startY, ++x, ++y, ++quadStart, ++s, ++r)
         {
             p2.set(*startX, *startY, 0);
-            worldToNodeTM.transformPoint(&p2);
+            if (affine2D)
+                worldToNodeTM.transformPointAffine2D(p2, &p2);
+            else
+                worldToNodeTM.transformPoint(&p2);
             newPos.set(*x,*y);
             p2 = p1 - p2;
             newPos.x -= p2.x - pos.x;
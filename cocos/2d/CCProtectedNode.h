@@ -193,7 +193,7 @@ protected:
     Vector<Node*> _protectedChildren;        ///< array of children nodes
     bool _reorderProtectedChildDirty;
 
-    COCOS_TYPE_OVERRIDE(ProtectedNode);
+    COCOS_TYPE_OVERRIDE(ProtectedNode, Node);
 private:
     CC_DISALLOW_COPY_AND_ASSIGN(ProtectedNode);
 };
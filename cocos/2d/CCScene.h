@@ -91,7 +91,7 @@ protected:
     friend class ProtectedNode;
     friend class SpriteBatchNode;
 
-    COCOS_TYPE_OVERRIDE(Scene);
+    COCOS_TYPE_OVERRIDE(Scene, Node);
 private:
     CC_DISALLOW_COPY_AND_ASSIGN(Scene);
 };
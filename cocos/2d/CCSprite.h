@@ -615,7 +615,7 @@ protected:
     {
         OpacityModifyRGB = Node::UserFlag
     };
-    COCOS_TYPE_OVERRIDE(Sprite);
+    COCOS_TYPE_OVERRIDE(Sprite, Node);
 private:
     CC_DISALLOW_COPY_AND_ASSIGN(Sprite);
 };
@@ -357,6 +357,7 @@ protected:
     int _hexSideLength;
     /** properties from the layer. They can be added using Tiled */
     ValueMap _properties;
+    COCOS_TYPE_OVERRIDE(TMXLayer, Node);
 };
 
 // end of tilemap_parallax_nodes group
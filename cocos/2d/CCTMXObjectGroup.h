@@ -235,7 +235,7 @@ protected:
     ValueMap _properties;
     
     Vector<TMXObject*> _objects;
-    COCOS_TYPE_OVERRIDE(TMXObjectGroup);
+    COCOS_TYPE_OVERRIDE(TMXObjectGroup, Node);
 };
 
 // end of tilemap_parallax_nodes group
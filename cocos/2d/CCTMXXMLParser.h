@@ -114,7 +114,7 @@ public:
     bool                _ownTiles;
     Vec2               _offset;
 private:
-    COCOS_TYPE_OVERRIDE(TMXLayerInfo);
+    COCOS_TYPE_OVERRIDE(TMXLayerInfo, Ref);
 };
 
 class CC_DLL TMXObjectGroupInfo : public Ref
@@ -158,7 +158,7 @@ public:
     Color3B         _color;
     unsigned char   _opacity;
 protected:
-    COCOS_TYPE_OVERRIDE(TMXObjectGroupInfo);
+    COCOS_TYPE_OVERRIDE(TMXObjectGroupInfo, Ref);
 };
 
 /** @brief TMXTilesetInfo contains the information about the tilesets like:
@@ -304,7 +304,7 @@ protected:
     void makeStringSupportCursor(std::string& displayText);
     void updateCursorDisplayText();
     void setAttachWithIME(bool isAttachWithIME);
-    COCOS_TYPE_OVERRIDE(TextFieldTTF);
+    COCOS_TYPE_OVERRIDE(TextFieldTTF, Label);
 private:
     class LengthStack;
     LengthStack * _lens;
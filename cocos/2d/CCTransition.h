@@ -131,7 +131,7 @@ protected:
 
 private:
     CC_DISALLOW_COPY_AND_ASSIGN(TransitionScene);
-    COCOS_TYPE_OVERRIDE(TransitionScene);
+    COCOS_TYPE_OVERRIDE(TransitionScene, Scene);
 };
 
 /** @class TransitionSceneOriented
@@ -86,6 +86,7 @@ cocos2d.cpp \
 2d/CCTweenFunction.cpp \
 2d/CCAutoPolygon.cpp \
 platform/CCFileUtils.cpp \
+platform/CCResourcePack.cpp \
 platform/CCGLView.cpp \
 platform/CCImage.cpp \
 platform/CCSAXParser.cpp \
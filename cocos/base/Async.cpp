@@ -1,5 +1,6 @@
 #include "ccHeader.h"
 #include "Async.h"
+#include <thread>
 #include "base/CCDirector.h"
 #include "base/CCScheduler.h"
 
@@ -7,6 +8,10 @@ NS_CC_BEGIN
 
 Async::Async()
     :scheduled_(false)
+    ,paused_(false)
+    ,pauseRequested_(false)
+    ,stopping_(false)
+    ,generation_(0)
 {
 
 }
@@ -24,51 +29,86 @@ void Async::stop()
 {
     if (thread_.isRunning())
     {
-        workerEvent_.post("Stop"_slice);
+        paused_ = false;
+        // the jobs waiting for room in the channel are handed over as the worker makes room
+        flush();
+        while (!pending_.empty())
+        {
+            workerSemaphore_.post();
+            std::this_thread::yield();
+            flush();
+        }
+        stopping_ = true;
         workerSemaphore_.post();
         thread_.shutdown();
+        stopping_ = false;
+        workerChannel_.clear();
+        // the finishers free what their workers allocated
+        finishAll();
     }
     scheduled_ = false;
 }
 
-void Async::run(std::function<SmartPtr<TValues>()> worker, std::function<void(TValues*)> finisher)
+void Async::scheduleFinisher()
 {
-    if (!thread_.isRunning())
-    {
-        thread_.init(Async::work, this);
-    }
     if (!scheduled_)
     {
         scheduled_ = true;
         SharedDirector.getScheduler()->schedule([this](float deltaTime) -> bool
         {
-            for (Own<QEvent> event = finisherEvent_.poll();
-                event != nullptr;
-                event = finisherEvent_.poll())
+            finishAll();
+            if (!pending_.empty())
             {
-                Package* package;
-                SmartPtr<TValues> result;
-                event->get(package, result);
-                package->second(result);
-                delete package;
+                flush();
+                workerSemaphore_.post();
             }
             return false;
         });
     }
-    auto package = new Package(worker, finisher);
-    workerEvent_.post("WorkDone"_slice, package);
-    workerSemaphore_.post();
 }
 
-void Async::run(std::function<void()> workder)
+void Async::finishAll()
 {
-    if (!thread_.isRunning())
+    finisherChannel_.pollAll([](AsyncChannel::Message& message)
     {
-        thread_.init(Async::work, this);
+        message.get<AsyncTask>().finish();
+    });
+    std::deque<Own<AsyncTask>> overflow;
+    {
+        std::lock_guard<std::mutex> lock(overflowMutex_);
+        overflow.swap(overflow_);
+    }
+    for (auto& task : overflow)
+    {
+        task->finish();
+    }
+}
+
+void Async::flush()
+{
+    while (!pending_.empty() && pending_.front()->moveTo(workerChannel_, Work))
+    {
+        pending_.pop_front();
+    }
+}
+
+void Async::process(AsyncTask& task)
+{
+    if (task.generation_ != generation_.load(std::memory_order_acquire))
+    {
+        return;
+    }
+    task.work();
+    if (!task.hasFinisher())
+    {
+        return;
+    }
+    // never wait for the cocos thread to make room, it may be blocked in pause()
+    std::lock_guard<std::mutex> lock(overflowMutex_);
+    if (!overflow_.empty() || !task.moveTo(finisherChannel_, Finish))
+    {
+        overflow_.push_back(task.moveToHeap());
     }
-    auto work = new std::function<void()>(workder);
-    workerEvent_.post("Work"_slice, work);
-    workerSemaphore_.post();
 }
 
 int Async::work(bx::Thread* thread, void* userData)
@@ -76,35 +116,20 @@ int Async::work(bx::Thread* thread, void* userData)
     Async* worker = reinterpret_cast<Async*>(userData);
     while (true)
     {
-        for (Own<QEvent> event = worker->workerEvent_.poll();
-            event != nullptr;
-            event = worker->workerEvent_.poll())
-        {
-            switch (Switch::hash(event->getName()))
+        const bool stopping = worker->stopping_.load(std::memory_order_acquire);
+        while (!worker->paused_.load(std::memory_order_acquire) &&
+            worker->workerChannel_.poll([worker](AsyncChannel::Message& message)
             {
-            case "Work"_hash:
-            {
-                std::function<void()>* worker;
-                event->get(worker);
-                (*worker)();
-                delete worker;
-                break;
-            }
-            case "WorkDone"_hash:
-            {
-                Package* package;
-                event->get(package);
-                SmartPtr<TValues> result = package->first();
-                worker->finisherEvent_.post(Slice::Empty, package, result);
-                break;
-            }
-            case "Stop"_hash:
-            {
-                return 0;
-            }
-            }
+                worker->process(message.get<AsyncTask>());
+            }));
+        if (worker->pauseRequested_.exchange(false))
+        {
+            worker->pauseSemaphore_.post();
+        }
+        if (stopping)
+        {
+            return 0;
         }
-        worker->pauseSemaphore_.post();
         worker->workerSemaphore_.wait();
     }
     return 0;
@@ -114,28 +139,8 @@ void Async::pause()
 {
     if (thread_.isRunning())
     {
-        for (Own<QEvent> event = workerEvent_.poll();
-            event != nullptr;
-            event = workerEvent_.poll())
-        {
-            switch (Switch::hash(event->getName()))
-            {
-            case "Work"_hash:
-            {
-                std::function<void()>* worker;
-                event->get(worker);
-                workers_.push_back(worker);
-                break;
-            }
-            case "WorkDone"_hash:
-            {
-                Package* package;
-                event->get(package);
-                packages_.push_back(package);
-                break;
-            }
-            }
-        }
+        paused_ = true;
+        pauseRequested_ = true;
         workerSemaphore_.post();
         pauseSemaphore_.wait();
     }
@@ -143,56 +148,17 @@ void Async::pause()
 
 void Async::resume()
 {
-    if (thread_.isRunning() && !packages_.empty())
+    if (thread_.isRunning())
     {
-        for (Package* package : packages_)
-        {
-            workerEvent_.post("WorkDone"_slice, package);
-        }
-        for (std::function<void()>* worker : workers_)
-        {
-            workerEvent_.post("Work"_slice, worker);
-        }
-        packages_.clear();
-        workers_.clear();
+        paused_ = false;
         workerSemaphore_.post();
     }
 }
 
 void Async::cancel()
 {
-    for (Own<QEvent> event = workerEvent_.poll();
-        event != nullptr;
-        event = workerEvent_.poll())
-    {
-        switch (Switch::hash(event->getName()))
-        {
-        case "Work"_hash:
-        {
-            std::function<void()>* worker;
-            event->get(worker);
-            delete worker;
-            break;
-        }
-        case "WorkDone"_hash:
-        {
-            Package* package;
-            event->get(package);
-            delete package;
-            break;
-        }
-        }
-    }
-    for (Package* package : packages_)
-    {
-        delete package;
-    }
-    packages_.clear();
-    for (std::function<void()>* worker : workers_)
-    {
-        delete worker;
-    }
-    workers_.clear();
+    generation_++;
+    pending_.clear();
 }
 
 void AsyncThread::stop()
@@ -1,32 +1,162 @@
 #pragma once
 
-#include "EventQueue.h"
+#include <mutex>
+#include "Channel.h"
 #include "Value.h"
 
 NS_CC_BEGIN
 
+class Async;
+typedef SpScChannel<128, 192> AsyncChannel;
+
+/** @brief A job of Async, moved through its channels by value. */
+class AsyncTask
+{
+public:
+    AsyncTask(uint32_t generation) :generation_(generation) {}
+    virtual ~AsyncTask() {}
+    virtual void work() = 0;
+    virtual void finish() = 0;
+    virtual bool hasFinisher() const = 0;
+    /** Moves the task into the channel, false when it is full. */
+    virtual bool moveTo(AsyncChannel& channel, uint32_t tag) = 0;
+    /** Moves the task to the heap, for the results waiting for room in the finisher channel. */
+    virtual Own<AsyncTask> moveToHeap() = 0;
+private:
+    uint32_t generation_;
+    friend class Async;
+};
+
+template<typename Worker, typename Finisher>
+class AsyncTaskT : public AsyncTask
+{
+public:
+    template<typename W, typename F>
+    AsyncTaskT(uint32_t generation, W&& worker, F&& finisher)
+        :AsyncTask(generation)
+        ,worker_(std::forward<W>(worker))
+        ,finisher_(std::forward<F>(finisher))
+        ,result_()
+    {}
+    virtual void work() override { result_ = worker_(); }
+    virtual void finish() override { finisher_(result_); }
+    virtual bool hasFinisher() const override { return true; }
+    virtual bool moveTo(AsyncChannel& channel, uint32_t tag) override
+    {
+        return channel.tryPost<AsyncTask, AsyncTaskT>(tag, std::move(*this));
+    }
+    virtual Own<AsyncTask> moveToHeap() override
+    {
+        return Own<AsyncTask>(new AsyncTaskT(std::move(*this)));
+    }
+private:
+    Worker worker_;
+    Finisher finisher_;
+    typename std::decay<decltype(std::declval<Worker&>()())>::type result_;
+};
+
+template<typename Worker>
+class AsyncWorkT : public AsyncTask
+{
+public:
+    template<typename W>
+    AsyncWorkT(uint32_t generation, W&& worker)
+        :AsyncTask(generation)
+        ,worker_(std::forward<W>(worker))
+    {}
+    virtual void work() override { worker_(); }
+    virtual void finish() override {}
+    virtual bool hasFinisher() const override { return false; }
+    virtual bool moveTo(AsyncChannel& channel, uint32_t tag) override
+    {
+        return channel.tryPost<AsyncTask, AsyncWorkT>(tag, std::move(*this));
+    }
+    virtual Own<AsyncTask> moveToHeap() override
+    {
+        return Own<AsyncTask>(new AsyncWorkT(std::move(*this)));
+    }
+private:
+    Worker worker_;
+};
+
+/** @brief Runs jobs on its own thread. The worker's result is handed to the finisher
+ on the cocos thread, typed, without going through TValues.
+ Jobs are posted by the cocos thread and wait in a local queue while the worker channel is full,
+ results wait in a locked overflow queue while the finisher channel is full.
+ */
 class Async
 {
-    using Package = std::pair<std::function<SmartPtr<TValues>()>, std::function<void(TValues*)>>;
 public:
     Async();
     virtual ~Async();
-    void run(std::function<SmartPtr<TValues>()> worker, std::function<void(TValues*)> finisher);
-    void run(std::function<void()> workder);
+
+    /** Runs worker() on the thread then finisher(result) on the cocos thread. */
+    template<typename Worker, typename Finisher>
+    void run(Worker&& worker, Finisher&& finisher)
+    {
+        scheduleFinisher();
+        post<AsyncTaskT<typename std::decay<Worker>::type, typename std::decay<Finisher>::type>>(
+            std::forward<Worker>(worker), std::forward<Finisher>(finisher));
+    }
+
+    template<typename Worker>
+    void run(Worker&& worker)
+    {
+        post<AsyncWorkT<typename std::decay<Worker>::type>>(std::forward<Worker>(worker));
+    }
+
     void pause();
     void resume();
+    /** Drops the jobs not started yet. */
     void cancel();
+    /** Runs the jobs already posted then stops the thread, the finishers of their results run too. */
     void stop();
     static int work(bx::Thread* thread, void* userData);
 private:
+    enum MessageTag : uint32_t
+    {
+        Work = 1,
+        Finish
+    };
+
+    template<typename Task, typename... Args>
+    void post(Args&&... args)
+    {
+        if (!thread_.isRunning())
+        {
+            thread_.init(Async::work, this);
+        }
+        flush();
+        const uint32_t generation = generation_.load(std::memory_order_relaxed);
+        // tryPost leaves args untouched when it fails
+        if (!pending_.empty() ||
+            !workerChannel_.tryPost<AsyncTask, Task>(Work, generation, std::forward<Args>(args)...))
+        {
+            pending_.emplace_back(new Task(generation, std::forward<Args>(args)...));
+            scheduleFinisher();
+        }
+        workerSemaphore_.post();
+    }
+
+    void scheduleFinisher();
+    void flush();
+    void process(AsyncTask& task);
+    void finishAll();
+
     bool scheduled_;
+    std::atomic<bool> paused_;
+    std::atomic<bool> pauseRequested_;
+    std::atomic<bool> stopping_;
+    std::atomic<uint32_t> generation_;
     bx::Thread thread_;
     bx::Semaphore workerSemaphore_;
     bx::Semaphore pauseSemaphore_;
-    std::vector<std::function<void()>*> workers_;
-    std::vector<Package*> packages_;
-    EventQueue workerEvent_;
-    EventQueue finisherEvent_;
+    std::deque<Own<AsyncTask>> pending_;
+    AsyncChannel workerChannel_;
+    AsyncChannel finisherChannel_;
+    /** Results the finisher channel had no room for, newer than the ones in the channel. */
+    std::deque<Own<AsyncTask>> overflow_;
+    std::mutex overflowMutex_;
 };
 
 class AsyncThread
@@ -71,6 +71,12 @@ void AutoreleasePool::clear()
     {
         obj->release();
     }
+    // give the capacity back so autoreleasing does not regrow the array every frame
+    if (_managedObjectArray.empty())
+    {
+        releasings.clear();
+        releasings.swap(_managedObjectArray);
+    }
 #if defined(COCOS2D_DEBUG) && (COCOS2D_DEBUG > 0)
     _isClearing = false;
 #endif
@@ -51,11 +51,13 @@ THE SOFTWARE.
 #include "base/CCAsyncTaskPool.h"
 #include "platform/CCApplication.h"
 #include "spine/SkeletonBatch.h"
+#include "spine/SkeletonCache.h"
 #include "renderer/Renderer.h"
 
 #include "base/Camera.h"
 #include "base/View.h"
 #include "base/Async.h"
+#include "base/FrameAllocator.h"
 
 #if CC_ENABLE_SCRIPT_BINDING
 #include "base/CCScriptSupport.h"
@@ -872,6 +874,7 @@ void Director::reset()
     FileUtils::destroyInstance();
     AsyncTaskPool::destroyInstance();
     spine::SkeletonBatch::destroyInstance();
+    spine::SkeletonCacheManager::destroyInstance();
     SharedAsyncThread.stop();
     
     // cocos2d-x specific data structures
@@ -1146,6 +1149,8 @@ void Director::mainLoop()
 
         // release the objects
         PoolManager::getInstance()->getCurrentPool()->clear();
+
+        SharedFrameAllocator.endFrame();
     }
 }
 
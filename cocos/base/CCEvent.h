@@ -95,7 +95,8 @@ protected:
     Node* _currentTarget;  ///< Current target
 
     friend class EventDispatcher;
-    COCOS_TYPE_OVERRIDE(Event);
+    COCOS_TYPE_OVERRIDE(Event, Ref);
+    COCOS_POOLED(Event);
 };
 
 NS_CC_END
@@ -50,7 +50,7 @@ private:
     virtual ~EventAcceleration() {}
     Acceleration _acc;
     friend class EventListenerAcceleration;
-    COCOS_TYPE_OVERRIDE(EventAcceleration);
+    COCOS_TYPE_OVERRIDE(EventAcceleration, Event);
 };
 
 NS_CC_END
@@ -69,7 +69,7 @@ protected:
 
     void* _userData;       ///< User data
     std::string _eventName;
-    COCOS_TYPE_OVERRIDE(EventCustom);
+    COCOS_TYPE_OVERRIDE(EventCustom, Event);
 };
 
 NS_CC_END
@@ -206,7 +206,7 @@ protected:
 
     /** Sets the dirty flag for a node. */
     void setDirtyForNode(Node* node);
-    COCOS_TYPE_OVERRIDE(EventDispatcher);
+    COCOS_TYPE_OVERRIDE(EventDispatcher, Ref);
 
     /**
      *  The vector to store event listeners with scene graph based priority and fixed priority.
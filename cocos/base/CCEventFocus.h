@@ -60,7 +60,7 @@ private:
     ui::Widget *_widgetLoseFocus;
 
     friend class EventListenerFocus;
-    COCOS_TYPE_OVERRIDE(EventFocus);
+    COCOS_TYPE_OVERRIDE(EventFocus, Event);
 };
 
 
@@ -236,7 +236,7 @@ private:
 
     friend class EventListenerKeyboard;
 
-    COCOS_TYPE_OVERRIDE(EventKeyboard);
+    COCOS_TYPE_OVERRIDE(EventKeyboard, Event);
 };
 
 NS_CC_END
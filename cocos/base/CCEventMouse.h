@@ -188,7 +188,7 @@ private:
     Vec2 _prevPoint;
 
     friend class EventListenerMouse;
-    COCOS_TYPE_OVERRIDE(EventMouse);
+    COCOS_TYPE_OVERRIDE(EventMouse, Event);
 };
 
 NS_CC_END
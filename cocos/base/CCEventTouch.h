@@ -95,7 +95,7 @@ private:
     std::vector<Touch*> _touches;
 
     friend class GLView;
-    COCOS_TYPE_OVERRIDE(EventTouch);
+    COCOS_TYPE_OVERRIDE(EventTouch, Event);
 };
 
 
@@ -46,6 +46,16 @@ Weak::Weak(Ref* t)
 
 }
 
+void* Weak::operator new(size_t size)
+{
+    return RefPool::allocate(size);
+}
+
+void Weak::operator delete(void* p, size_t size)
+{
+    RefPool::deallocate(p, size);
+}
+
 void Weak::retain()
 {
     ++weakRefCount_;
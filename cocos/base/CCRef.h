@@ -64,6 +64,10 @@ namespace cocos2d {
         void retain();
         void release();
         Ref* target;
+
+        // taken from RefPool, weak references come and go with the Refs
+        static void* operator new(size_t size);
+        static void operator delete(void* p, size_t size);
     private:
         uint32_t weakRefCount_;
     };
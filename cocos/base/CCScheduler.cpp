@@ -82,7 +82,7 @@ protected:
         :func(func)
         ,entry(nullptr)
     {}
-    COCOS_TYPE_OVERRIDE(FuncWrapper);
+    COCOS_TYPE_OVERRIDE(FuncWrapper, Ref);
 };
 
 // implementation Timer
@@ -278,6 +278,7 @@ Scheduler::Scheduler(void)
 #if CC_ENABLE_SCRIPT_BINDING
 , _scriptHandlerEntries(20)
 #endif
+, _functionsToPerformRemovedCount(0)
 {
     // I don't expect to have more than 30 functions to all per frame
     _functionsToPerform.reserve(30);
@@ -860,6 +861,13 @@ void Scheduler::removeAllFunctionsToBePerformedInCocosThread()
     functionWrappers_.clear();
     std::unique_lock<std::mutex> lock(_performMutex);
     _functionsToPerform.clear();
+    ++_functionsToPerformRemovedCount;
+}
+
+unsigned int Scheduler::getFunctionsToPerformRemovedCount()
+{
+    std::unique_lock<std::mutex> lock(_performMutex);
+    return _functionsToPerformRemovedCount;
 }
 
 // main loop
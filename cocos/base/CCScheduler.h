@@ -70,7 +70,7 @@ protected:
     unsigned int _repeat; //0 = once, 1 is 2 x executed
     float _delay;
     float _interval;
-    COCOS_TYPE_OVERRIDE(Timer);
+    COCOS_TYPE_OVERRIDE(Timer, Ref);
 };
 
 
@@ -90,7 +90,7 @@ public:
 protected:
     Ref* _target;
     SEL_SCHEDULE _selector;
-    COCOS_TYPE_OVERRIDE(TimerTargetSelector);
+    COCOS_TYPE_OVERRIDE(TimerTargetSelector, Timer);
 };
 
 
@@ -112,7 +112,7 @@ protected:
     void* _target;
     ccSchedulerFunc _callback;
     std::string _key;
-    COCOS_TYPE_OVERRIDE(TimerTargetCallback);
+    COCOS_TYPE_OVERRIDE(TimerTargetCallback, Timer);
 };
 
 #if CC_ENABLE_SCRIPT_BINDING
@@ -438,6 +438,14 @@ public:
      * @js NA
      */
     void removeAllFunctionsToBePerformedInCocosThread();
+
+    /**
+     * How many times the pending functions were removed, a caller which performs a function only once
+     * until it runs can tell that it will never run
+     * This function is thread safe
+     * @js NA
+     */
+    unsigned int getFunctionsToPerformRemovedCount();
     
     bool isCurrentTargetSalvaged () const { return _currentTargetSalvaged; };
 
@@ -483,6 +491,8 @@ protected:
     std::vector<SmartPtr<Ref>> functionWrappers_;
     // Used for "perform Function"
     std::vector<std::function<void()>> _functionsToPerform;
+    // guarded by _performMutex
+    unsigned int _functionsToPerformRemovedCount;
     std::mutex _performMutex;
 };
 
@@ -170,6 +170,7 @@ private:
     Vec2 _prevPoint;
     float _curForce;
     float _maxForce;
+    COCOS_POOLED(Touch);
 };
 
 // end of base group
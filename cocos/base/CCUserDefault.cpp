@@ -24,120 +24,492 @@ THE SOFTWARE.
 ****************************************************************************/
 #include "ccHeader.h"
 #include "base/CCUserDefault.h"
+#include "base/Async.h"
 #include "platform/CCCommon.h"
 #include "platform/CCFileUtils.h"
 #include "tinyxml2/tinyxml2.h"
 #include "base/base64.h"
 #include "base/ccUtils.h"
+#include <atomic>
+#include <mutex>
+#include <unordered_map>
 
 #if (CC_TARGET_PLATFORM != CC_PLATFORM_IOS && CC_TARGET_PLATFORM != CC_PLATFORM_MAC && CC_TARGET_PLATFORM != CC_PLATFORM_ANDROID)
 
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_WIN32)
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
 // root name of xml
 #define USERDEFAULT_ROOT_NAME    "userDefaultRoot"
 
 #define XML_FILE_NAME "UserDefault.xml"
 
+#define JOURNAL_FILE_NAME "UserDefault.journal"
+
 using namespace std;
 
 NS_CC_BEGIN
 
 /**
- * define the functions here because we don't want to
- * export xmlNodePtr and other types in "CCUserDefault.h"
+ * The values live in a hash map loaded once, every change is appended as a record to a journal
+ * that the FileIO thread writes and syncs in batches. When the dead records outweigh the live
+ * ones the journal is rewritten from the map. An existing UserDefault.xml is migrated on first load.
+ *
+ * Journal layout: "CCUD", then records of
+ * [uint8 op][uint32 key size][key] and for a set [uint32 value size][value], in host byte order.
  */
 
-static tinyxml2::XMLElement* getXMLNodeForKey(const char* pKey, tinyxml2::XMLElement** rootNode, tinyxml2::XMLDocument **doc)
+namespace {
+
+const char JOURNAL_MAGIC[4] = { 'C', 'C', 'U', 'D' };
+// Journals smaller than this are never compacted.
+const size_t JOURNAL_COMPACT_SIZE = 64 * 1024;
+
+enum JournalOp : unsigned char
 {
-    tinyxml2::XMLElement* curNode = nullptr;
+    JournalSet = 1,
+    JournalDelete = 2
+};
 
-    // check the key value
-    if (! pKey)
+size_t appendRecord(std::string& buffer, JournalOp op, const std::string& key, const std::string& value)
+{
+    size_t start = buffer.size();
+    uint32_t keySize = static_cast<uint32_t>(key.size());
+    buffer.push_back(static_cast<char>(op));
+    buffer.append(reinterpret_cast<const char*>(&keySize), sizeof(keySize));
+    buffer.append(key);
+    if (op == JournalSet)
+    {
+        uint32_t valueSize = static_cast<uint32_t>(value.size());
+        buffer.append(reinterpret_cast<const char*>(&valueSize), sizeof(valueSize));
+        buffer.append(value);
+    }
+    return buffer.size() - start;
+}
+
+size_t recordSize(const std::string& key, const std::string& value)
+{
+    return 1 + sizeof(uint32_t) * 2 + key.size() + value.size();
+}
+
+bool syncFile(FILE* fp)
+{
+    if (fflush(fp) != 0)
     {
-        return nullptr;
+        return false;
     }
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_WIN32)
+    return _commit(_fileno(fp)) == 0;
+#else
+    return fsync(fileno(fp)) == 0;
+#endif
+}
 
-    do
+/**
+ * The part shared with the FileIO thread: records waiting to be written and the journal file.
+ * Writes take everything pending at once, so records reach the file in the order they were made.
+ */
+class UserDefaultJournal
+{
+public:
+    explicit UserDefaultJournal(const std::string& path)
+        : _path(path)
+        , _compact(false)
+        , _scheduled(false)
+        , _failed(false)
+    {}
+
+    void append(const std::string& records)
+    {
+        std::lock_guard<std::mutex> lock(_pendingMutex);
+        _pending += records;
+    }
+
+    /** Replaces the journal with a snapshot of every live value on the next write. */
+    void replace(std::string&& snapshot)
     {
-         tinyxml2::XMLDocument* xmlDoc = new (std::nothrow) tinyxml2::XMLDocument();
-        *doc = xmlDoc;
+        std::lock_guard<std::mutex> lock(_pendingMutex);
+        _pending = std::move(snapshot);
+        _compact = true;
+    }
 
-        std::string xmlBuffer = FileUtils::getInstance()->getStringFromFile(UserDefault::getInstance()->getXMLFilePath());
+    /** Removes path once a rewrite of the journal succeeded, the values it held are in the journal then. */
+    void removeAfterRewrite(const std::string& path)
+    {
+        std::lock_guard<std::mutex> lock(_pendingMutex);
+        _obsoletePath = path;
+    }
 
-        if (xmlBuffer.empty())
+    /** Queues one write on the FileIO thread, further records join it until it runs. */
+    static void schedule(const std::shared_ptr<UserDefaultJournal>& journal)
+    {
+        if (!journal->_scheduled.exchange(true))
         {
-            CCLOG("can not read xml file");
-            break;
+            std::shared_ptr<UserDefaultJournal> holder = journal;
+            SharedAsyncThread.FileIO.run([holder]()
+            {
+                holder->write();
+            });
         }
-        xmlDoc->Parse(xmlBuffer.c_str(), xmlBuffer.size());
+    }
+
+    /** Set when a write failed, the journal may end in a partial record and has to be rewritten. */
+    bool failed() const
+    {
+        return _failed;
+    }
 
-        // get root node
-        *rootNode = xmlDoc->RootElement();
-        if (nullptr == *rootNode)
+    void write()
+    {
+        std::lock_guard<std::mutex> fileLock(_fileMutex);
+        _scheduled = false;
+
+        std::string records;
+        std::string obsoletePath;
+        bool compact;
         {
-            CCLOG("read root node error");
-            break;
+            std::lock_guard<std::mutex> lock(_pendingMutex);
+            records.swap(_pending);
+            compact = _compact;
+            _compact = false;
+            if (compact)
+            {
+                obsoletePath.swap(_obsoletePath);
+            }
         }
-        // find the node
-        curNode = (*rootNode)->FirstChildElement();
-        while (nullptr != curNode)
+        if (records.empty() && !compact)
         {
-            const char* nodeName = curNode->Value();
-            if (!strcmp(nodeName, pKey))
+            return;
+        }
+
+        auto fileUtils = FileUtils::getInstance();
+        bool ok = false;
+        if (compact)
+        {
+            // Written aside and renamed over the journal, a crash leaves one of the two intact.
+            std::string tmpPath = _path + ".tmp";
+            FILE* fp = fopen(fileUtils->getSuitableFOpen(tmpPath).c_str(), "wb");
+            if (fp)
             {
-                break;
+                ok = fwrite(JOURNAL_MAGIC, 1, sizeof(JOURNAL_MAGIC), fp) == sizeof(JOURNAL_MAGIC)
+                    && fwrite(records.data(), 1, records.size(), fp) == records.size()
+                    && syncFile(fp);
+                fclose(fp);
+            }
+            ok = ok && fileUtils->renameFile(tmpPath, _path);
+            if (ok)
+            {
+                _failed = false;
+                if (!obsoletePath.empty() && fileUtils->isFileExist(obsoletePath))
+                {
+                    fileUtils->removeFile(obsoletePath);
+                }
+            }
+        }
+        else
+        {
+            FILE* fp = fopen(fileUtils->getSuitableFOpen(_path).c_str(), "ab");
+            if (fp)
+            {
+                ok = fwrite(records.data(), 1, records.size(), fp) == records.size() && syncFile(fp);
+                fclose(fp);
             }
-
-            curNode = curNode->NextSiblingElement();
         }
-    } while (0);
 
-    return curNode;
-}
+        if (!ok)
+        {
+            CCLOG("UserDefault: can not write %s", _path.c_str());
+            _failed = true;
+            if (!obsoletePath.empty())
+            {
+                // Kept until the rewrite that follows a failure succeeds.
+                std::lock_guard<std::mutex> lock(_pendingMutex);
+                if (_obsoletePath.empty())
+                {
+                    _obsoletePath.swap(obsoletePath);
+                }
+            }
+        }
+    }
 
-static void setValueForKey(const char* pKey, const char* pValue)
+private:
+    std::string _path;
+    std::mutex _fileMutex;
+    std::mutex _pendingMutex;
+    std::string _pending;
+    std::string _obsoletePath;
+    bool _compact;
+    std::atomic<bool> _scheduled;
+    std::atomic<bool> _failed;
+};
+
+/** Main thread state of UserDefault, created on first use. */
+class UserDefaultStore
 {
-     tinyxml2::XMLElement* rootNode;
-    tinyxml2::XMLDocument* doc;
-    tinyxml2::XMLElement* node;
-    // check the params
-    if (! pKey || ! pValue)
+public:
+    UserDefaultStore(const std::string& journalPath, const std::string& xmlPath)
+        : _journal(std::make_shared<UserDefaultJournal>(journalPath))
+        , _journalSize(0)
+        , _liveSize(0)
+    {
+        auto fileUtils = FileUtils::getInstance();
+        bool clean = false;
+        if (!load(journalPath, clean))
+        {
+            // A leftover of an interrupted rewrite, or the values of the old xml file.
+            bool ignored;
+            if (!load(journalPath + ".tmp", ignored) && fileUtils->isFileExist(xmlPath))
+            {
+                migrateXML(xmlPath);
+            }
+        }
+        if (!clean)
+        {
+            // Rewritten by the first write, before anything is appended, a damaged tail is dropped there.
+            _journal->replace(snapshot());
+            _journal->removeAfterRewrite(xmlPath);
+            UserDefaultJournal::schedule(_journal);
+        }
+    }
+
+    ~UserDefaultStore()
     {
-        return;
+        flush();
     }
-    // find the node
-    node = getXMLNodeForKey(pKey, &rootNode, &doc);
-    // if node exist, change the content
-    if (node)
+
+    const std::string* find(const char* key) const
     {
-        if (node->FirstChild())
+        auto it = _values.find(key);
+        return it != _values.end() ? &it->second : nullptr;
+    }
+
+    void set(const char* key, const std::string& value)
+    {
+        auto it = _values.find(key);
+        if (it == _values.end())
         {
-            node->FirstChild()->SetValue(pValue);
+            it = _values.emplace(key, value).first;
+        }
+        else if (it->second == value)
+        {
+            return;
         }
         else
         {
-            tinyxml2::XMLText* content = doc->NewText(pValue);
-            node->LinkEndChild(content);
+            _liveSize -= recordSize(it->first, it->second);
+            it->second = value;
         }
+        _liveSize += recordSize(it->first, value);
+        _journalSize += appendRecord(_records, JournalSet, it->first, value);
     }
-    else
+
+    void remove(const char* key)
+    {
+        auto it = _values.find(key);
+        if (it == _values.end())
+        {
+            return;
+        }
+        _liveSize -= recordSize(it->first, it->second);
+        _journalSize += appendRecord(_records, JournalDelete, it->first, std::string());
+        _values.erase(it);
+    }
+
+    /** Hands the records made since the last call to the journal and queues a write. */
+    void commit()
+    {
+        if (handOff())
+        {
+            UserDefaultJournal::schedule(_journal);
+        }
+    }
+
+    /** Writes everything not written yet on this thread, after whatever the FileIO thread is holding. */
+    void flush()
     {
-        if (rootNode)
+        handOff();
+        _journal->write();
+    }
+
+private:
+    bool handOff()
+    {
+        if (_records.empty() && !_journal->failed())
+        {
+            return false;
+        }
+        if (_journal->failed() || (_journalSize > JOURNAL_COMPACT_SIZE && _journalSize > _liveSize * 2))
+        {
+            _journal->replace(snapshot());
+        }
+        else
         {
-            tinyxml2::XMLElement* tmpNode = doc->NewElement(pKey);//new tinyxml2::XMLElement(pKey);
-            rootNode->LinkEndChild(tmpNode);
-            tinyxml2::XMLText* content = doc->NewText(pValue);//new tinyxml2::XMLText(pValue);
-            tmpNode->LinkEndChild(content);
+            _journal->append(_records);
+            _records.clear();
         }
+        return true;
     }
 
-    // save file and free doc
-    if (doc)
+    std::string snapshot()
     {
-        doc->SaveFile(FileUtils::getInstance()->getSuitableFOpen(UserDefault::getInstance()->getXMLFilePath()).c_str());
-        delete doc;
+        std::string buffer;
+        buffer.reserve(_liveSize);
+        for (const auto& pair : _values)
+        {
+            appendRecord(buffer, JournalSet, pair.first, pair.second);
+        }
+        _journalSize = sizeof(JOURNAL_MAGIC) + buffer.size();
+        _records.clear();
+        return buffer;
     }
+
+    /** Replays a journal, returns false when there is none. clean is false when it ends in a damaged record. */
+    bool load(const std::string& path, bool& clean)
+    {
+        clean = false;
+        auto fileUtils = FileUtils::getInstance();
+        if (!fileUtils->isFileExist(path))
+        {
+            return false;
+        }
+        Data data = fileUtils->getDataFromFile(path);
+        const char* cursor = reinterpret_cast<const char*>(data.getBytes());
+        const char* end = cursor + data.getSize();
+        if (data.getSize() < sizeof(JOURNAL_MAGIC) || memcmp(cursor, JOURNAL_MAGIC, sizeof(JOURNAL_MAGIC)) != 0)
+        {
+            return false;
+        }
+        cursor += sizeof(JOURNAL_MAGIC);
+
+        auto readString = [&cursor, end](std::string& out) -> bool
+        {
+            uint32_t size;
+            if (static_cast<size_t>(end - cursor) < sizeof(size))
+            {
+                return false;
+            }
+            memcpy(&size, cursor, sizeof(size));
+            cursor += sizeof(size);
+            if (static_cast<size_t>(end - cursor) < size)
+            {
+                return false;
+            }
+            out.assign(cursor, size);
+            cursor += size;
+            return true;
+        };
+
+        std::string key, value;
+        while (cursor < end)
+        {
+            JournalOp op = static_cast<JournalOp>(*cursor++);
+            if ((op != JournalSet && op != JournalDelete) || !readString(key))
+            {
+                return true;
+            }
+            if (op == JournalSet)
+            {
+                if (!readString(value))
+                {
+                    return true;
+                }
+                auto it = _values.find(key);
+                if (it != _values.end())
+                {
+                    _liveSize -= recordSize(it->first, it->second);
+                    it->second = value;
+                }
+                else
+                {
+                    _values.emplace(key, value);
+                }
+                _liveSize += recordSize(key, value);
+            }
+            else
+            {
+                auto it = _values.find(key);
+                if (it != _values.end())
+                {
+                    _liveSize -= recordSize(it->first, it->second);
+                    _values.erase(it);
+                }
+            }
+        }
+        _journalSize = data.getSize();
+        clean = true;
+        return true;
+    }
+
+    void migrateXML(const std::string& path)
+    {
+        std::string xmlBuffer = FileUtils::getInstance()->getStringFromFile(path);
+        if (xmlBuffer.empty())
+        {
+            CCLOG("can not read xml file");
+            return;
+        }
+        tinyxml2::XMLDocument doc;
+        doc.Parse(xmlBuffer.c_str(), xmlBuffer.size());
+        tinyxml2::XMLElement* rootNode = doc.RootElement();
+        if (nullptr == rootNode)
+        {
+            CCLOG("read root node error");
+            return;
+        }
+        for (tinyxml2::XMLElement* node = rootNode->FirstChildElement();
+            node != nullptr;
+            node = node->NextSiblingElement())
+        {
+            const char* value = node->GetText();
+            _values[node->Value()] = value ? value : "";
+        }
+        _liveSize = 0;
+        for (const auto& pair : _values)
+        {
+            _liveSize += recordSize(pair.first, pair.second);
+        }
+    }
+
+    std::shared_ptr<UserDefaultJournal> _journal;
+    std::unordered_map<std::string, std::string> _values;
+    std::string _records;
+    size_t _journalSize;
+    size_t _liveSize;
+};
+
+UserDefaultStore* s_store = nullptr;
+
+UserDefaultStore* getStore()
+{
+    if (!s_store)
+    {
+        std::string writablePath = FileUtils::getInstance()->getWritablePath();
+        s_store = new UserDefaultStore(writablePath + JOURNAL_FILE_NAME, writablePath + XML_FILE_NAME);
+    }
+    return s_store;
+}
+
+const std::string* getValueForKey(const char* pKey)
+{
+    return pKey ? getStore()->find(pKey) : nullptr;
+}
+
+void setValueForKey(const char* pKey, const std::string& value)
+{
+    if (!pKey)
+    {
+        return;
+    }
+    UserDefaultStore* store = getStore();
+    store->set(pKey, value);
+    store->commit();
 }
 
+} // namespace
+
 /**
  * implements of UserDefault
  */
@@ -161,27 +533,8 @@ bool UserDefault::getBoolForKey(const char* pKey)
 
 bool UserDefault::getBoolForKey(const char* pKey, bool defaultValue)
 {
-    const char* value = nullptr;
-    tinyxml2::XMLElement* rootNode;
-    tinyxml2::XMLDocument* doc;
-    tinyxml2::XMLElement* node;
-    node =  getXMLNodeForKey(pKey, &rootNode, &doc);
-    // find the node
-    if (node && node->FirstChild())
-    {
-        value = (const char*)(node->FirstChild()->Value());
-    }
-
-    bool ret = defaultValue;
-
-    if (value)
-    {
-        ret = (! strcmp(value, "true"));
-    }
-
-    if (doc) delete doc;
-
-    return ret;
+    const std::string* value = getValueForKey(pKey);
+    return value ? *value == "true" : defaultValue;
 }
 
 int UserDefault::getIntegerForKey(const char* pKey)
@@ -191,31 +544,8 @@ int UserDefault::getIntegerForKey(const char* pKey)
 
 int UserDefault::getIntegerForKey(const char* pKey, int defaultValue)
 {
-    const char* value = nullptr;
-    tinyxml2::XMLElement* rootNode;
-    tinyxml2::XMLDocument* doc;
-    tinyxml2::XMLElement* node;
-    node =  getXMLNodeForKey(pKey, &rootNode, &doc);
-    // find the node
-    if (node && node->FirstChild())
-    {
-        value = (const char*)(node->FirstChild()->Value());
-    }
-
-    int ret = defaultValue;
-
-    if (value)
-    {
-        ret = atoi(value);
-    }
-
-    if(doc)
-    {
-        delete doc;
-    }
-
-
-    return ret;
+    const std::string* value = getValueForKey(pKey);
+    return value ? atoi(value->c_str()) : defaultValue;
 }
 
 float UserDefault::getFloatForKey(const char* pKey)
@@ -237,27 +567,8 @@ double  UserDefault::getDoubleForKey(const char* pKey)
 
 double UserDefault::getDoubleForKey(const char* pKey, double defaultValue)
 {
-    const char* value = nullptr;
-    tinyxml2::XMLElement* rootNode;
-    tinyxml2::XMLDocument* doc;
-    tinyxml2::XMLElement* node;
-    node =  getXMLNodeForKey(pKey, &rootNode, &doc);
-    // find the node
-    if (node && node->FirstChild())
-    {
-        value = (const char*)(node->FirstChild()->Value());
-    }
-
-    double ret = defaultValue;
-
-    if (value)
-    {
-        ret = utils::atof(value);
-    }
-
-    if (doc) delete doc;
-
-    return ret;
+    const std::string* value = getValueForKey(pKey);
+    return value ? utils::atof(value->c_str()) : defaultValue;
 }
 
 std::string UserDefault::getStringForKey(const char* pKey)
@@ -267,27 +578,8 @@ std::string UserDefault::getStringForKey(const char* pKey)
 
 string UserDefault::getStringForKey(const char* pKey, const std::string & defaultValue)
 {
-    const char* value = nullptr;
-    tinyxml2::XMLElement* rootNode;
-    tinyxml2::XMLDocument* doc;
-    tinyxml2::XMLElement* node;
-    node =  getXMLNodeForKey(pKey, &rootNode, &doc);
-    // find the node
-    if (node && node->FirstChild())
-    {
-        value = (const char*)(node->FirstChild()->Value());
-    }
-
-    string ret = defaultValue;
-
-    if (value)
-    {
-        ret = string(value);
-    }
-
-    if (doc) delete doc;
-
-    return ret;
+    const std::string* value = getValueForKey(pKey);
+    return value ? *value : defaultValue;
 }
 
 Data UserDefault::getDataForKey(const char* pKey)
@@ -297,31 +589,20 @@ Data UserDefault::getDataForKey(const char* pKey)
 
 Data UserDefault::getDataForKey(const char* pKey, const Data& defaultValue)
 {
-    const char* encodedData = nullptr;
-    tinyxml2::XMLElement* rootNode;
-    tinyxml2::XMLDocument* doc;
-    tinyxml2::XMLElement* node;
-    node =  getXMLNodeForKey(pKey, &rootNode, &doc);
-    // find the node
-    if (node && node->FirstChild())
-    {
-        encodedData = (const char*)(node->FirstChild()->Value());
-    }
+    const std::string* encodedData = getValueForKey(pKey);
 
     Data ret = defaultValue;
 
     if (encodedData)
     {
         unsigned char * decodedData = nullptr;
-        int decodedDataLen = base64Decode((unsigned char*)encodedData, (unsigned int)strlen(encodedData), &decodedData);
+        int decodedDataLen = base64Decode((unsigned char*)encodedData->c_str(), (unsigned int)encodedData->size(), &decodedData);
 
         if (decodedData) {
             ret.fastSet(decodedData, decodedDataLen);
         }
     }
 
-    if (doc) delete doc;
-
     return ret;
 }
 
@@ -385,7 +666,7 @@ void UserDefault::setStringForKey(const char* pKey, const std::string & value)
         return;
     }
 
-    setValueForKey(pKey, value.c_str());
+    setValueForKey(pKey, value);
 }
 
 void UserDefault::setDataForKey(const char* pKey, const Data& value) {
@@ -399,10 +680,11 @@ void UserDefault::setDataForKey(const char* pKey, const Data& value) {
 
     base64Encode(value.getBytes(), static_cast<unsigned int>(value.getSize()), &encodedData);
 
-    setValueForKey(pKey, encodedData);
-
     if (encodedData)
+    {
+        setValueForKey(pKey, encodedData);
         free(encodedData);
+    }
 }
 
 UserDefault* UserDefault::getInstance()
@@ -410,13 +692,7 @@ UserDefault* UserDefault::getInstance()
     if (!_userDefault)
     {
         initXMLFilePath();
-
-        // only create xml file one time
-        // the file exists after the program exit
-        if ((!isXMLFileExist()) && (!createXMLFile()))
-        {
-            return nullptr;
-        }
+        getStore();
 
         _userDefault = new (std::nothrow) UserDefault();
     }
@@ -427,6 +703,7 @@ UserDefault* UserDefault::getInstance()
 void UserDefault::destroyInstance()
 {
     CC_SAFE_DELETE(_userDefault);
+    CC_SAFE_DELETE(s_store);
 }
 
 void UserDefault::setDelegate(UserDefault *delegate)
@@ -451,35 +728,10 @@ void UserDefault::initXMLFilePath()
     }
 }
 
-// create new xml file
+// the values are kept in the journal, the xml file is only read for migration
 bool UserDefault::createXMLFile()
 {
-    bool bRet = false;
-    tinyxml2::XMLDocument *pDoc = new (std::nothrow) tinyxml2::XMLDocument();
-    if (nullptr==pDoc)
-    {
-        return false;
-    }
-    tinyxml2::XMLDeclaration *pDeclaration = pDoc->NewDeclaration(nullptr);
-    if (nullptr==pDeclaration)
-    {
-        return false;
-    }
-    pDoc->LinkEndChild(pDeclaration);
-    tinyxml2::XMLElement *pRootEle = pDoc->NewElement(USERDEFAULT_ROOT_NAME);
-    if (nullptr==pRootEle)
-    {
-        return false;
-    }
-    pDoc->LinkEndChild(pRootEle);
-    bRet = tinyxml2::XML_SUCCESS == pDoc->SaveFile(FileUtils::getInstance()->getSuitableFOpen(_filePath).c_str());
-
-    if(pDoc)
-    {
-        delete pDoc;
-    }
-
-    return bRet;
+    return true;
 }
 
 const string& UserDefault::getXMLFilePath()
@@ -487,16 +739,17 @@ const string& UserDefault::getXMLFilePath()
     return _filePath;
 }
 
+// Setters already queue their write on the FileIO thread, this waits for it.
 void UserDefault::flush()
 {
+    if (s_store)
+    {
+        s_store->flush();
+    }
 }
 
 void UserDefault::deleteValueForKey(const char* key)
 {
-    tinyxml2::XMLElement* rootNode;
-    tinyxml2::XMLDocument* doc;
-    tinyxml2::XMLElement* node;
-
     // check the params
     if (!key)
     {
@@ -504,24 +757,9 @@ void UserDefault::deleteValueForKey(const char* key)
         return;
     }
 
-    // find the node
-    node = getXMLNodeForKey(key, &rootNode, &doc);
-
-    // if node not exist, don't need to delete
-    if (!node)
-    {
-        return;
-    }
-
-    // save file and free doc
-    if (doc)
-    {
-        doc->DeleteNode(node);
-        doc->SaveFile(FileUtils::getInstance()->getSuitableFOpen(UserDefault::getInstance()->getXMLFilePath()).c_str());
-        delete doc;
-    }
-
-    flush();
+    UserDefaultStore* store = getStore();
+    store->remove(key);
+    store->commit();
 }
 
 NS_CC_END
@@ -19,7 +19,7 @@ protected:
     Vec3 target_;
     Vec3 up_;
     Mat4 view_;
-    COCOS_TYPE_OVERRIDE(Camera);
+    COCOS_TYPE_OVERRIDE(Camera, Ref);
 };
 
 class BasicCamera : public Camera
@@ -37,7 +37,7 @@ protected:
 private:
     bool transformDirty_;
     float rotation_;
-    COCOS_TYPE_OVERRIDE(BasicCamera);
+    COCOS_TYPE_OVERRIDE(BasicCamera, Camera);
 };
 
 class Camera2D : public Camera
@@ -56,7 +56,7 @@ private:
     bool transformDirty_;
     float rotation_;
     float zoom_;
-    COCOS_TYPE_OVERRIDE(Camera2D);
+    COCOS_TYPE_OVERRIDE(Camera2D, Camera);
 };
 
 NS_CC_END
\ No newline at end of file
@@ -0,0 +1,378 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include "base/ccMacros.h"
+
+NS_CC_BEGIN
+
+/** @brief Bounded lock-free channels passing typed messages between threads.
+ Messages are an integer tag and a payload constructed in place in the ring slot,
+ so posting and polling allocate nothing unless the payload is larger than the slot.
+ @example Communicate between threads.
+ enum { Resize = 1, Quit };
+ SpScChannel<64> _channel;
+
+ // producer thread, false when the channel is full
+ _channel.tryPost<Size>(Resize, Size(800, 600));
+
+ // consumer thread
+ while (_channel.poll([](SpScChannel<64>::Message& message)
+ {
+    switch (message.getTag())
+    {
+    case Resize:
+        Log("%f", message.get<Size>().width);
+        break;
+    }
+ }));
+ */
+
+template<typename T>
+struct QMessageType
+{
+    // not const, identical constants may be folded into one
+    static char token;
+};
+
+template<typename T>
+char QMessageType<T>::token = 0;
+
+template<std::size_t PayloadSize>
+class QMessage
+{
+public:
+    inline uint32_t getTag() const { return tag_; }
+
+    template<typename T>
+    inline bool is() const
+    {
+        return type_ == &QMessageType<T>::token;
+    }
+
+    template<typename T>
+    inline T& get()
+    {
+        CCAssertIf(!is<T>(), "message payload is not of the requested type.");
+        return *static_cast<T*>(object_);
+    }
+
+    /** Payloads larger than the slot are allocated on the heap instead. */
+    template<typename T>
+    static constexpr bool isInline()
+    {
+        return sizeof(T) <= PayloadSize && alignof(T) <= alignof(std::max_align_t);
+    }
+private:
+    template<uint32_t, std::size_t> friend class SpScChannel;
+    template<uint32_t, std::size_t> friend class MpScChannel;
+
+    inline void emplace(uint32_t tag)
+    {
+        tag_ = tag;
+        type_ = nullptr;
+        object_ = nullptr;
+        destroy_ = nullptr;
+    }
+
+    // Impl is the type constructed, T the one consumers get() it as, either Impl or one of its bases
+    template<typename T, typename Impl, typename... Args>
+    inline void emplace(uint32_t tag, Args&&... args)
+    {
+        static_assert(std::is_base_of<T, Impl>::value || std::is_same<T, Impl>::value, "payload must be a T.");
+        Impl* impl = construct<Impl>(std::integral_constant<bool, isInline<Impl>()>(), std::forward<Args>(args)...);
+        tag_ = tag;
+        type_ = &QMessageType<T>::token;
+        object_ = static_cast<T*>(impl);
+        impl_ = impl;
+        destroy_ = &QMessage::destroy<Impl>;
+    }
+
+    template<typename Impl, typename... Args>
+    inline Impl* construct(std::true_type, Args&&... args)
+    {
+        return new (&payload_) Impl(std::forward<Args>(args)...);
+    }
+
+    template<typename Impl, typename... Args>
+    inline Impl* construct(std::false_type, Args&&... args)
+    {
+        return new Impl(std::forward<Args>(args)...);
+    }
+
+    template<typename Impl>
+    static void destroy(void* impl)
+    {
+        destroy<Impl>(std::integral_constant<bool, isInline<Impl>()>(), impl);
+    }
+
+    template<typename Impl>
+    static void destroy(std::true_type, void* impl)
+    {
+        static_cast<Impl*>(impl)->~Impl();
+    }
+
+    template<typename Impl>
+    static void destroy(std::false_type, void* impl)
+    {
+        delete static_cast<Impl*>(impl);
+    }
+
+    inline void destroy()
+    {
+        if (destroy_)
+        {
+            destroy_(impl_);
+            destroy_ = nullptr;
+        }
+    }
+
+    uint32_t tag_;
+    const char* type_;
+    void* object_;
+    void* impl_;
+    void (*destroy_)(void*);
+    typename std::aligned_storage<PayloadSize, alignof(std::max_align_t)>::type payload_;
+};
+
+/** @brief Channel with one producer and one consumer thread, both sides are wait-free. */
+template<uint32_t Capacity, std::size_t PayloadSize = 64>
+class SpScChannel
+{
+    static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0, "channel capacity must be a power of two.");
+public:
+    typedef QMessage<PayloadSize> Message;
+
+    SpScChannel()
+        :tail_(0)
+        ,cachedHead_(0)
+        ,head_(0)
+        ,cachedTail_(0)
+    {}
+
+    ~SpScChannel()
+    {
+        clear();
+    }
+
+    /** Producer side, returns false and leaves args untouched when the channel is full. */
+    template<typename T, typename Impl = T, typename... Args>
+    bool tryPost(uint32_t tag, Args&&... args)
+    {
+        Message* message = reserve();
+        if (!message)
+        {
+            return false;
+        }
+        message->template emplace<T, Impl>(tag, std::forward<Args>(args)...);
+        tail_.store(tail_.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool tryPost(uint32_t tag)
+    {
+        Message* message = reserve();
+        if (!message)
+        {
+            return false;
+        }
+        message->emplace(tag);
+        tail_.store(tail_.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+        return true;
+    }
+
+    /** Consumer side, calls handler(Message&) with the oldest message then destroys it. */
+    template<typename Handler>
+    bool poll(Handler&& handler)
+    {
+        const uint32_t head = head_.load(std::memory_order_relaxed);
+        if (head == cachedTail_)
+        {
+            cachedTail_ = tail_.load(std::memory_order_acquire);
+            if (head == cachedTail_)
+            {
+                return false;
+            }
+        }
+        Message& message = slots_[head & (Capacity - 1)];
+        handler(message);
+        message.destroy();
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    template<typename Handler>
+    uint32_t pollAll(Handler&& handler)
+    {
+        uint32_t count = 0;
+        while (poll(handler))
+        {
+            count++;
+        }
+        return count;
+    }
+
+    /** Consumer side, drops the pending messages. */
+    void clear()
+    {
+        while (poll([](Message&) {}));
+    }
+
+    bool empty() const
+    {
+        return head_.load(std::memory_order_acquire) == tail_.load(std::memory_order_acquire);
+    }
+private:
+    inline Message* reserve()
+    {
+        const uint32_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail - cachedHead_ == Capacity)
+        {
+            cachedHead_ = head_.load(std::memory_order_acquire);
+            if (tail - cachedHead_ == Capacity)
+            {
+                return nullptr;
+            }
+        }
+        return &slots_[tail & (Capacity - 1)];
+    }
+
+    // producer and consumer indices on separate cache lines
+    std::atomic<uint32_t> tail_;
+    uint32_t cachedHead_;
+    char producerPadding_[64 - sizeof(uint32_t) * 2];
+    std::atomic<uint32_t> head_;
+    uint32_t cachedTail_;
+    char consumerPadding_[64 - sizeof(uint32_t) * 2];
+    Message slots_[Capacity];
+};
+
+/** @brief Channel with any number of producer threads and one consumer thread. */
+template<uint32_t Capacity, std::size_t PayloadSize = 64>
+class MpScChannel
+{
+    static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0, "channel capacity must be a power of two.");
+public:
+    typedef QMessage<PayloadSize> Message;
+
+    MpScChannel()
+        :tail_(0)
+        ,head_(0)
+    {
+        for (uint32_t i = 0; i < Capacity; i++)
+        {
+            slots_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    ~MpScChannel()
+    {
+        clear();
+    }
+
+    /** Producer side, returns false and leaves args untouched when the channel is full. */
+    template<typename T, typename Impl = T, typename... Args>
+    bool tryPost(uint32_t tag, Args&&... args)
+    {
+        uint32_t position;
+        Slot* slot = reserve(position);
+        if (!slot)
+        {
+            return false;
+        }
+        slot->message.template emplace<T, Impl>(tag, std::forward<Args>(args)...);
+        slot->sequence.store(position + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool tryPost(uint32_t tag)
+    {
+        uint32_t position;
+        Slot* slot = reserve(position);
+        if (!slot)
+        {
+            return false;
+        }
+        slot->message.emplace(tag);
+        slot->sequence.store(position + 1, std::memory_order_release);
+        return true;
+    }
+
+    /** Consumer side, calls handler(Message&) with the oldest message then destroys it. */
+    template<typename Handler>
+    bool poll(Handler&& handler)
+    {
+        Slot& slot = slots_[head_ & (Capacity - 1)];
+        if (slot.sequence.load(std::memory_order_acquire) != head_ + 1)
+        {
+            return false;
+        }
+        handler(slot.message);
+        slot.message.destroy();
+        slot.sequence.store(head_ + Capacity, std::memory_order_release);
+        head_++;
+        return true;
+    }
+
+    template<typename Handler>
+    uint32_t pollAll(Handler&& handler)
+    {
+        uint32_t count = 0;
+        while (poll(handler))
+        {
+            count++;
+        }
+        return count;
+    }
+
+    /** Consumer side, drops the pending messages. */
+    void clear()
+    {
+        while (poll([](Message&) {}));
+    }
+private:
+    struct Slot
+    {
+        std::atomic<uint32_t> sequence;
+        Message message;
+    };
+
+    // A slot is free for the producer at position when its sequence equals position,
+    // and readable by the consumer once the producer stores position + 1.
+    inline Slot* reserve(uint32_t& position)
+    {
+        position = tail_.load(std::memory_order_relaxed);
+        while (true)
+        {
+            Slot& slot = slots_[position & (Capacity - 1)];
+            const int32_t diff = static_cast<int32_t>(slot.sequence.load(std::memory_order_acquire) - position);
+            if (diff == 0)
+            {
+                if (tail_.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                {
+                    return &slot;
+                }
+            }
+            else if (diff < 0)
+            {
+                return nullptr;
+            }
+            else
+            {
+                position = tail_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    std::atomic<uint32_t> tail_;
+    char producerPadding_[64 - sizeof(uint32_t)];
+    uint32_t head_;
+    char consumerPadding_[64 - sizeof(uint32_t)];
+    Slot slots_[Capacity];
+};
+
+NS_CC_END
@@ -73,7 +73,7 @@ public:
         ,arguments(std::make_tuple(args...))
     {}
     std::tuple<Fields...> arguments;
-    COCOS_TYPE_OVERRIDE(QEventArgs<Fields...>);
+    COCOS_TYPE_OVERRIDE(QEventArgs<Fields...>, QEvent);
 };
 
 template<typename... Args>
@@ -0,0 +1,140 @@
+#include "ccHeader.h"
+#include "FrameAllocator.h"
+#include <atomic>
+
+NS_CC_BEGIN
+
+namespace
+{
+    // set by the first ended frame, from then on only the thread ending frames allocates outside a Scope
+    std::atomic<bool> s_framesStarted(false);
+}
+
+FrameArena::FrameArena()
+    :chunks_(nullptr)
+    ,cursor_(nullptr)
+    ,end_(nullptr)
+    ,used_(0)
+    ,capacity_(0)
+    ,mallocs_(0)
+{
+
+}
+
+FrameArena::~FrameArena()
+{
+    freeChunks();
+}
+
+void FrameArena::pushChunk(size_t size)
+{
+    Chunk* chunk = static_cast<Chunk*>(malloc(sizeof(Chunk) + size));
+    CCAssertIf(!chunk, "out of memory for the frame arena.");
+    chunk->next = chunks_;
+    chunk->size = size;
+    chunks_ = chunk;
+    cursor_ = reinterpret_cast<char*>(chunk + 1);
+    end_ = cursor_ + size;
+    capacity_ += size;
+    mallocs_++;
+}
+
+void FrameArena::freeChunks()
+{
+    while (chunks_)
+    {
+        Chunk* next = chunks_->next;
+        free(chunks_);
+        chunks_ = next;
+    }
+    cursor_ = nullptr;
+    end_ = nullptr;
+    capacity_ = 0;
+}
+
+void* FrameArena::allocateChunk(size_t size, size_t alignment)
+{
+    // grow geometrically so a frame needs few chunks before the next reset merges them
+    const size_t chunkSize = DEFAULT_CHUNK_SIZE;
+    pushChunk(std::max(std::max(capacity_, chunkSize), size + alignment));
+    char* memory = align(cursor_, alignment);
+    used_ += (memory + size) - cursor_;
+    cursor_ = memory + size;
+    return memory;
+}
+
+void FrameArena::reset()
+{
+    if (chunks_ && chunks_->next)
+    {
+        size_t capacity = capacity_;
+        freeChunks();
+        pushChunk(capacity);
+    }
+    else if (chunks_)
+    {
+        cursor_ = reinterpret_cast<char*>(chunks_ + 1);
+    }
+    used_ = 0;
+    mallocs_ = 0;
+}
+
+FrameAllocator::FrameAllocator()
+    :index_(0)
+    ,scopes_(0)
+    ,scopeResets_(false)
+    ,frameMallocs_(0)
+    ,frameBytes_(0)
+    ,frames_(0)
+{
+
+}
+
+FrameAllocator& FrameAllocator::local()
+{
+    struct ThreadFrameAllocator : public FrameAllocator {};
+    static thread_local ThreadFrameAllocator allocator;
+    return allocator;
+}
+
+FrameAllocator& FrameAllocator::current()
+{
+    FrameAllocator& allocator = local();
+#if defined(COCOS2D_DEBUG) && (COCOS2D_DEBUG > 0)
+    // nothing resets the arenas of other threads, they would grow for the life of the process
+    CCASSERT(allocator.scopes_ > 0 || allocator.frames_ > 0 || !s_framesStarted.load(std::memory_order_relaxed),
+        "frame memory is only reclaimed on the Director thread, use a FrameAllocator::Scope.");
+#endif
+    return allocator;
+}
+
+void FrameAllocator::endFrame()
+{
+    FrameArena& ending = arenas_[index_];
+    frameMallocs_ = ending.getChunkMallocs();
+    frameBytes_ = ending.getUsed();
+    frames_++;
+    s_framesStarted.store(true, std::memory_order_relaxed);
+    index_ ^= 1;
+    arenas_[index_].reset();
+}
+
+FrameAllocator::Scope::Scope()
+    :allocator_(FrameAllocator::local())
+{
+    if (allocator_.scopes_++ == 0)
+    {
+        // on the Director thread the arena may hold what the frame still needs
+        allocator_.scopeResets_ = allocator_.arenas_[allocator_.index_].getUsed() == 0;
+    }
+}
+
+FrameAllocator::Scope::~Scope()
+{
+    if (--allocator_.scopes_ == 0 && allocator_.scopeResets_)
+    {
+        allocator_.arenas_[allocator_.index_].reset();
+    }
+}
+
+NS_CC_END
@@ -0,0 +1,185 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+NS_CC_BEGIN
+
+/** @brief Bump allocator handing out memory that is only given back all at once by reset().
+ It grows by chunks, and reset() merges them into a single chunk of the total size,
+ so once a frame's working set has been seen the following frames do not malloc at all.
+ */
+class CC_DLL FrameArena
+{
+public:
+    static const size_t DEFAULT_CHUNK_SIZE = 64 * 1024;
+
+    FrameArena();
+    ~FrameArena();
+
+    inline void* allocate(size_t size, size_t alignment)
+    {
+        char* memory = align(cursor_, alignment);
+        if (!cursor_ || size > static_cast<size_t>(end_ - memory) || memory > end_)
+        {
+            return allocateChunk(size, alignment);
+        }
+        used_ += (memory + size) - cursor_;
+        cursor_ = memory + size;
+        return memory;
+    }
+
+    /** Invalidates every allocation made since the last reset. */
+    void reset();
+
+    /** Bytes handed out since the last reset, alignment padding included. */
+    inline size_t getUsed() const { return used_; }
+    inline size_t getCapacity() const { return capacity_; }
+    /** Chunks allocated from the heap since the last reset. */
+    inline uint32_t getChunkMallocs() const { return mallocs_; }
+private:
+    struct Chunk
+    {
+        Chunk* next;
+        size_t size;
+    };
+
+    static inline char* align(char* pointer, size_t alignment)
+    {
+        return reinterpret_cast<char*>((reinterpret_cast<uintptr_t>(pointer) + alignment - 1) & ~(uintptr_t)(alignment - 1));
+    }
+
+    void* allocateChunk(size_t size, size_t alignment);
+    void pushChunk(size_t size);
+    void freeChunks();
+
+    FrameArena(const FrameArena&) = delete;
+    FrameArena& operator=(const FrameArena&) = delete;
+
+    Chunk* chunks_;
+    char* cursor_;
+    char* end_;
+    size_t used_;
+    size_t capacity_;
+    uint32_t mallocs_;
+};
+
+/** @brief Per thread scratch memory living until the end of the next frame.
+ Memory is double-buffered, what a frame allocates stays valid during the frame after it,
+ which lets render data built while visiting be submitted one frame late.
+ Only the Director thread ends frames, other threads allocate inside a FrameAllocator::Scope.
+ Destructors are never run, only trivially destructible objects may be created in it.
+ @example Sort without heap allocations.
+ auto& allocator = SharedFrameAllocator;
+ Node** nodes = allocator.allocate<Node*>(count);
+ FrameVector<int> indices;
+ indices.reserve(count);
+ */
+class CC_DLL FrameAllocator
+{
+public:
+    /** @brief Frame memory for threads which do not end frames, such as workers.
+     What is allocated inside the outermost scope is reclaimed when it ends and must not outlive it.
+     */
+    class CC_DLL Scope
+    {
+    public:
+        Scope();
+        ~Scope();
+    private:
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+        FrameAllocator& allocator_;
+    };
+
+    /** The allocator of the calling thread, which is the Director thread or inside a Scope. */
+    static FrameAllocator& current();
+
+    inline void* allocate(size_t size, size_t alignment)
+    {
+        return arenas_[index_].allocate(size, alignment);
+    }
+
+    /** Uninitialized storage for count objects of type T. */
+    template<typename T>
+    inline T* allocate(size_t count)
+    {
+        return static_cast<T*>(allocate(sizeof(T) * count, alignof(T)));
+    }
+
+    template<typename T, typename... Args>
+    inline T* create(Args&&... args)
+    {
+        static_assert(std::is_trivially_destructible<T>::value, "frame allocated objects are never destroyed.");
+        return new (allocate<T>(1)) T(std::forward<Args>(args)...);
+    }
+
+    /** Flips the buffers, the memory of the frame before the one ending is reused. */
+    void endFrame();
+
+    /** Chunks the arena took from the heap during the last ended frame, zero in steady state.
+     Heap allocations made outside the arena are not counted. */
+    inline uint32_t getFrameChunkMallocs() const { return frameMallocs_; }
+    /** Bytes allocated during the last ended frame. */
+    inline size_t getFrameBytes() const { return frameBytes_; }
+    inline uint32_t getFrames() const { return frames_; }
+protected:
+    FrameAllocator();
+private:
+    static FrameAllocator& local();
+
+    FrameArena arenas_[2];
+    uint32_t index_;
+    uint32_t scopes_;
+    /** Whether the arena was empty when the outermost scope began, so the scope may reset it. */
+    bool scopeResets_;
+    uint32_t frameMallocs_;
+    size_t frameBytes_;
+    uint32_t frames_;
+};
+
+#define SharedFrameAllocator \
+    cocos2d::FrameAllocator::current()
+
+/** @brief STL allocator taking its memory from the frame allocator of the thread creating it.
+ Containers using it must not outlive the frame after the one they grew in.
+ */
+template<typename T>
+class FrameStlAllocator
+{
+public:
+    typedef T value_type;
+
+    FrameStlAllocator()
+        :allocator_(&FrameAllocator::current())
+    {}
+
+    template<typename U>
+    FrameStlAllocator(const FrameStlAllocator<U>& other)
+        :allocator_(other.allocator_)
+    {}
+
+    inline T* allocate(size_t count)
+    {
+        return allocator_->template allocate<T>(count);
+    }
+
+    inline void deallocate(T*, size_t) {}
+
+    template<typename U>
+    inline bool operator==(const FrameStlAllocator<U>& other) const { return allocator_ == other.allocator_; }
+    template<typename U>
+    inline bool operator!=(const FrameStlAllocator<U>& other) const { return allocator_ != other.allocator_; }
+private:
+    template<typename U> friend class FrameStlAllocator;
+    FrameAllocator* allocator_;
+};
+
+template<typename T>
+using FrameVector = std::vector<T, FrameStlAllocator<T>>;
+
+NS_CC_END
@@ -0,0 +1,166 @@
+#include "ccHeader.h"
+#include "RefPool.h"
+#include <atomic>
+#include <thread>
+
+NS_CC_BEGIN
+
+namespace
+{
+    const uint32_t PAGE_SIZE = 32 * 1024;
+    const uint32_t SLOT_ALIGNMENT = 16;
+    // 16 bytes steps up to 256 bytes, 64 bytes steps from there to MAX_SIZE
+    const uint32_t SMALL_SIZE = 256;
+    const uint32_t SMALL_CLASSES = SMALL_SIZE / 16;
+    const uint32_t SIZE_CLASSES = SMALL_CLASSES + (RefPool::MAX_SIZE - SMALL_SIZE) / 64;
+
+    struct FreeSlot
+    {
+        FreeSlot* next;
+    };
+
+    struct SizeClass
+    {
+        // a few instructions are run under it, touches and events are also made on the platform threads
+        std::atomic<bool> locked;
+        FreeSlot* free;
+        uint32_t capacity;
+        uint32_t live;
+        uint32_t peak;
+    };
+
+    // plain data, so the pools outlive every static object which could still release Refs
+    SizeClass s_classes[SIZE_CLASSES];
+    std::atomic<uint32_t> s_fallbacks;
+
+    class SizeClassLock
+    {
+    public:
+        explicit SizeClassLock(SizeClass& sizeClass)
+            :sizeClass_(sizeClass)
+        {
+            while (sizeClass_.locked.exchange(true, std::memory_order_acquire))
+            {
+                std::this_thread::yield();
+            }
+        }
+        ~SizeClassLock()
+        {
+            sizeClass_.locked.store(false, std::memory_order_release);
+        }
+    private:
+        SizeClass& sizeClass_;
+    };
+
+    inline uint32_t sizeClassOf(size_t size)
+    {
+        if (size <= SMALL_SIZE)
+        {
+            return static_cast<uint32_t>(size == 0 ? 0 : (size - 1) / 16);
+        }
+        return SMALL_CLASSES + static_cast<uint32_t>((size - SMALL_SIZE - 1) / 64);
+    }
+
+    inline uint32_t slotSizeOf(uint32_t sizeClass)
+    {
+        if (sizeClass < SMALL_CLASSES)
+        {
+            return (sizeClass + 1) * 16;
+        }
+        return SMALL_SIZE + (sizeClass - SMALL_CLASSES + 1) * 64;
+    }
+
+    void grow(SizeClass& sizeClass, uint32_t slotSize)
+    {
+        // the page is never freed, so its unaligned start needs not be kept
+        char* page = static_cast<char*>(malloc(PAGE_SIZE + SLOT_ALIGNMENT));
+        CCAssertIf(!page, "out of memory for RefPool.");
+        page = reinterpret_cast<char*>((reinterpret_cast<uintptr_t>(page) + SLOT_ALIGNMENT - 1) & ~(uintptr_t)(SLOT_ALIGNMENT - 1));
+        const uint32_t count = PAGE_SIZE / slotSize;
+        for (uint32_t i = count; i > 0; i--)
+        {
+            FreeSlot* slot = reinterpret_cast<FreeSlot*>(page + (i - 1) * slotSize);
+            slot->next = sizeClass.free;
+            sizeClass.free = slot;
+        }
+        sizeClass.capacity += count;
+    }
+}
+
+void* RefPool::allocate(size_t size)
+{
+    if (size > MAX_SIZE)
+    {
+        s_fallbacks++;
+        return ::operator new(size);
+    }
+    const uint32_t index = sizeClassOf(size);
+    SizeClass& sizeClass = s_classes[index];
+    SizeClassLock lock(sizeClass);
+    if (!sizeClass.free)
+    {
+        grow(sizeClass, slotSizeOf(index));
+    }
+    FreeSlot* slot = sizeClass.free;
+    sizeClass.free = slot->next;
+    if (++sizeClass.live > sizeClass.peak)
+    {
+        sizeClass.peak = sizeClass.live;
+    }
+    return slot;
+}
+
+void RefPool::deallocate(void* p, size_t size)
+{
+    if (!p)
+    {
+        return;
+    }
+    if (size > MAX_SIZE)
+    {
+        ::operator delete(p);
+        return;
+    }
+    SizeClass& sizeClass = s_classes[sizeClassOf(size)];
+    SizeClassLock lock(sizeClass);
+    FreeSlot* slot = static_cast<FreeSlot*>(p);
+    slot->next = sizeClass.free;
+    sizeClass.free = slot;
+    sizeClass.live--;
+}
+
+uint32_t RefPool::getSizeClassCount()
+{
+    return SIZE_CLASSES;
+}
+
+RefPoolStats RefPool::getStats(uint32_t sizeClass)
+{
+    CCAssertIf(sizeClass >= SIZE_CLASSES, "invalid RefPool size class.");
+    SizeClass& pool = s_classes[sizeClass];
+    SizeClassLock lock(pool);
+    RefPoolStats stats = { slotSizeOf(sizeClass), pool.capacity, pool.live, pool.peak };
+    return stats;
+}
+
+uint32_t RefPool::getFallbacks()
+{
+    return s_fallbacks;
+}
+
+void RefPool::printStats()
+{
+    size_t reserved = 0;
+    for (uint32_t i = 0; i < SIZE_CLASSES; i++)
+    {
+        RefPoolStats stats = getStats(i);
+        if (stats.capacity > 0)
+        {
+            reserved += stats.capacity * stats.slotSize;
+            log("[RefPool] %4u bytes: %u / %u slots live, peak %u\n", stats.slotSize, stats.live, stats.capacity, stats.peak);
+        }
+    }
+    log("[RefPool] %u KB reserved, %u allocations too large\n", static_cast<uint32_t>(reserved / 1024), s_fallbacks.load());
+}
+
+NS_CC_END
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <type_traits>
+
+NS_CC_BEGIN
+
+struct RefPoolStats
+{
+    /** Bytes of a slot of the size class. */
+    uint32_t slotSize;
+    /** Slots owned by the class, free or not. */
+    uint32_t capacity;
+    uint32_t live;
+    uint32_t peak;
+};
+
+/** @brief Size-class pools for the small objects churned on the cocos thread.
+ A class hands out fixed size slots threaded in a free list through pages of 32KB,
+ objects larger than MAX_SIZE use the global operator new. Pages are kept for reuse
+ and never given back to the system. Each class is guarded by a spin lock, since touches and events
+ are also created on the platform threads; the objects themselves stay as thread-unsafe as Ref.
+ */
+class CC_DLL RefPool
+{
+public:
+    static const uint32_t MAX_SIZE = 2048;
+
+    static void* allocate(size_t size);
+    static void deallocate(void* p, size_t size);
+
+    static uint32_t getSizeClassCount();
+    static RefPoolStats getStats(uint32_t sizeClass);
+    /** Allocations which were too large for a size class. */
+    static uint32_t getFallbacks();
+    static void printStats();
+};
+
+NS_CC_END
+
+// Allocates the class, and the ones deriving from it, from RefPool.
+// Deleting through a base pointer requires a virtual destructor, as for Ref.
+#define COCOS_POOLED(type) \
+public: \
+static void* operator new(size_t size) \
+{ \
+    static_assert(std::has_virtual_destructor<type>::value, "pooled objects are freed with their dynamic size."); \
+    return cocos2d::RefPool::allocate(size); \
+} \
+static void* operator new(size_t size, const std::nothrow_t&) noexcept \
+{ \
+    return cocos2d::RefPool::allocate(size); \
+} \
+static void* operator new(size_t, void* place) noexcept \
+{ \
+    return place; \
+} \
+static void operator delete(void* p, size_t size) \
+{ \
+    cocos2d::RefPool::deallocate(p, size); \
+} \
+static void operator delete(void*, void*) noexcept \
+{ \
+}
@@ -18,6 +18,7 @@ public:
     static TValue* create(const T& value);
 protected:
     TValue() {}
+    COCOS_TYPE_OVERRIDE(TValue, Ref);
 };
 
 template<typename T>
@@ -42,7 +43,7 @@ protected:
     {}
 private:
     T value_;
-    COCOS_TYPE_OVERRIDE(TValueEx<T>);
+    COCOS_TYPE_OVERRIDE(TValueEx<T>, TValue);
 };
 
 template<>
@@ -60,7 +61,7 @@ public:
     CREATE_FUNC(TValueEx<Ref*>);
 private:
     SmartPtr<> value_;
-    COCOS_TYPE_OVERRIDE(TValueEx<Ref*>);
+    COCOS_TYPE_OVERRIDE(TValueEx<Ref*>, TValue);
 };
 
 template<typename T>
@@ -94,6 +95,7 @@ public:
     static const SmartPtr<TValues> None;
 protected:
     TValues() { }
+    COCOS_TYPE_OVERRIDE(TValues, Ref);
 };
 
 template<typename... Fields>
@@ -105,7 +107,7 @@ public:
         :values(std::make_tuple(args...))
     { }
     std::tuple<Fields...> values;
-    COCOS_TYPE_OVERRIDE(TValuesEx<Fields...>);
+    COCOS_TYPE_OVERRIDE(TValuesEx<Fields...>, TValues);
 };
 
 template<typename... Args>
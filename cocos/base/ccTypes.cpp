@@ -35,6 +35,18 @@ const ssize_t CC_INVALID_INDEX = -1;
 
 int cocosType = 1;
 
+CocosTypeInfo::CocosTypeInfo(const CocosTypeInfo* parent)
+: id(cocosType++)
+, depth(parent ? parent->depth + 1 : 0)
+{
+    CCASSERT(depth < MAX_DEPTH, "COCOS_TYPE hierarchy is too deep");
+    for (int i = 0; i < depth; ++i)
+    {
+        display[i] = parent->display[i];
+    }
+    display[depth] = this;
+}
+
 /**
  * Color3B
  */
@@ -385,11 +397,17 @@ void Flag::toggle(uint32_t type)
 bgfx::VertexDecl V3F_C4B_T2F::ms_decl;
 V3F_C4B_T2F::Init V3F_C4B_T2F::init;
 
+bgfx::VertexDecl V3F_C4B_C4B_T2F::ms_decl;
+V3F_C4B_C4B_T2F::Init V3F_C4B_C4B_T2F::init;
+
 bgfx::VertexDecl DrawVertex::ms_decl;
 DrawVertex::Init DrawVertex::init;
 
 bgfx::VertexDecl VecVertex::ms_decl;
 VecVertex::Init VecVertex::init;
 
+bgfx::VertexDecl SkinnedVertex::ms_decl;
+SkinnedVertex::Init SkinnedVertex::init;
+
 NS_CC_END
 
@@ -28,6 +28,7 @@ THE SOFTWARE.
 #ifndef __BASE_CCTYPES_H__
 #define __BASE_CCTYPES_H__
 
+#include <type_traits>
 #include "math/CCGeometry.h"
 #include "platform/CCGL.h"
 #include "bgfx/bgfx.h"
@@ -331,6 +332,37 @@ struct CC_DLL V3F_C4B_T2F
     static Init init;
 };
 
+/** @struct V3F_C4B_C4B_T2F
+ * A vertex with a light and a dark color, used for two color tinting.
+ */
+struct CC_DLL V3F_C4B_C4B_T2F
+{
+    /// vertices (3F)
+    Vec3         vertices;            // 12 bytes
+    /// light color (4B)
+    Color4B      colors;              // 4 bytes
+    /// dark color (4B)
+    Color4B      colors2;             // 4 bytes
+    // tex coords (2F)
+    Tex2F        texCoords;           // 8 bytes
+
+    struct Init
+    {
+        Init()
+        {
+            ms_decl.begin()
+                    .add(bgfx::Attrib::Position, 3, bgfx::AttribType::Float)
+                    .add(bgfx::Attrib::Color0, 4, bgfx::AttribType::Uint8, true)
+                    .add(bgfx::Attrib::Color1, 4, bgfx::AttribType::Uint8, true)
+                    .add(bgfx::Attrib::TexCoord0, 2, bgfx::AttribType::Float)
+                   .end();
+        }
+    };
+
+    static bgfx::VertexDecl ms_decl;
+    static Init init;
+};
+
 struct DrawVertex
 {
     float x, y, z, w;
@@ -368,6 +400,30 @@ struct VecVertex
     static Init init;
 };
 
+/** Bind pose vertex skinned in the vertex shader, see SkinnedMesh. */
+struct SkinnedVertex
+{
+    float positions[8];     // bone local x, y of each influence
+    float u, v;
+    float weights[4];
+    float bones[4];         // bone palette index of each influence
+    struct Init
+    {
+        Init()
+        {
+            ms_decl.begin()
+                .add(bgfx::Attrib::Position, 4, bgfx::AttribType::Float)
+                .add(bgfx::Attrib::TexCoord1, 4, bgfx::AttribType::Float)
+                .add(bgfx::Attrib::TexCoord0, 2, bgfx::AttribType::Float)
+                .add(bgfx::Attrib::Weight, 4, bgfx::AttribType::Float)
+                .add(bgfx::Attrib::Indices, 4, bgfx::AttribType::Float)
+                .end();
+        }
+    };
+    static bgfx::VertexDecl ms_decl;
+    static Init init;
+};
+
 /** @struct V3F_T2F
  * A Vec2 with a vertex point, a tex coord point.
  */
@@ -730,35 +786,96 @@ enum LabelEffect {
 
 extern int cocosType;
 
+/** @struct CocosTypeInfo
+ * Runtime type of a class declared with the COCOS_TYPE macros. display lists the types from the root
+ * of the hierarchy down to this one, each at the index of its depth, so testing whether a type derives
+ * from another is one lookup at the depth of the other.
+ */
+struct CC_DLL CocosTypeInfo
+{
+    static const int MAX_DEPTH = 16;
+
+    explicit CocosTypeInfo(const CocosTypeInfo* parent);
+
+    inline bool isA(const CocosTypeInfo* other) const
+    {
+        return depth >= other->depth && display[other->depth] == other;
+    }
+
+    int id;
+    int depth;
+    const CocosTypeInfo* display[MAX_DEPTH];
+};
+
+// Depth of T in its COCOS_TYPE hierarchy, known at compile time so display can't overflow
+template<typename T>
+struct CocosTypeDepth
+{
+    static const int value = CocosTypeDepth<typename T::CocosTypeParent>::value + 1;
+};
+
+template<>
+struct CocosTypeDepth<void>
+{
+    static const int value = -1;
+};
+
+template<typename T>
+const CocosTypeInfo* CocosTypeInfoOf()
+{
+    static_assert(CocosTypeDepth<T>::value < CocosTypeInfo::MAX_DEPTH, "COCOS_TYPE hierarchy is too deep, raise CocosTypeInfo::MAX_DEPTH");
+    static const CocosTypeInfo info(CocosTypeInfoOf<typename T::CocosTypeParent>());
+    return &info;
+}
+
+template<>
+inline const CocosTypeInfo* CocosTypeInfoOf<void>()
+{
+    return nullptr;
+}
+
 template<typename T>
 int CocosType()
 {
-    static int type = cocosType++;
-    return type;
+    return CocosTypeInfoOf<T>()->id;
 }
 
 #define COCOS_TYPE(type) \
-public: int getCocosType() const \
+public: typedef void CocosTypeParent; \
+const cocos2d::CocosTypeInfo* getCocosTypeInfo() const \
 { \
-    return cocos2d::CocosType<type>(); \
+    return cocos2d::CocosTypeInfoOf<type>(); \
+} \
+int getCocosType() const \
+{ \
+    return getCocosTypeInfo()->id; \
 }
 
 #define COCOS_TYPE_BASE(type) \
-public: virtual int getCocosType() const \
+public: typedef void CocosTypeParent; \
+virtual const cocos2d::CocosTypeInfo* getCocosTypeInfo() const \
+{ \
+    return cocos2d::CocosTypeInfoOf<type>(); \
+} \
+int getCocosType() const \
 { \
-    return cocos2d::CocosType<type>(); \
+    return getCocosTypeInfo()->id; \
 }
 
-#define COCOS_TYPE_OVERRIDE(type) \
-public: virtual int getCocosType() const override \
+// parent is the nearest base class declaring a COCOS_TYPE
+#define COCOS_TYPE_OVERRIDE(type, parent) \
+public: typedef parent CocosTypeParent; \
+virtual const cocos2d::CocosTypeInfo* getCocosTypeInfo() const override \
 { \
-    return cocos2d::CocosType<type>(); \
+    static_assert(std::is_base_of<parent, type>::value, "COCOS_TYPE_OVERRIDE parent must be a base of " #type); \
+    return cocos2d::CocosTypeInfoOf<type>(); \
 }
 
+// Returns obj if it is an OutT or derives from it, nullptr otherwise
 template<typename OutT, typename InT>
 OutT* CocosCast(InT* obj)
 {
-    return (obj && obj->getCocosType() == CocosType<OutT>()) ? static_cast<OutT*>(obj) : nullptr;
+    return (obj && obj->getCocosTypeInfo()->isA(CocosTypeInfoOf<OutT>())) ? static_cast<OutT*>(obj) : nullptr;
 }
 
 namespace Switch
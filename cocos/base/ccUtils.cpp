@@ -37,6 +37,9 @@ THE SOFTWARE.
 #include "renderer/Program.h"
 #include "2d/CCSprite.h"
 #include "2d/CCRenderTexture.h"
+#include "base/Camera.h"
+#include "base/View.h"
+#include "editor-support/creator/CCCameraNode.h"
 
 NS_CC_BEGIN
 
@@ -266,6 +269,24 @@ long long getTimeInMilliseconds()
     return (long long)tv.tv_sec * 1000 + tv.tv_usec / 1000;
 }
 
+int fseek64(FILE* fp, int64_t offset, int origin)
+{
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_WIN32)
+    return _fseeki64(fp, offset, origin);
+#else
+    return fseeko(fp, (off_t)offset, origin);
+#endif
+}
+
+int64_t ftell64(FILE* fp)
+{
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_WIN32)
+    return _ftelli64(fp);
+#else
+    return ftello(fp);
+#endif
+}
+
 Rect getCascadeBoundingBox(Node *node)
 {
     Rect cbb;
@@ -310,6 +331,52 @@ Rect getCascadeBoundingBox(Node *node)
     return cbb;
 }
 
+Rect getVisibleRect()
+{
+    creator::CameraNode* camera = creator::CameraNode::getInstance();
+    if (!camera || camera->visitingIndex <= 0)
+    {
+        return Rect(SharedDirector.getVisibleOrigin(), SharedDirector.getVisibleSize());
+    }
+    return camera->getVisibleRect();
+}
+
+Rect getScreenRect(const Mat4& transform, const Rect& rect)
+{
+    const Size& viewport = SharedDirector.getWinSize();
+    Mat4 projMatrix;
+    bx::mtxMul(projMatrix, SharedDirector.getCamera()->getView(), SharedView.getProjection());
+
+    Vec3 corners[4] = {
+        Vec3(rect.getMinX(), rect.getMinY(), 0),
+        Vec3(rect.getMaxX(), rect.getMinY(), 0),
+        Vec3(rect.getMinX(), rect.getMaxY(), 0),
+        Vec3(rect.getMaxX(), rect.getMaxY(), 0)
+    };
+    float minX = FLT_MAX, minY = FLT_MAX, maxX = -FLT_MAX, maxY = -FLT_MAX;
+    for (Vec3& corner : corners)
+    {
+        transform.transformPoint(&corner);
+        Vec4 clipPos;
+        projMatrix.transformVector(Vec4(corner.x, corner.y, corner.z, 1), &clipPos);
+        if (clipPos.w == 0)
+        {
+            continue;
+        }
+        float x = (clipPos.x / clipPos.w + 1) * 0.5f * viewport.width;
+        float y = (clipPos.y / clipPos.w + 1) * 0.5f * viewport.height;
+        minX = std::min(minX, x);
+        minY = std::min(minY, y);
+        maxX = std::max(maxX, x);
+        maxY = std::max(maxY, y);
+    }
+    if (minX > maxX)
+    {
+        return Rect::ZERO;
+    }
+    return Rect(minX, minY, maxX - minX, maxY - minY);
+}
+
 Sprite* createSpriteFromBase64Cached(const char* base64String, const char* key)
 {
     Texture2D* texture = SharedDirector.getTextureCache()->getTextureForKey(key);
@@ -105,12 +105,36 @@ namespace utils
      */
     CC_DLL long long  getTimeInMilliseconds();
 
+    /**
+     * fseek with a 64 bit offset, fseeko or _fseeki64, so files over 2GB are seekable where long is 32 bit.
+     * @return Returns 0 on success like fseek.
+     */
+    CC_DLL int fseek64(FILE* fp, int64_t offset, int origin);
+
+    /**
+     * ftell with a 64 bit result, ftello or _ftelli64.
+     * @return Returns the position, -1 on failure like ftell.
+     */
+    CC_DLL int64_t ftell64(FILE* fp);
+
     /**
      * Calculate unionof bounding box of a node and its children.
      * @return Returns unionof bounding box of a node and its children.
      */
     CC_DLL Rect getCascadeBoundingBox(Node *node);
 
+    /**
+     * Get the visible rect, the one of the creator camera while it is visiting.
+     * @return Returns the visible rect in screen coordinates.
+     */
+    CC_DLL Rect getVisibleRect();
+
+    /**
+     * Project a rect through a transform and the camera onto the screen.
+     * @return Returns the screen bounding box of the rect, Rect::ZERO when it is not projected.
+     */
+    CC_DLL Rect getScreenRect(const Mat4& transform, const Rect& rect);
+
     /**
      * Create a sprite instance from base64 encoded image and adds the texture to the Texture Cache.
      * @return Returns an instance of sprite
@@ -45,6 +45,7 @@ using namespace cocos2d::Switch::Literals;
 #include "base/ccConfig.h"
 #include "base/Singleton.h"
 #include "base/Own.h"
+#include "base/RefPool.h"
 #include "base/CCRef.h"
 #include "base/SmartPtr.h"
 #include "base/WeakPtr.h"
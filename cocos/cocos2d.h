@@ -145,6 +145,7 @@ THE SOFTWARE.
 // renderer
 #include "renderer/Renderer.h"
 #include "renderer/Program.h"
+#include "renderer/SkinnedMesh.h"
 #include "renderer/CCTexture2D.h"
 #include "renderer/CCTextureCache.h"
 #include "renderer/CCVertexIndexBuffer.h"
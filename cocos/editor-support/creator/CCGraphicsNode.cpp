@@ -837,7 +837,8 @@ void GraphicsNode::expandFill(float w, int lineJoin, float miterLimit)
         
         if (path->complex) {
             // indices
-            std::vector<int> indices;
+            cocos2d::FrameVector<int> indices;
+            indices.reserve(std::max(nVerts - 2, 0) * 3);
             Triangulate::process(verts, 0, _buffer->vertsOffset - offset, indices);
             int nIndices = (int)indices.size();
 
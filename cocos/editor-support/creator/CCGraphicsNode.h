@@ -309,7 +309,7 @@ protected:
     
     Path* _curPath;
 
-    COCOS_TYPE_OVERRIDE(GraphicsNode);
+    COCOS_TYPE_OVERRIDE(GraphicsNode, cocos2d::Node);
 };
 
 }
@@ -179,7 +179,7 @@ private:
         QuadsDirty = Node::UserFlag << 2,
         DepthWrite = Node::UserFlag << 3,
     };
-    COCOS_TYPE_OVERRIDE(Scale9SpriteV2);
+    COCOS_TYPE_OVERRIDE(Scale9SpriteV2, cocos2d::Node);
 };
 
 }
@@ -75,13 +75,13 @@ bool Triangulate::snip(const VecVertex *contour, int offset, int n, int u, int v
     return true;
 }
 
-bool Triangulate::process(const VecVertex *contour, int offset, int n, std::vector<int> &result)
+bool Triangulate::process(const VecVertex *contour, int offset, int n, cocos2d::FrameVector<int> &result)
 {
     /* allocate and initialize list of Vertices in polygon */
     
     if ( n < 3 ) return false;
     
-    int *V = new int[n];
+    int *V = SharedFrameAllocator.allocate<int>(n);
     
     /* we want a counter-clockwise polygon in V */
     
@@ -101,7 +101,6 @@ bool Triangulate::process(const VecVertex *contour, int offset, int n, std::vect
         if (0 >= (count--))
         {
             //** Triangulate: ERROR - probable bad polygon!
-            delete []V;
             return false;
         }
         
@@ -132,9 +131,5 @@ bool Triangulate::process(const VecVertex *contour, int offset, int n, std::vect
         }
     }
     
-    
-    
-    delete []V;
-    
     return true;
 }
@@ -38,6 +38,7 @@
 
 #include <vector>  // Include STL vector class.
 #include "CCGraphicsNode.h"
+#include "base/FrameAllocator.h"
 
 using namespace creator;
 
@@ -46,8 +47,8 @@ class Triangulate
     public:
     
     // triangulate a contour/polygon, places results in STL vector
-    // as series of triangles.
-    static bool process(const VecVertex *contour, int offset, int n, std::vector<int> &result);
+    // as series of triangles, scratch memory comes from the frame allocator.
+    static bool process(const VecVertex *contour, int offset, int n, cocos2d::FrameVector<int> &result);
     
     // compute area of a contour/polygon
     static float area(const VecVertex *contour, int offset, int n);
@@ -56,6 +56,7 @@ void Armature::_onClear()
 
     _replacedTexture = nullptr;
     _parent = nullptr;
+    _skipPoseUpdate = false;
 
     _delayDispose = false;
     _lockDispose = false;
@@ -248,18 +249,25 @@ void Armature::advanceTime(float passedTime)
     }
 
     //
-    for (const auto bone : _bones)
+    if (!_skipPoseUpdate)
     {
-        bone->_update(_cacheFrameIndex);
+        for (const auto bone : _bones)
+        {
+            bone->_update(_cacheFrameIndex);
+        }
     }
 
     for (const auto slot : _slots)
     {
-        slot->_update(_cacheFrameIndex);
+        if (!_skipPoseUpdate)
+        {
+            slot->_update(_cacheFrameIndex);
+        }
 
         const auto childArmature = slot->getChildArmature();
         if (childArmature)
         {
+            childArmature->_skipPoseUpdate = _skipPoseUpdate;
             if (slot->inheritAnimation)
             {
                 childArmature->advanceTime(scaledPassedTime);
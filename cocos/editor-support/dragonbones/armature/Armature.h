@@ -39,6 +39,8 @@ public: // private
     void* _replacedTexture;
     /** @private */
     Slot* _parent;
+    /** @private */
+    bool _skipPoseUpdate;
 
 protected:
     bool _delayDispose;
@@ -24,6 +24,16 @@ CCArmatureDisplay* CCArmatureDisplay::create()
 CCArmatureDisplay::CCArmatureDisplay() :
     _armature(nullptr),
     _dispatcher(nullptr),
+    _lodScreenSize(0.f),
+    _lodInterval(1),
+    _lodCounter(0),
+    _lodPassedTime(0.f),
+    _cullingPadding(0.f),
+    _screenSize(FLT_MAX),
+    _visibleOnlyUpdate(false),
+    _gpuSkinning(false),
+    _offscreen(false),
+    _poseDirty(false),
     _eventCallback(nullptr)
 {
     _dispatcher = new cocos2d::EventDispatcher();
@@ -64,9 +74,76 @@ void CCArmatureDisplay::dispose()
 
 void CCArmatureDisplay::update(float passedTime)
 {
+    _lodPassedTime += passedTime;
+
+    const bool skipPose = _visibleOnlyUpdate && _offscreen;
+    // Back in view, the bones and slots catch up now instead of at the next LOD step.
+    const bool catchUp = _poseDirty && !skipPose;
+    if (!skipPose && !catchUp && _lodInterval > 1 && _screenSize < _lodScreenSize && ++_lodCounter < _lodInterval)
+    {
+        return;
+    }
+
+    // Events dispatched by advanceTime may dispose the armature and this display.
+    passedTime = _lodPassedTime;
+    _lodPassedTime = 0.f;
+    _lodCounter = 0;
+    _poseDirty = skipPose;
+    _armature->_skipPoseUpdate = skipPose;
     _armature->advanceTime(passedTime);
 }
 
+void CCArmatureDisplay::draw(cocos2d::IRenderer* renderer, const cocos2d::Mat4& transform, uint32_t flags)
+{
+    if (!_armature || (_lodInterval <= 1 && !_visibleOnlyUpdate))
+    {
+        return;
+    }
+
+    const auto& aabb = _armature->getArmatureData().aabb;
+    const cocos2d::Rect bounds(
+        aabb.x - _cullingPadding, -aabb.y - aabb.height - _cullingPadding,
+        aabb.width + _cullingPadding * 2.f, aabb.height + _cullingPadding * 2.f
+    );
+    const auto screenRect = cocos2d::utils::getScreenRect(transform, bounds);
+    _screenSize = std::max(screenRect.size.width, screenRect.size.height);
+    _offscreen = !cocos2d::utils::getVisibleRect().intersectsRect(screenRect);
+}
+
+void CCArmatureDisplay::setUpdateLod(float screenSize, int interval)
+{
+    _lodScreenSize = screenSize;
+    _lodInterval = std::max(interval, 1);
+    _lodCounter = 0;
+}
+
+void CCArmatureDisplay::setVisibleOnlyUpdate(bool value)
+{
+    _visibleOnlyUpdate = value;
+    if (!_visibleOnlyUpdate)
+    {
+        _offscreen = false;
+    }
+}
+
+void CCArmatureDisplay::setGpuSkinning(bool value)
+{
+    if (_gpuSkinning == value)
+    {
+        return;
+    }
+
+    _gpuSkinning = value;
+    if (_armature)
+    {
+        // Mesh slots pick the new path on their next update.
+        for (const auto slot : _armature->getSlots())
+        {
+            slot->_ffdDirty = true;
+        }
+    }
+}
+
 void CCArmatureDisplay::advanceTimeBySelf(bool on)
 {
     if (on)
@@ -109,11 +186,17 @@ DBCCSprite* DBCCSprite::create()
 }
 
 DBCCSprite::DBCCSprite()
-    :_insideBounds(true)
+    :_skinnedMeshBuilt(false)
+    ,_insideBounds(true)
 {
 }
 DBCCSprite::~DBCCSprite() {}
 
+bool DBCCSprite::hasDefaultProgram() const
+{
+    return program_.get() == SharedRenderer.getDefaultProgram();
+}
+
 cocos2d::Vec2 DBCCSprite::projectGL(const cocos2d::Vec3& src) const
 {
     cocos2d::Vec2 screenPos;
@@ -138,17 +221,7 @@ cocos2d::Vec2 DBCCSprite::projectGL(const cocos2d::Vec3& src) const
 
 bool DBCCSprite::_checkVisibility(const cocos2d::Mat4& transform, const cocos2d::Size& size, const cocos2d::Rect& rect)
 {
-    auto director = &SharedDirector;
-    
-    creator::CameraNode* camera = creator::CameraNode::getInstance();
-    cocos2d::Rect visibleRect;
-    if (!camera || camera->visitingIndex <= 0) {
-        visibleRect.origin = director->getVisibleOrigin();
-        visibleRect.size = director->getVisibleSize();
-    }
-    else {
-        visibleRect = camera->getVisibleRect();
-    }
+    cocos2d::Rect visibleRect = cocos2d::utils::getVisibleRect();
 
     // transform center point to screen space
     float hSizeX = size.width / 2;
@@ -185,6 +258,32 @@ void DBCCSprite::draw(cocos2d::IRenderer* renderer, const cocos2d::Mat4& transfo
         _insideBounds = true;
     }
 
+    if (!_bonePalette.empty())
+    {
+        if (!hasDefaultProgram())
+        {
+            // A custom program needs the polygon skinned on the CPU, the next update of the bones does it.
+            // This frame still uses the palette, the polygon vertices are not up to date yet.
+            const auto armatureDisplay = dynamic_cast<CCArmatureDisplay*>(getParent());
+            if (armatureDisplay)
+            {
+                armatureDisplay->getArmature()->invalidUpdate();
+            }
+        }
+
+        if (_insideBounds)
+        {
+            uint64_t state = (
+                BGFX_STATE_WRITE_RGB | BGFX_STATE_WRITE_A |
+                BGFX_STATE_MSAA | _blendFunc.toValue());
+
+            SharedRendererManager.setCurrent(SharedRenderer.getTarget());
+            SharedRenderer.push(_skinnedMesh.get(), _bonePalette.data(), _polyInfo.triangles.verts[0].colors,
+                _texture, state, _texture->getFlags(), transform);
+        }
+        return;
+    }
+
     if (_insideBounds)
     {
         /*_trianglesCommand.init(_globalZOrder, _texture->getName(), getGLProgramState(), _blendFunc, _polyInfo.triangles, transform, flags);
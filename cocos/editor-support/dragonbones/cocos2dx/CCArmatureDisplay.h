@@ -18,6 +18,16 @@ public:
 
 protected:
     cocos2d::EventDispatcher* _dispatcher;
+    float _lodScreenSize;
+    int _lodInterval;
+    int _lodCounter;
+    float _lodPassedTime;
+    float _cullingPadding;
+    float _screenSize;
+    bool _visibleOnlyUpdate;
+    bool _gpuSkinning;
+    bool _offscreen;
+    bool _poseDirty;
 
 protected:
     CCArmatureDisplay();
@@ -35,6 +45,8 @@ public:
     virtual void dispose() override;
     /** @private */
     virtual void update(float passedTime) override;
+    /** @private */
+    virtual void draw(cocos2d::IRenderer* renderer, const cocos2d::Mat4& transform, uint32_t flags) override;
 
 public:
     virtual void advanceTimeBySelf(bool on) override;
@@ -57,6 +69,36 @@ public:
         return _armature->getAnimation();
     }
 
+    /**
+     * Update-rate LOD. While the armature covers less than screenSize points on screen,
+     * it advances only every interval updates by the accumulated time. An interval of 1 disables it.
+     */
+    void setUpdateLod(float screenSize, int interval);
+    /**
+     * While the armature is off screen its bones and slots are not updated,
+     * animation time and events still advance every update.
+     */
+    void setVisibleOnlyUpdate(bool value);
+    inline bool isVisibleOnlyUpdate() const
+    {
+        return _visibleOnlyUpdate;
+    }
+    /**
+     * Weighted meshes without FFD are skinned in the vertex shader from a bone palette instead of on the CPU.
+     * Meshes with more than SkinnedMesh::MAX_BONES bones or MAX_INFLUENCES weights per vertex stay on the CPU,
+     * each GPU skinned mesh is its own draw call and is not culled per slot.
+     */
+    void setGpuSkinning(bool value);
+    inline bool isGpuSkinning() const
+    {
+        return _gpuSkinning;
+    }
+    /** Margin added around the armature bounds when measuring its size and visibility on screen. */
+    inline void setCullingPadding(float value)
+    {
+        _cullingPadding = value;
+    }
+
 CC_CONSTRUCTOR_ACCESS:
     // methods added for js bindings
     void setEventCallback(const std::function<void(EventObject*)>& callback) {
@@ -100,6 +142,19 @@ public:
      * Modify for cocos2dx 3.7, 3.8, 3.9
      */
     cocos2d::PolygonInfo& getPolygonInfoModify();
+    /** Whether no custom program was set, the GPU skinning program replaces only the default one. */
+    bool hasDefaultProgram() const;
+
+public:
+    /** @private Mesh skinned on the GPU, built by CCSlot on first use. */
+    cocos2d::SmartPtr<cocos2d::SkinnedMesh> _skinnedMesh;
+    /** @private Two rows per mesh bone, empty while the polygon vertices are skinned on the CPU. */
+    std::vector<cocos2d::Vec4> _bonePalette;
+    /** @private Per mesh bone, min x, min y, max x, max y of the bind positions it moves, bounds the skinned mesh. */
+    std::vector<cocos2d::Vec4> _boneBounds;
+    /** @private */
+    bool _skinnedMeshBuilt;
+
 protected:
     bool _insideBounds;
 };
@@ -2,6 +2,7 @@
 #include "CCTextureData.h"
 #include "CCArmatureDisplay.h"
 #include "CCSlot.h"
+#include "base/Async.h"
 
 DRAGONBONES_NAMESPACE_BEGIN
 
@@ -140,9 +141,117 @@ DragonBonesData* CCFactory::loadDragonBonesData(const std::string& filePath, con
     }
 
     const auto scale = SharedDirector.getContentScaleFactor();
+    if (BinaryDataParser::isBinaryData(data.data(), data.size()))
+    {
+        const auto dragonBonesData = _defaultDataParser.parseDragonBonesData(data.data(), data.size(), 1.f / scale);
+        if (dragonBonesData)
+        {
+            addDragonBonesData(dragonBonesData, dragonBonesName);
+        }
+
+        return dragonBonesData;
+    }
+
     return this->parseDragonBonesData(data.c_str(), dragonBonesName, 1.f / scale);
 }
 
+void CCFactory::loadDragonBonesDataAsync(const std::string& filePath, const std::function<void(DragonBonesData*)>& callback, const std::string& dragonBonesName)
+{
+    if (!dragonBonesName.empty())
+    {
+        const auto existedData = this->getDragonBonesData(dragonBonesName);
+        if (existedData)
+        {
+            callback(existedData);
+            return;
+        }
+    }
+
+    const auto fullpath = cocos2d::FileUtils::getInstance()->fullPathForFilename(filePath);
+    if (fullpath.empty())
+    {
+        callback(nullptr);
+        return;
+    }
+
+    const auto scale = 1.f / SharedDirector.getContentScaleFactor();
+    cocos2d::FileUtils::getInstance()->loadFileAsyncUnsafe(fullpath, [this, scale, callback, dragonBonesName](uint8_t* buffer, ssize_t size)
+    {
+        const auto rawData = reinterpret_cast<const char*>(buffer);
+        if (!buffer || size <= 0)
+        {
+            free(buffer);
+            callback(nullptr);
+            return;
+        }
+
+        if (!BinaryDataParser::isBinaryData(rawData, size))
+        {
+            // The JSON parser borrows from the object pools, which belong to the main thread.
+            const std::string data(rawData, size);
+            free(buffer);
+            callback(_addLoadedDragonBonesData(_dataParser->parseDragonBonesData(data.c_str(), scale), dragonBonesName));
+            return;
+        }
+
+        SharedAsyncThread.Loader.run([buffer, size, scale]()
+        {
+            BinaryDataParser parser;
+            auto complete = false;
+            const auto data = parser.parseDragonBonesData(reinterpret_cast<const char*>(buffer), size, scale, complete);
+            free(buffer);
+            return cocos2d::TValues::create(data, complete);
+        }, [this, callback, dragonBonesName](cocos2d::TValues* result)
+        {
+            DragonBonesData* data;
+            bool complete;
+            result->get(data, complete);
+            if (data && !complete)
+            {
+                data->returnToPool();
+                data = nullptr;
+            }
+
+            callback(_addLoadedDragonBonesData(data, dragonBonesName));
+        });
+    });
+}
+
+bool CCFactory::saveDragonBonesDataBinary(const std::string& dragonBonesName, const std::string& fullPath)
+{
+    const auto dragonBonesData = this->getDragonBonesData(dragonBonesName);
+    std::vector<char> output;
+    if (!dragonBonesData || !BinaryDataParser::writeDragonBonesData(*dragonBonesData, output))
+    {
+        return false;
+    }
+
+    cocos2d::Data data;
+    data.copy(reinterpret_cast<const unsigned char*>(output.data()), output.size());
+
+    return cocos2d::FileUtils::getInstance()->writeDataToFile(data, fullPath);
+}
+
+DragonBonesData* CCFactory::_addLoadedDragonBonesData(DragonBonesData* data, const std::string& dragonBonesName)
+{
+    if (!data)
+    {
+        return nullptr;
+    }
+
+    // The same data may have been loaded while this request was in flight.
+    const auto existedData = this->getDragonBonesData(dragonBonesName.empty() ? data->name : dragonBonesName);
+    if (existedData)
+    {
+        data->returnToPool();
+        return existedData;
+    }
+
+    addDragonBonesData(data, dragonBonesName);
+
+    return data;
+}
+
 TextureAtlasData* CCFactory::loadTextureAtlasData(const std::string& filePath, const std::string& dragonBonesName, float scale)
 {
     const auto fullpath = cocos2d::FileUtils::getInstance()->fullPathForFilename(filePath);
@@ -26,6 +26,14 @@ protected:
 
 public:
     virtual DragonBonesData* loadDragonBonesData(const std::string& filePath, const std::string& dragonBonesName = "");
+    /**
+     * Binary data is parsed on the loader thread, JSON data is only read there. The callback runs on the main thread.
+     */
+    virtual void loadDragonBonesDataAsync(const std::string& filePath, const std::function<void(DragonBonesData*)>& callback, const std::string& dragonBonesName = "");
+    /**
+     * Converts loaded data to the binary format read by BinaryDataParser.
+     */
+    virtual bool saveDragonBonesDataBinary(const std::string& dragonBonesName, const std::string& fullPath);
     virtual TextureAtlasData* loadTextureAtlasData(const std::string& filePath, const std::string& dragonBonesName = "", float scale = 0.f);
     virtual TextureAtlasData* parseTextureAtlasData(const std::string& atlasData, const std::string& texturePath, const std::string& dragonBonesName = "", float scale = 0.f);
     virtual CCArmatureDisplay* buildArmatureDisplay(const std::string& armatureName, const std::string& dragonBonesName = "", const std::string& skinName = "") const;
@@ -34,6 +42,7 @@ public:
 
 private:
     void _initTextureAtlasData(TextureAtlasData* atlasData);
+    DragonBonesData* _addLoadedDragonBonesData(DragonBonesData* data, const std::string& dragonBonesName);
 };
 
 DRAGONBONES_NAMESPACE_END
@@ -137,6 +137,9 @@ void CCSlot::_updateFilters()
 void CCSlot::_updateFrame()
 {
     const auto frameDisplay = (DBCCSprite*)(this->_rawDisplay);
+    frameDisplay->_skinnedMesh = nullptr;
+    frameDisplay->_skinnedMeshBuilt = false;
+    frameDisplay->_bonePalette.clear();
 
     if (this->_display && this->_displayIndex >= 0)
     {
@@ -319,9 +322,16 @@ void CCSlot::_updateFrame()
 void CCSlot::_updateMesh() 
 {
     const auto meshDisplay = static_cast<DBCCSprite*>(this->_meshDisplay);
+    cocos2d::Rect boundsRect(999999.f, 999999.f, -999999.f, -999999.f);
+    if (_updateSkinnedMesh(meshDisplay, boundsRect))
+    {
+        _updateMeshBounds(meshDisplay, boundsRect);
+        return;
+    }
+
+    meshDisplay->_bonePalette.clear();
     const auto hasFFD = !this->_ffdVertices.empty();
     const auto displayVertices = meshDisplay->getPolygonInfoModify().triangles.verts;
-    cocos2d::Rect boundsRect(999999.f, 999999.f, -999999.f, -999999.f);
 
     if (this->_meshData->skinned)
     {
@@ -421,6 +431,11 @@ void CCSlot::_updateMesh()
         }
     }
 
+    _updateMeshBounds(meshDisplay, boundsRect);
+}
+
+void CCSlot::_updateMeshBounds(DBCCSprite* meshDisplay, cocos2d::Rect& boundsRect)
+{
     boundsRect.size.width -= boundsRect.origin.x;
     boundsRect.size.height -= boundsRect.origin.y;
 
@@ -438,6 +453,109 @@ void CCSlot::_updateMesh()
     _renderDisplay->setNodeToParentTransform(transform);
 }
 
+bool CCSlot::_updateSkinnedMesh(DBCCSprite* meshDisplay, cocos2d::Rect& boundsRect)
+{
+    if (!this->_meshData->skinned || !static_cast<CCArmatureDisplay*>(this->_armature->getDisplay())->isGpuSkinning() ||
+        !meshDisplay->hasDefaultProgram())
+    {
+        return false;
+    }
+
+    // Deformed meshes keep the CPU path, the FFD offsets are per vertex and bone.
+    for (const auto value : this->_ffdVertices)
+    {
+        if (value != 0.f)
+        {
+            return false;
+        }
+    }
+
+    if (!meshDisplay->_skinnedMeshBuilt)
+    {
+        meshDisplay->_skinnedMeshBuilt = true;
+
+        const auto boneCount = this->_meshBones.size();
+        if (boneCount > cocos2d::SkinnedMesh::MAX_BONES || std::find(this->_meshBones.begin(), this->_meshBones.end(), nullptr) != this->_meshBones.end())
+        {
+            return false;
+        }
+
+        const auto& triangles = meshDisplay->getPolygonInfoModify().triangles;
+        std::vector<cocos2d::SkinnedVertex> vertices(triangles.vertCount);
+        auto& boneBounds = meshDisplay->_boneBounds;
+        boneBounds.assign(boneCount, cocos2d::Vec4(999999.f, 999999.f, -999999.f, -999999.f));
+        for (std::size_t i = 0, l = vertices.size(); i < l; ++i)
+        {
+            const auto& boneIndices = this->_meshData->boneIndices[i];
+            const auto& boneVertices = this->_meshData->boneVertices[i];
+            const auto& weights = this->_meshData->weights[i];
+            if (boneIndices.size() > cocos2d::SkinnedMesh::MAX_INFLUENCES)
+            {
+                return false;
+            }
+
+            auto& vertex = vertices[i];
+            for (std::size_t iB = 0, lB = boneIndices.size(); iB < lB; ++iB)
+            {
+                vertex.positions[iB * 2] = boneVertices[iB * 2];
+                vertex.positions[iB * 2 + 1] = boneVertices[iB * 2 + 1];
+                vertex.weights[iB] = weights[iB];
+                vertex.bones[iB] = (float)boneIndices[iB];
+
+                auto& bounds = boneBounds[boneIndices[iB]];
+                bounds.x = std::min(bounds.x, boneVertices[iB * 2]);
+                bounds.y = std::min(bounds.y, boneVertices[iB * 2 + 1]);
+                bounds.z = std::max(bounds.z, boneVertices[iB * 2]);
+                bounds.w = std::max(bounds.w, boneVertices[iB * 2 + 1]);
+            }
+
+            vertex.u = triangles.verts[i].texCoords.u;
+            vertex.v = triangles.verts[i].texCoords.v;
+        }
+
+        meshDisplay->_skinnedMesh = cocos2d::SkinnedMesh::create(vertices.data(), (uint32_t)vertices.size(), triangles.indices, (uint32_t)triangles.indexCount, (uint32_t)boneCount);
+    }
+
+    if (!meshDisplay->_skinnedMesh.get())
+    {
+        return false;
+    }
+
+    // Same transform as the CPU path, y flipped: x = a * xL + c * yL + tx, -y = -(b * xL + d * yL + ty).
+    auto& palette = meshDisplay->_bonePalette;
+    palette.resize(this->_meshBones.size() * 2);
+    for (std::size_t i = 0, l = this->_meshBones.size(); i < l; ++i)
+    {
+        const auto matrix = this->_meshBones[i]->globalTransformMatrix;
+        palette[i * 2].set(matrix->a, matrix->c, matrix->tx, 0.f);
+        palette[i * 2 + 1].set(-matrix->b, -matrix->d, -matrix->ty, 0.f);
+
+        // A vertex is a weighted average of its bones' transforms, so it lies in the union of
+        // the transformed boxes of the positions each bone moves.
+        const auto& bounds = meshDisplay->_boneBounds[i];
+        if (bounds.x > bounds.z)
+        {
+            continue;
+        }
+        const float xs[] = { bounds.x, bounds.z };
+        const float ys[] = { bounds.y, bounds.w };
+        for (const auto xL : xs)
+        {
+            for (const auto yL : ys)
+            {
+                const auto xG = matrix->a * xL + matrix->c * yL + matrix->tx;
+                const auto yG = -(matrix->b * xL + matrix->d * yL + matrix->ty);
+                boundsRect.origin.x = std::min(boundsRect.origin.x, xG);
+                boundsRect.origin.y = std::min(boundsRect.origin.y, yG);
+                boundsRect.size.width = std::max(boundsRect.size.width, xG);
+                boundsRect.size.height = std::max(boundsRect.size.height, yG);
+            }
+        }
+    }
+
+    return true;
+}
+
 void CCSlot::_updateTransform()
 {
     static cocos2d::Mat4 transform;
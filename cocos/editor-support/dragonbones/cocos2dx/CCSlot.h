@@ -5,6 +5,8 @@
 #include "cocos2d.h"
 
 DRAGONBONES_NAMESPACE_BEGIN
+class DBCCSprite;
+
 class CCSlot : public Slot
 {
     BIND_CLASS_TYPE(CCSlot);
@@ -34,6 +36,9 @@ protected:
     virtual void _updateMesh() override;
     virtual void _updateTransform() override;
 
+    bool _updateSkinnedMesh(DBCCSprite* meshDisplay, cocos2d::Rect& boundsRect);
+    void _updateMeshBounds(DBCCSprite* meshDisplay, cocos2d::Rect& boundsRect);
+
 public:
     virtual void _updateVisible() override;
     virtual void _updateBlendMode() override;
@@ -1,7 +1,7 @@
 #include "BaseObject.h"
 DRAGONBONES_NAMESPACE_BEGIN
 
-std::size_t BaseObject::_hashCode = 0;
+std::atomic<std::size_t> BaseObject::_hashCode(0);
 std::size_t BaseObject::_defaultMaxCount = 5000;
 std::unordered_map<std::size_t, std::size_t> BaseObject::_maxCountMap;
 std::unordered_map<std::size_t, std::vector<BaseObject*>> BaseObject::_poolsMap;
@@ -3,6 +3,8 @@
 
 #include "DragonBones.h"
 
+#include <atomic>
+
 #define BIND_CLASS_TYPE(CLASS) \
 public:\
 static std::size_t getTypeIndex()\
@@ -22,7 +24,8 @@ class BaseObject
 public:
     typedef std::function<void(BaseObject*,int)> RecycleOrDestroyCallback;
 private:
-    static std::size_t _hashCode;
+    // Objects are also created by parsers running on worker threads.
+    static std::atomic<std::size_t> _hashCode;
     static std::size_t _defaultMaxCount;
     static std::unordered_map<std::size_t, std::size_t> _maxCountMap;
     static std::unordered_map<std::size_t, std::vector<BaseObject*>> _poolsMap;
@@ -2,7 +2,7 @@
 
 DRAGONBONES_NAMESPACE_BEGIN
 
-JSONDataParser BaseFactory::_defaultDataParser;
+BinaryDataParser BaseFactory::_defaultDataParser;
 
 BaseFactory::BaseFactory() :
     autoSearch(false),
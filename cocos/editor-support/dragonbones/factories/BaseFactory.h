@@ -1,7 +1,7 @@
 #ifndef DRAGONBONES_BASE_FACTORY_H
 #define DRAGONBONES_BASE_FACTORY_H
 
-#include "../parsers/JSONDataParser.h"
+#include "../parsers/BinaryDataParser.h"
 #include "../armature/Armature.h"
 #include "../animation/Animation.h"
 #include "../armature/Bone.h"
@@ -37,7 +37,7 @@ private:
 class BaseFactory
 {
 protected:
-    static JSONDataParser _defaultDataParser;
+    static BinaryDataParser _defaultDataParser;
 
 public:
     bool autoSearch;
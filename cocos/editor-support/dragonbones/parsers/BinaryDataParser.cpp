@@ -0,0 +1,1279 @@
+#include "BinaryDataParser.h"
+
+#include <cstdint>
+#include <cstring>
+
+DRAGONBONES_NAMESPACE_BEGIN
+
+/**
+ * Layout: MAGIC, uint32 total size, uint32 version, then the data. Values are stored little-endian as they
+ * are in memory, strings as uint16 length and bytes, arrays as uint32 count and packed elements.
+ */
+static const std::size_t HEADER_SIZE = sizeof(BinaryDataParser::MAGIC) + sizeof(uint32_t) * 2;
+static const uint32_t NO_INDEX = 0xFFFFFFFF;
+
+class BinaryReader
+{
+public:
+    BinaryReader(const char* data, std::size_t size) :
+        _failed(false),
+        _position(0),
+        _size(size),
+        _data(data)
+    {
+    }
+
+    inline bool failed() const
+    {
+        return _failed;
+    }
+
+    inline void fail()
+    {
+        _failed = true;
+    }
+
+    template<class T>
+    T read()
+    {
+        T value = T();
+        if (_require(1, sizeof(T)))
+        {
+            std::memcpy(&value, _data + _position, sizeof(T));
+            _position += sizeof(T);
+        }
+
+        return value;
+    }
+
+    inline bool readBool()
+    {
+        return read<uint8_t>() != 0;
+    }
+
+    /**
+     * Every counted element takes at least one byte, so malformed counts cannot request huge allocations.
+     */
+    std::size_t readCount()
+    {
+        const std::size_t count = read<uint32_t>();
+        return _require(count, 1) ? count : 0;
+    }
+
+    std::string readString()
+    {
+        const std::size_t length = read<uint16_t>();
+        if (!_require(length, 1))
+        {
+            return "";
+        }
+
+        const std::string value(_data + _position, length);
+        _position += length;
+
+        return value;
+    }
+
+    template<class T>
+    void readArray(std::vector<T>& values)
+    {
+        const std::size_t count = read<uint32_t>();
+        if (!_require(count, sizeof(T)))
+        {
+            values.clear();
+            return;
+        }
+
+        values.resize(count);
+        if (count > 0)
+        {
+            std::memcpy(values.data(), _data + _position, count * sizeof(T));
+            _position += count * sizeof(T);
+        }
+    }
+
+    void readTransform(Transform& value, float scale)
+    {
+        value.x = read<float>() * scale;
+        value.y = read<float>() * scale;
+        value.skewX = read<float>();
+        value.skewY = read<float>();
+        value.scaleX = read<float>();
+        value.scaleY = read<float>();
+    }
+
+    void readMatrix(Matrix& value, float scale)
+    {
+        value.a = read<float>();
+        value.b = read<float>();
+        value.c = read<float>();
+        value.d = read<float>();
+        value.tx = read<float>() * scale;
+        value.ty = read<float>() * scale;
+    }
+
+private:
+    bool _require(std::size_t count, std::size_t elementSize)
+    {
+        if (_failed || count > (_size - _position) / elementSize)
+        {
+            _failed = true;
+            return false;
+        }
+
+        return true;
+    }
+
+    bool _failed;
+    std::size_t _position;
+    std::size_t _size;
+    const char* _data;
+};
+
+class BinaryWriter
+{
+public:
+    explicit BinaryWriter(std::vector<char>& output) :
+        _failed(false),
+        _output(output)
+    {
+    }
+
+    inline bool failed() const
+    {
+        return _failed;
+    }
+
+    template<class T>
+    void write(T value)
+    {
+        const auto bytes = reinterpret_cast<const char*>(&value);
+        _output.insert(_output.end(), bytes, bytes + sizeof(T));
+    }
+
+    inline void writeBool(bool value)
+    {
+        write<uint8_t>(value ? 1 : 0);
+    }
+
+    void writeString(const std::string& value)
+    {
+        if (value.size() > 0xFFFF)
+        {
+            _failed = true;
+        }
+
+        const auto length = std::min(value.size(), (std::size_t)0xFFFF);
+        write<uint16_t>((uint16_t)length);
+        _output.insert(_output.end(), value.data(), value.data() + length);
+    }
+
+    template<class T>
+    void writeArray(const std::vector<T>& values)
+    {
+        write<uint32_t>((uint32_t)values.size());
+        if (!values.empty())
+        {
+            const auto bytes = reinterpret_cast<const char*>(values.data());
+            _output.insert(_output.end(), bytes, bytes + values.size() * sizeof(T));
+        }
+    }
+
+    void writeTransform(const Transform& value)
+    {
+        write<float>(value.x);
+        write<float>(value.y);
+        write<float>(value.skewX);
+        write<float>(value.skewY);
+        write<float>(value.scaleX);
+        write<float>(value.scaleY);
+    }
+
+    void writeMatrix(const Matrix& value)
+    {
+        write<float>(value.a);
+        write<float>(value.b);
+        write<float>(value.c);
+        write<float>(value.d);
+        write<float>(value.tx);
+        write<float>(value.ty);
+    }
+
+private:
+    bool _failed;
+    std::vector<char>& _output;
+};
+
+static void _writeActionData(BinaryWriter& writer, const std::vector<ActionData*>& actions)
+{
+    writer.write<uint32_t>((uint32_t)actions.size());
+    for (const auto action : actions)
+    {
+        writer.write<int32_t>((int)action->type);
+        writer.writeString(action->bone ? action->bone->name : "");
+        writer.writeString(action->slot ? action->slot->name : "");
+        writer.writeArray(std::get<0>(action->data));
+        writer.writeArray(std::get<1>(action->data));
+
+        const auto& strings = std::get<2>(action->data);
+        writer.write<uint32_t>((uint32_t)strings.size());
+        for (const auto& value : strings)
+        {
+            writer.writeString(value);
+        }
+    }
+}
+
+static void _writeEventData(BinaryWriter& writer, const std::vector<EventData*>& events)
+{
+    writer.write<uint32_t>((uint32_t)events.size());
+    for (const auto event : events)
+    {
+        writer.write<int32_t>((int)event->type);
+        writer.writeString(event->name);
+        writer.writeString(event->bone ? event->bone->name : "");
+        writer.writeString(event->slot ? event->slot->name : "");
+    }
+}
+
+static void _writeColor(BinaryWriter& writer, const ColorTransform* color, const ColorTransform* defaultColor)
+{
+    const auto isCustom = color && color != defaultColor;
+    writer.writeBool(isCustom);
+    if (isCustom)
+    {
+        writer.write<float>(color->alphaMultiplier);
+        writer.write<float>(color->redMultiplier);
+        writer.write<float>(color->greenMultiplier);
+        writer.write<float>(color->blueMultiplier);
+        writer.write<int32_t>(color->alphaOffset);
+        writer.write<int32_t>(color->redOffset);
+        writer.write<int32_t>(color->greenOffset);
+        writer.write<int32_t>(color->blueOffset);
+    }
+}
+
+template<class T>
+static void _writeFrame(BinaryWriter& writer, const FrameData<T>& frame)
+{
+    writer.write<float>(frame.position);
+    writer.write<float>(frame.duration);
+    _writeActionData(writer, frame.actions);
+    _writeEventData(writer, frame.events);
+}
+
+template<class T>
+static void _writeTweenFrame(BinaryWriter& writer, const TweenFrameData<T>& frame)
+{
+    _writeFrame(writer, frame);
+    writer.write<float>(frame.tweenEasing);
+    writer.writeArray(frame.curve);
+}
+
+static void _writeAnimationFrame(BinaryWriter& writer, const AnimationFrameData& frame)
+{
+    _writeFrame(writer, frame);
+}
+
+static void _writeBoneFrame(BinaryWriter& writer, const BoneFrameData& frame)
+{
+    _writeTweenFrame(writer, frame);
+    writer.writeBool(frame.tweenScale);
+    writer.write<int32_t>(frame.tweenRotate);
+    writer.writeString(frame.parent ? frame.parent->name : "");
+    writer.writeTransform(frame.transform);
+}
+
+static void _writeSlotFrame(BinaryWriter& writer, const SlotFrameData& frame)
+{
+    _writeTweenFrame(writer, frame);
+    writer.write<int32_t>(frame.displayIndex);
+    writer.write<int32_t>(frame.zOrder);
+    _writeColor(writer, frame.color, &SlotFrameData::DEFAULT_COLOR);
+}
+
+static void _writeFFDFrame(BinaryWriter& writer, const ExtensionFrameData& frame)
+{
+    _writeTweenFrame(writer, frame);
+    writer.write<int32_t>((int)frame.type);
+    writer.writeArray(frame.tweens);
+    writer.writeArray(frame.keys);
+}
+
+template<class T>
+static void _writeTimeline(BinaryWriter& writer, const TimelineData<T>& timeline, void (*frameWriter)(BinaryWriter&, const T&))
+{
+    writer.write<float>(timeline.scale);
+    writer.write<float>(timeline.offset);
+
+    // The frame list repeats a frame for every frame index it spans, only distinct frames are stored.
+    std::vector<const T*> frames;
+    std::unordered_map<const T*, uint32_t> frameIndices;
+    std::vector<uint32_t> indices;
+    indices.reserve(timeline.frames.size());
+    for (const auto frame : timeline.frames)
+    {
+        if (!frame)
+        {
+            indices.push_back(NO_INDEX);
+            continue;
+        }
+
+        const auto iterator = frameIndices.find(frame);
+        if (iterator != frameIndices.end())
+        {
+            indices.push_back(iterator->second);
+        }
+        else
+        {
+            frameIndices[frame] = (uint32_t)frames.size();
+            indices.push_back((uint32_t)frames.size());
+            frames.push_back(frame);
+        }
+    }
+
+    std::vector<int32_t> links;
+    links.reserve(frames.size() * 2);
+    writer.write<uint32_t>((uint32_t)frames.size());
+    for (const auto frame : frames)
+    {
+        frameWriter(writer, *frame);
+
+        const auto prev = frameIndices.find(frame->prev);
+        const auto next = frameIndices.find(frame->next);
+        links.push_back(prev != frameIndices.end() ? (int32_t)prev->second : -1);
+        links.push_back(next != frameIndices.end() ? (int32_t)next->second : -1);
+    }
+
+    writer.writeArray(indices);
+    writer.writeArray(links);
+}
+
+static void _writeMesh(BinaryWriter& writer, const MeshData& mesh)
+{
+    writer.writeBool(mesh.skinned);
+    writer.writeMatrix(mesh.slotPose);
+    writer.writeArray(mesh.uvs);
+    writer.writeArray(mesh.vertices);
+    writer.writeArray(mesh.vertexIndices);
+
+    if (mesh.skinned)
+    {
+        // Per vertex influence counts, then the influences of all vertices packed back to back.
+        std::vector<uint16_t> counts;
+        std::vector<uint16_t> boneIndices;
+        std::vector<float> weights;
+        std::vector<float> boneVertices;
+        counts.reserve(mesh.boneIndices.size());
+        for (std::size_t i = 0, l = mesh.boneIndices.size(); i < l; ++i)
+        {
+            counts.push_back((uint16_t)mesh.boneIndices[i].size());
+            boneIndices.insert(boneIndices.end(), mesh.boneIndices[i].begin(), mesh.boneIndices[i].end());
+            weights.insert(weights.end(), mesh.weights[i].begin(), mesh.weights[i].end());
+            boneVertices.insert(boneVertices.end(), mesh.boneVertices[i].begin(), mesh.boneVertices[i].end());
+        }
+
+        writer.writeArray(counts);
+        writer.writeArray(boneIndices);
+        writer.writeArray(weights);
+        writer.writeArray(boneVertices);
+
+        writer.write<uint32_t>((uint32_t)mesh.bones.size());
+        for (std::size_t i = 0, l = mesh.bones.size(); i < l; ++i)
+        {
+            writer.writeString(mesh.bones[i]->name);
+            writer.writeMatrix(mesh.inverseBindPose[i]);
+        }
+    }
+}
+
+static void _writeDisplay(BinaryWriter& writer, const DisplayData& display)
+{
+    writer.writeString(display.name);
+    writer.write<int32_t>((int)display.type);
+    writer.writeBool(display.isRelativePivot);
+    writer.write<float>(display.pivot.x);
+    writer.write<float>(display.pivot.y);
+    writer.writeTransform(display.transform);
+
+    writer.writeBool(display.mesh != nullptr);
+    if (display.mesh)
+    {
+        _writeMesh(writer, *display.mesh);
+    }
+}
+
+static void _writeAnimation(BinaryWriter& writer, const AnimationData& animation)
+{
+    writer.writeString(animation.name);
+    writer.writeString(animation.animation ? animation.animation->name : "");
+    writer.write<uint32_t>(animation.frameCount);
+    writer.write<uint32_t>(animation.playTimes);
+    writer.write<float>(animation.position);
+    writer.write<float>(animation.duration);
+    writer.write<float>(animation.fadeInTime);
+    writer.writeBool(animation.hasAsynchronyTimeline);
+
+    if (animation.animation)
+    {
+        return;
+    }
+
+    _writeTimeline<AnimationFrameData>(writer, animation, _writeAnimationFrame);
+
+    writer.write<uint32_t>((uint32_t)animation.boneTimelines.size());
+    for (const auto& pair : animation.boneTimelines)
+    {
+        const auto timeline = pair.second;
+        writer.writeString(timeline->bone->name);
+        writer.writeTransform(timeline->originTransform);
+        _writeTimeline<BoneFrameData>(writer, *timeline, _writeBoneFrame);
+    }
+
+    writer.write<uint32_t>((uint32_t)animation.slotTimelines.size());
+    for (const auto& pair : animation.slotTimelines)
+    {
+        const auto timeline = pair.second;
+        writer.writeString(timeline->slot->name);
+        _writeTimeline<SlotFrameData>(writer, *timeline, _writeSlotFrame);
+    }
+
+    std::vector<const FFDTimelineData*> ffdTimelines;
+    for (const auto& skinPair : animation.ffdTimelines)
+    {
+        for (const auto& slotPair : skinPair.second)
+        {
+            for (const auto& displayPair : slotPair.second)
+            {
+                ffdTimelines.push_back(displayPair.second);
+            }
+        }
+    }
+
+    writer.write<uint32_t>((uint32_t)ffdTimelines.size());
+    for (const auto timeline : ffdTimelines)
+    {
+        writer.writeString(timeline->skin->name);
+        writer.writeString(timeline->slot->slot->name);
+        writer.write<uint32_t>((uint32_t)timeline->displayIndex);
+        _writeTimeline<ExtensionFrameData>(writer, *timeline, _writeFFDFrame);
+    }
+}
+
+static void _writeArmature(BinaryWriter& writer, ArmatureData& armature)
+{
+    writer.writeString(armature.name);
+    writer.write<uint32_t>(armature.frameRate);
+    writer.write<int32_t>((int)armature.type);
+    writer.write<float>(armature.scale);
+    writer.write<float>(armature.aabb.x);
+    writer.write<float>(armature.aabb.y);
+    writer.write<float>(armature.aabb.width);
+    writer.write<float>(armature.aabb.height);
+
+    // Sorted bones put parents first, so every parent exists when a bone is added back.
+    const auto& bones = armature.getSortedBones();
+    writer.write<uint32_t>((uint32_t)bones.size());
+    for (const auto bone : bones)
+    {
+        writer.writeString(bone->name);
+        writer.writeString(bone->parent ? bone->parent->name : "");
+        writer.writeString(bone->ik ? bone->ik->name : "");
+        writer.writeBool(bone->inheritTranslation);
+        writer.writeBool(bone->inheritRotation);
+        writer.writeBool(bone->inheritScale);
+        writer.writeBool(bone->bendPositive);
+        writer.write<uint32_t>(bone->chain);
+        writer.write<int32_t>(bone->chainIndex);
+        writer.write<float>(bone->weight);
+        writer.write<float>(bone->length);
+        writer.writeTransform(bone->transform);
+    }
+
+    const auto& slots = armature.getSortedSlots();
+    writer.write<uint32_t>((uint32_t)slots.size());
+    for (const auto slot : slots)
+    {
+        writer.writeString(slot->name);
+        writer.writeString(slot->parent ? slot->parent->name : "");
+        writer.write<int32_t>(slot->displayIndex);
+        writer.write<int32_t>(slot->zOrder);
+        writer.write<int32_t>((int)slot->blendMode);
+        _writeColor(writer, slot->color, &SlotData::DEFAULT_COLOR);
+        _writeActionData(writer, slot->actions);
+    }
+
+    // Defaults go first, the first skin and animation added back become the defaults again.
+    std::vector<SkinData*> skins;
+    if (armature.getDefaultSkin())
+    {
+        skins.push_back(armature.getDefaultSkin());
+    }
+
+    for (const auto& pair : armature.skins)
+    {
+        if (pair.second != armature.getDefaultSkin())
+        {
+            skins.push_back(pair.second);
+        }
+    }
+
+    writer.write<uint32_t>((uint32_t)skins.size());
+    for (const auto skin : skins)
+    {
+        writer.writeString(skin->name);
+        writer.write<uint32_t>((uint32_t)skin->slots.size());
+        for (const auto& pair : skin->slots)
+        {
+            writer.writeString(pair.second->slot->name);
+            writer.write<uint32_t>((uint32_t)pair.second->displays.size());
+            for (const auto display : pair.second->displays)
+            {
+                _writeDisplay(writer, *display);
+            }
+        }
+    }
+
+    std::vector<AnimationData*> animations;
+    if (armature.getDefaultAnimation())
+    {
+        animations.push_back(armature.getDefaultAnimation());
+    }
+
+    for (const auto& pair : armature.animations)
+    {
+        if (pair.second != armature.getDefaultAnimation())
+        {
+            animations.push_back(pair.second);
+        }
+    }
+
+    writer.write<uint32_t>((uint32_t)animations.size());
+    for (const auto animation : animations)
+    {
+        _writeAnimation(writer, *animation);
+    }
+
+    _writeActionData(writer, armature.actions);
+}
+
+const char BinaryDataParser::MAGIC[4] = { 'D', 'B', 'B', 'F' };
+const unsigned BinaryDataParser::VERSION = 1;
+
+bool BinaryDataParser::isBinaryData(const char* rawData, std::size_t size)
+{
+    return rawData && size >= HEADER_SIZE && std::memcmp(rawData, MAGIC, sizeof(MAGIC)) == 0;
+}
+
+bool BinaryDataParser::writeDragonBonesData(DragonBonesData& data, std::vector<char>& output)
+{
+    const auto start = output.size();
+
+    BinaryWriter writer(output);
+    for (const auto value : MAGIC)
+    {
+        writer.write<char>(value);
+    }
+
+    writer.write<uint32_t>(0); // Size, patched below.
+    writer.write<uint32_t>(VERSION);
+    writer.writeString(data.name);
+    writer.write<uint32_t>(data.frameRate);
+
+    const auto& armatureNames = data.getArmatureNames();
+    writer.write<uint32_t>((uint32_t)armatureNames.size());
+    for (const auto& armatureName : armatureNames)
+    {
+        _writeArmature(writer, *data.getArmature(armatureName));
+    }
+
+    const auto size = output.size() - start;
+    if (writer.failed() || size > NO_INDEX)
+    {
+        output.resize(start);
+        return false;
+    }
+
+    const auto sizeValue = (uint32_t)size;
+    std::memcpy(output.data() + start + sizeof(MAGIC), &sizeValue, sizeof(sizeValue));
+
+    return true;
+}
+
+BinaryDataParser::BinaryDataParser() :
+    _scaleRatio(1.f)
+{
+}
+BinaryDataParser::~BinaryDataParser() {}
+
+template<class T>
+void BinaryDataParser::_readFrame(BinaryReader& reader, FrameData<T>& frame) const
+{
+    frame.position = reader.read<float>();
+    frame.duration = reader.read<float>();
+    _readActionData(reader, frame.actions);
+    _readEventData(reader, frame.events);
+}
+
+template<class T>
+void BinaryDataParser::_readTweenFrame(BinaryReader& reader, TweenFrameData<T>& frame) const
+{
+    _readFrame(reader, frame);
+    frame.tweenEasing = reader.read<float>();
+    reader.readArray(frame.curve);
+}
+
+template<class T>
+bool BinaryDataParser::_readTimeline(BinaryReader& reader, TimelineData<T>& timeline, const std::function<T*(BinaryReader& reader)>& frameReader) const
+{
+    timeline.scale = reader.read<float>();
+    timeline.offset = reader.read<float>();
+
+    // Distinct frames are owned by the timeline straight away, so a failed read can still be disposed.
+    const auto frameCount = reader.readCount();
+    timeline.frames.reserve(frameCount);
+    for (std::size_t i = 0; i < frameCount && !reader.failed(); ++i)
+    {
+        timeline.frames.push_back(frameReader(reader));
+    }
+
+    std::vector<uint32_t> indices;
+    std::vector<int32_t> links;
+    reader.readArray(indices);
+    reader.readArray(links);
+
+    if (
+        reader.failed() ||
+        links.size() != frameCount * 2 ||
+        (indices.size() > 1 && indices.size() != this->_animation->frameCount + 1)
+    )
+    {
+        reader.fail();
+        return false;
+    }
+
+    const std::vector<T*> frames(timeline.frames);
+    std::vector<bool> referenced(frameCount, false);
+    for (const auto index : indices)
+    {
+        if (index >= frameCount)
+        {
+            reader.fail();
+            return false;
+        }
+
+        referenced[index] = true;
+    }
+
+    for (std::size_t i = 0; i < frameCount; ++i)
+    {
+        const auto prev = links[i * 2];
+        const auto next = links[i * 2 + 1];
+        if (!referenced[i] || prev >= (int)frameCount || next >= (int)frameCount)
+        {
+            reader.fail();
+            return false;
+        }
+
+        frames[i]->prev = prev < 0 ? nullptr : frames[prev];
+        frames[i]->next = next < 0 ? nullptr : frames[next];
+    }
+
+    timeline.frames.clear();
+    timeline.frames.reserve(indices.size());
+    for (const auto index : indices)
+    {
+        timeline.frames.push_back(frames[index]);
+    }
+
+    return true;
+}
+
+bool BinaryDataParser::_readArmature(BinaryReader& reader, ArmatureData& armature, float scale)
+{
+    armature.frameRate = reader.read<uint32_t>();
+    armature.type = (ArmatureType)reader.read<int32_t>();
+    armature.scale = scale;
+
+    // Lengths and translations were baked with the scale of the conversion, rescale them to the requested one.
+    const auto dataScale = reader.read<float>();
+    this->_scaleRatio = dataScale > 0.f ? scale / dataScale : 1.f;
+
+    armature.aabb.x = reader.read<float>();
+    armature.aabb.y = reader.read<float>();
+    armature.aabb.width = reader.read<float>();
+    armature.aabb.height = reader.read<float>();
+
+    if (armature.frameRate == 0)
+    {
+        armature.frameRate = this->_data->frameRate;
+    }
+
+    this->_armature = &armature;
+
+    std::vector<std::pair<BoneData*, std::string>> iks;
+    const auto boneCount = reader.readCount();
+    for (std::size_t i = 0; i < boneCount && !reader.failed(); ++i)
+    {
+        _readBone(reader, iks);
+    }
+
+    for (const auto& pair : iks)
+    {
+        pair.first->ik = armature.getBone(pair.second);
+        if (!pair.first->ik)
+        {
+            reader.fail();
+        }
+    }
+
+    const auto slotCount = reader.readCount();
+    for (std::size_t i = 0; i < slotCount && !reader.failed(); ++i)
+    {
+        _readSlot(reader);
+    }
+
+    const auto skinCount = reader.readCount();
+    for (std::size_t i = 0; i < skinCount && !reader.failed(); ++i)
+    {
+        _readSkin(reader);
+    }
+
+    std::vector<std::pair<AnimationData*, std::string>> aliases;
+    const auto animationCount = reader.readCount();
+    for (std::size_t i = 0; i < animationCount && !reader.failed(); ++i)
+    {
+        _readAnimation(reader, aliases);
+    }
+
+    for (const auto& pair : aliases)
+    {
+        pair.first->animation = armature.getAnimation(pair.second);
+    }
+
+    if (!reader.failed())
+    {
+        _readActionData(reader, armature.actions);
+    }
+
+    this->_armature = nullptr;
+
+    return !reader.failed();
+}
+
+bool BinaryDataParser::_readBone(BinaryReader& reader, std::vector<std::pair<BoneData*, std::string>>& iks)
+{
+    const auto name = reader.readString();
+    const auto parentName = reader.readString();
+    const auto ikName = reader.readString();
+    if (reader.failed() || name.empty() || this->_armature->getBone(name))
+    {
+        reader.fail();
+        return false;
+    }
+
+    const auto bone = _createObject<BoneData>();
+    bone->name = name;
+    bone->inheritTranslation = reader.readBool();
+    bone->inheritRotation = reader.readBool();
+    bone->inheritScale = reader.readBool();
+    bone->bendPositive = reader.readBool();
+    bone->chain = reader.read<uint32_t>();
+    bone->chainIndex = reader.read<int32_t>();
+    bone->weight = reader.read<float>();
+    bone->length = reader.read<float>() * this->_scaleRatio;
+    reader.readTransform(bone->transform, this->_scaleRatio);
+
+    this->_armature->addBone(bone, parentName);
+
+    if (!parentName.empty() && !bone->parent)
+    {
+        reader.fail();
+    }
+
+    if (!ikName.empty())
+    {
+        iks.push_back(std::make_pair(bone, ikName));
+    }
+
+    return !reader.failed();
+}
+
+bool BinaryDataParser::_readSlot(BinaryReader& reader)
+{
+    const auto name = reader.readString();
+    if (reader.failed() || name.empty() || this->_armature->getSlot(name))
+    {
+        reader.fail();
+        return false;
+    }
+
+    const auto slot = _createObject<SlotData>();
+    slot->name = name;
+    slot->parent = this->_armature->getBone(reader.readString());
+    slot->displayIndex = reader.read<int32_t>();
+    slot->zOrder = reader.read<int32_t>();
+    slot->blendMode = (BlendMode)reader.read<int32_t>();
+
+    if (reader.readBool())
+    {
+        slot->color = SlotData::generateColor();
+        _readColorTransform(reader, *slot->color);
+    }
+    else
+    {
+        slot->color = &SlotData::DEFAULT_COLOR;
+    }
+
+    this->_armature->addSlot(slot);
+
+    _readActionData(reader, slot->actions);
+
+    return !reader.failed();
+}
+
+bool BinaryDataParser::_readSkin(BinaryReader& reader)
+{
+    const auto name = reader.readString();
+    if (reader.failed() || name.empty() || this->_armature->skins.find(name) != this->_armature->skins.end())
+    {
+        reader.fail();
+        return false;
+    }
+
+    const auto skin = _createObject<SkinData>();
+    skin->name = name;
+    this->_armature->addSkin(skin);
+
+    for (std::size_t i = 0, l = reader.readCount(); i < l && !reader.failed(); ++i)
+    {
+        const auto slot = this->_armature->getSlot(reader.readString());
+        if (!slot || skin->getSlot(slot->name))
+        {
+            reader.fail();
+            break;
+        }
+
+        const auto slotDisplayDataSet = _createObject<SlotDisplayDataSet>();
+        slotDisplayDataSet->slot = slot;
+        skin->addSlot(slotDisplayDataSet);
+
+        const auto displayCount = reader.readCount();
+        slotDisplayDataSet->displays.reserve(displayCount);
+        for (std::size_t iD = 0; iD < displayCount && !reader.failed(); ++iD)
+        {
+            const auto display = _createObject<DisplayData>();
+            slotDisplayDataSet->displays.push_back(display);
+            _readDisplay(reader, *display);
+        }
+    }
+
+    return !reader.failed();
+}
+
+bool BinaryDataParser::_readDisplay(BinaryReader& reader, DisplayData& display)
+{
+    display.name = reader.readString();
+    display.type = (DisplayType)reader.read<int32_t>();
+    display.isRelativePivot = reader.readBool();
+    display.pivot.x = reader.read<float>();
+    display.pivot.y = reader.read<float>();
+    reader.readTransform(display.transform, this->_scaleRatio);
+
+    if (!display.isRelativePivot)
+    {
+        display.pivot.x *= this->_scaleRatio;
+        display.pivot.y *= this->_scaleRatio;
+    }
+
+    if (reader.readBool())
+    {
+        display.mesh = _createObject<MeshData>();
+        _readMesh(reader, *display.mesh);
+    }
+
+    return !reader.failed();
+}
+
+bool BinaryDataParser::_readMesh(BinaryReader& reader, MeshData& mesh)
+{
+    mesh.skinned = reader.readBool();
+    reader.readMatrix(mesh.slotPose, this->_scaleRatio);
+    reader.readArray(mesh.uvs);
+    reader.readArray(mesh.vertices);
+    reader.readArray(mesh.vertexIndices);
+
+    if (this->_scaleRatio != 1.f)
+    {
+        for (auto& value : mesh.vertices)
+        {
+            value *= this->_scaleRatio;
+        }
+    }
+
+    if (!mesh.skinned)
+    {
+        return !reader.failed();
+    }
+
+    std::vector<uint16_t> counts;
+    std::vector<uint16_t> boneIndices;
+    std::vector<float> weights;
+    std::vector<float> boneVertices;
+    reader.readArray(counts);
+    reader.readArray(boneIndices);
+    reader.readArray(weights);
+    reader.readArray(boneVertices);
+
+    std::size_t influenceCount = 0;
+    for (const auto count : counts)
+    {
+        influenceCount += count;
+    }
+
+    if (reader.failed() || boneIndices.size() != influenceCount || weights.size() != influenceCount || boneVertices.size() != influenceCount * 2)
+    {
+        reader.fail();
+        return false;
+    }
+
+    mesh.boneIndices.resize(counts.size());
+    mesh.weights.resize(counts.size());
+    mesh.boneVertices.resize(counts.size());
+    for (std::size_t i = 0, iI = 0, l = counts.size(); i < l; ++i)
+    {
+        const auto count = counts[i];
+        mesh.boneIndices[i].assign(boneIndices.begin() + iI, boneIndices.begin() + iI + count);
+        mesh.weights[i].assign(weights.begin() + iI, weights.begin() + iI + count);
+        mesh.boneVertices[i].assign(boneVertices.begin() + iI * 2, boneVertices.begin() + (iI + count) * 2);
+        iI += count;
+
+        if (this->_scaleRatio != 1.f)
+        {
+            for (auto& value : mesh.boneVertices[i])
+            {
+                value *= this->_scaleRatio;
+            }
+        }
+    }
+
+    const auto boneCount = reader.readCount();
+    mesh.bones.reserve(boneCount);
+    mesh.inverseBindPose.resize(boneCount);
+    for (std::size_t i = 0; i < boneCount && !reader.failed(); ++i)
+    {
+        const auto bone = this->_armature->getBone(reader.readString());
+        if (!bone)
+        {
+            reader.fail();
+            break;
+        }
+
+        mesh.bones.push_back(bone);
+        reader.readMatrix(mesh.inverseBindPose[i], this->_scaleRatio);
+    }
+
+    for (const auto& indices : mesh.boneIndices)
+    {
+        for (const auto index : indices)
+        {
+            if (index >= mesh.bones.size())
+            {
+                reader.fail();
+                return false;
+            }
+        }
+    }
+
+    return !reader.failed();
+}
+
+bool BinaryDataParser::_readAnimation(BinaryReader& reader, std::vector<std::pair<AnimationData*, std::string>>& aliases)
+{
+    const auto name = reader.readString();
+    if (reader.failed() || name.empty() || this->_armature->animations.find(name) != this->_armature->animations.end())
+    {
+        reader.fail();
+        return false;
+    }
+
+    const auto animation = _createObject<AnimationData>();
+    animation->name = name;
+    this->_armature->addAnimation(animation);
+
+    const auto aliasName = reader.readString();
+    animation->frameCount = std::max(reader.read<uint32_t>(), (uint32_t)1);
+    animation->playTimes = reader.read<uint32_t>();
+    animation->position = reader.read<float>();
+    animation->duration = reader.read<float>();
+    animation->fadeInTime = reader.read<float>();
+    animation->hasAsynchronyTimeline = reader.readBool();
+
+    if (!aliasName.empty())
+    {
+        aliases.push_back(std::make_pair(animation, aliasName));
+
+        return !reader.failed();
+    }
+
+    this->_animation = animation;
+
+    _readTimeline<AnimationFrameData>(reader, *animation, std::bind(&BinaryDataParser::_readAnimationFrame, this, std::placeholders::_1));
+
+    for (std::size_t i = 0, l = reader.readCount(); i < l && !reader.failed(); ++i)
+    {
+        const auto bone = this->_armature->getBone(reader.readString());
+        if (!bone || animation->getBoneTimeline(bone->name))
+        {
+            reader.fail();
+            break;
+        }
+
+        const auto timeline = _createObject<BoneTimelineData>();
+        timeline->bone = bone;
+        animation->addBoneTimeline(timeline);
+        reader.readTransform(timeline->originTransform, this->_scaleRatio);
+        _readTimeline<BoneFrameData>(reader, *timeline, std::bind(&BinaryDataParser::_readBoneFrame, this, std::placeholders::_1));
+    }
+
+    for (std::size_t i = 0, l = reader.readCount(); i < l && !reader.failed(); ++i)
+    {
+        const auto slot = this->_armature->getSlot(reader.readString());
+        if (!slot || animation->getSlotTimeline(slot->name))
+        {
+            reader.fail();
+            break;
+        }
+
+        const auto timeline = _createObject<SlotTimelineData>();
+        timeline->slot = slot;
+        animation->addSlotTimeline(timeline);
+        _readTimeline<SlotFrameData>(reader, *timeline, std::bind(&BinaryDataParser::_readSlotFrame, this, std::placeholders::_1));
+    }
+
+    for (std::size_t i = 0, l = reader.readCount(); i < l && !reader.failed(); ++i)
+    {
+        const auto skin = this->_armature->getSkin(reader.readString());
+        const auto slotName = reader.readString();
+        const auto displayIndex = reader.read<uint32_t>();
+        const auto slotDisplayDataSet = skin ? skin->getSlot(slotName) : nullptr;
+        if (
+            reader.failed() ||
+            !slotDisplayDataSet ||
+            displayIndex >= slotDisplayDataSet->displays.size() ||
+            animation->getFFDTimeline(skin->name, slotName, displayIndex)
+        )
+        {
+            reader.fail();
+            break;
+        }
+
+        const auto timeline = _createObject<FFDTimelineData>();
+        timeline->skin = skin;
+        timeline->slot = slotDisplayDataSet;
+        timeline->displayIndex = displayIndex;
+        animation->addFFDTimeline(timeline);
+        _readTimeline<ExtensionFrameData>(reader, *timeline, std::bind(&BinaryDataParser::_readFFDFrame, this, std::placeholders::_1));
+    }
+
+    this->_animation = nullptr;
+
+    return !reader.failed();
+}
+
+AnimationFrameData* BinaryDataParser::_readAnimationFrame(BinaryReader& reader) const
+{
+    const auto frame = _createObject<AnimationFrameData>();
+    _readFrame(reader, *frame);
+
+    return frame;
+}
+
+BoneFrameData* BinaryDataParser::_readBoneFrame(BinaryReader& reader) const
+{
+    const auto frame = _createObject<BoneFrameData>();
+    _readTweenFrame(reader, *frame);
+    frame->tweenScale = reader.readBool();
+    frame->tweenRotate = reader.read<int32_t>();
+    frame->parent = this->_armature->getBone(reader.readString());
+    reader.readTransform(frame->transform, this->_scaleRatio);
+
+    return frame;
+}
+
+SlotFrameData* BinaryDataParser::_readSlotFrame(BinaryReader& reader) const
+{
+    const auto frame = _createObject<SlotFrameData>();
+    _readTweenFrame(reader, *frame);
+    frame->displayIndex = reader.read<int32_t>();
+    frame->zOrder = reader.read<int32_t>();
+
+    if (reader.readBool())
+    {
+        frame->color = SlotFrameData::generateColor();
+        _readColorTransform(reader, *frame->color);
+    }
+    else
+    {
+        frame->color = &SlotFrameData::DEFAULT_COLOR;
+    }
+
+    return frame;
+}
+
+ExtensionFrameData* BinaryDataParser::_readFFDFrame(BinaryReader& reader) const
+{
+    const auto frame = _createObject<ExtensionFrameData>();
+    _readTweenFrame(reader, *frame);
+    frame->type = (ExtensionType)reader.read<int32_t>();
+    reader.readArray(frame->tweens);
+    reader.readArray(frame->keys);
+
+    if (frame->type == ExtensionType::FFD && this->_scaleRatio != 1.f)
+    {
+        for (auto& value : frame->tweens)
+        {
+            value *= this->_scaleRatio;
+        }
+    }
+
+    return frame;
+}
+
+void BinaryDataParser::_readActionData(BinaryReader& reader, std::vector<ActionData*>& actions) const
+{
+    const auto count = reader.readCount();
+    actions.reserve(actions.size() + count);
+    for (std::size_t i = 0; i < count && !reader.failed(); ++i)
+    {
+        const auto actionData = _createObject<ActionData>();
+        actions.push_back(actionData);
+
+        actionData->type = (ActionType)reader.read<int32_t>();
+        actionData->bone = this->_armature->getBone(reader.readString());
+        actionData->slot = this->_armature->getSlot(reader.readString());
+        reader.readArray(std::get<0>(actionData->data));
+        reader.readArray(std::get<1>(actionData->data));
+
+        auto& strings = std::get<2>(actionData->data);
+        const auto stringCount = reader.readCount();
+        strings.reserve(stringCount);
+        for (std::size_t iS = 0; iS < stringCount && !reader.failed(); ++iS)
+        {
+            strings.push_back(reader.readString());
+        }
+    }
+}
+
+void BinaryDataParser::_readEventData(BinaryReader& reader, std::vector<EventData*>& events) const
+{
+    const auto count = reader.readCount();
+    events.reserve(events.size() + count);
+    for (std::size_t i = 0; i < count && !reader.failed(); ++i)
+    {
+        const auto eventData = _createObject<EventData>();
+        events.push_back(eventData);
+
+        eventData->type = (EventType)reader.read<int32_t>();
+        eventData->name = reader.readString();
+        eventData->bone = this->_armature->getBone(reader.readString());
+        eventData->slot = this->_armature->getSlot(reader.readString());
+    }
+}
+
+void BinaryDataParser::_readColorTransform(BinaryReader& reader, ColorTransform& color) const
+{
+    color.alphaMultiplier = reader.read<float>();
+    color.redMultiplier = reader.read<float>();
+    color.greenMultiplier = reader.read<float>();
+    color.blueMultiplier = reader.read<float>();
+    color.alphaOffset = reader.read<int32_t>();
+    color.redOffset = reader.read<int32_t>();
+    color.greenOffset = reader.read<int32_t>();
+    color.blueOffset = reader.read<int32_t>();
+}
+
+DragonBonesData* BinaryDataParser::parseDragonBonesData(const char* rawData, float scale)
+{
+    // Text data cannot start with the magic, strncmp stops at the end of a shorter string.
+    if (rawData && std::strncmp(rawData, MAGIC, sizeof(MAGIC)) == 0)
+    {
+        uint32_t size = 0;
+        std::memcpy(&size, rawData + sizeof(MAGIC), sizeof(size));
+
+        return parseDragonBonesData(rawData, size, scale);
+    }
+
+    return JSONDataParser::parseDragonBonesData(rawData, scale);
+}
+
+DragonBonesData* BinaryDataParser::parseDragonBonesData(const char* rawData, std::size_t size, float scale)
+{
+    auto complete = false;
+    const auto data = parseDragonBonesData(rawData, size, scale, complete);
+    if (data && !complete)
+    {
+        DRAGONBONES_ASSERT(false, "Data error.");
+        data->returnToPool();
+
+        return nullptr;
+    }
+
+    return data;
+}
+
+DragonBonesData* BinaryDataParser::parseDragonBonesData(const char* rawData, std::size_t size, float scale, bool& complete)
+{
+    complete = false;
+
+    if (!isBinaryData(rawData, size))
+    {
+        return nullptr;
+    }
+
+    uint32_t dataSize = 0;
+    uint32_t version = 0;
+    std::memcpy(&dataSize, rawData + sizeof(MAGIC), sizeof(dataSize));
+    std::memcpy(&version, rawData + sizeof(MAGIC) + sizeof(dataSize), sizeof(version));
+    if (version != VERSION || dataSize < HEADER_SIZE || dataSize > size)
+    {
+        return nullptr;
+    }
+
+    BinaryReader reader(rawData + HEADER_SIZE, dataSize - HEADER_SIZE);
+
+    const auto data = _createObject<DragonBonesData>();
+    data->name = reader.readString();
+    data->frameRate = reader.read<uint32_t>();
+    if (data->frameRate == 0)
+    {
+        data->frameRate = 24;
+    }
+
+    this->_data = data;
+
+    for (std::size_t i = 0, l = reader.readCount(); i < l && !reader.failed(); ++i)
+    {
+        const auto name = reader.readString();
+        if (reader.failed() || name.empty() || data->getArmature(name))
+        {
+            reader.fail();
+            break;
+        }
+
+        const auto armature = _createObject<ArmatureData>();
+        armature->name = name;
+        data->addArmature(armature);
+        _readArmature(reader, *armature, scale);
+    }
+
+    this->_data = nullptr;
+    this->_armature = nullptr;
+    this->_animation = nullptr;
+
+    complete = !reader.failed();
+
+    return data;
+}
+
+DRAGONBONES_NAMESPACE_END
@@ -0,0 +1,82 @@
+#ifndef DRAGONBONES_BINARY_DATA_PARSER_H
+#define DRAGONBONES_BINARY_DATA_PARSER_H
+
+#include "JSONDataParser.h"
+
+DRAGONBONES_NAMESPACE_BEGIN
+
+class BinaryReader;
+
+/**
+ * @private
+ * Loads the flat binary form of DragonBones data written by writeDragonBonesData().
+ * The binary holds the model exactly as JSONDataParser leaves it, so loading skips the DOM, the
+ * global to local conversion, the curve sampling and the animation frame merging, and copies the
+ * float arrays of meshes, curves and FFD frames in bulk. Anything else is handed to the JSON parser.
+ */
+class BinaryDataParser : public JSONDataParser
+{
+public:
+    static const char MAGIC[4];
+    static const unsigned VERSION;
+
+    static bool isBinaryData(const char* rawData, std::size_t size);
+    static bool writeDragonBonesData(DragonBonesData& data, std::vector<char>& output);
+
+public:
+    BinaryDataParser();
+    ~BinaryDataParser();
+
+private:
+    DRAGONBONES_DISALLOW_COPY_AND_ASSIGN(BinaryDataParser);
+
+protected:
+    float _scaleRatio;
+
+    template<class T>
+    static T* _createObject()
+    {
+        // Not borrowed from the pools, they are only safe to touch on the main thread.
+        return new (std::nothrow) T();
+    }
+
+    virtual bool _readArmature(BinaryReader& reader, ArmatureData& armature, float scale);
+    virtual bool _readBone(BinaryReader& reader, std::vector<std::pair<BoneData*, std::string>>& iks);
+    virtual bool _readSlot(BinaryReader& reader);
+    virtual bool _readSkin(BinaryReader& reader);
+    virtual bool _readDisplay(BinaryReader& reader, DisplayData& display);
+    virtual bool _readMesh(BinaryReader& reader, MeshData& mesh);
+    virtual bool _readAnimation(BinaryReader& reader, std::vector<std::pair<AnimationData*, std::string>>& aliases);
+    virtual AnimationFrameData* _readAnimationFrame(BinaryReader& reader) const;
+    virtual BoneFrameData* _readBoneFrame(BinaryReader& reader) const;
+    virtual SlotFrameData* _readSlotFrame(BinaryReader& reader) const;
+    virtual ExtensionFrameData* _readFFDFrame(BinaryReader& reader) const;
+    virtual void _readActionData(BinaryReader& reader, std::vector<ActionData*>& actions) const;
+    virtual void _readEventData(BinaryReader& reader, std::vector<EventData*>& events) const;
+    virtual void _readColorTransform(BinaryReader& reader, ColorTransform& color) const;
+
+    template<class T>
+    void _readFrame(BinaryReader& reader, FrameData<T>& frame) const;
+    template<class T>
+    void _readTweenFrame(BinaryReader& reader, TweenFrameData<T>& frame) const;
+    template<class T>
+    bool _readTimeline(BinaryReader& reader, TimelineData<T>& timeline, const std::function<T*(BinaryReader& reader)>& frameReader) const;
+
+public:
+    virtual DragonBonesData* parseDragonBonesData(const char* rawData, float scale = 1.f) override;
+
+    /**
+     * @private
+     */
+    DragonBonesData* parseDragonBonesData(const char* rawData, std::size_t size, float scale = 1.f);
+
+    /**
+     * @private
+     * Does not touch the object pools, so it may run on a worker thread. When complete is false the data
+     * was truncated or malformed, and the partial result has to be returned to the pool on the main thread.
+     */
+    DragonBonesData* parseDragonBonesData(const char* rawData, std::size_t size, float scale, bool& complete);
+};
+
+DRAGONBONES_NAMESPACE_END
+#endif // DRAGONBONES_BINARY_DATA_PARSER_H
@@ -24,6 +24,7 @@ LOCAL_SRC_FILES :=      ../animation/Animation.cpp \
                         ../model/TimelineData.cpp \
                         ../parsers/DataParser.cpp \
                         ../parsers/JSONDataParser.cpp \
+                        ../parsers/BinaryDataParser.cpp \
                         ../textures/TextureData.cpp \
                         ../cocos2dx/CCArmatureDisplay.cpp \
                         ../cocos2dx/CCFactory.cpp \
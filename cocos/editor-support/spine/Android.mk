@@ -37,6 +37,7 @@ RegionAttachment.c \
 Skeleton.c \
 SkeletonAnimation.cpp \
 SkeletonBatch.cpp \
+SkeletonCache.cpp \
 SkeletonBinary.c \
 SkeletonBounds.c \
 SkeletonClipping.c \
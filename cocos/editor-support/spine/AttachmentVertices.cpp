@@ -42,6 +42,7 @@ AttachmentVertices::AttachmentVertices (Texture2D* texture, int verticesCount, u
 	_triangles->vertCount = verticesCount;
 	_triangles->indices = triangles;
 	_triangles->indexCount = trianglesCount;
+	_skinnedMeshBuilt = false;
 }
 
 AttachmentVertices::~AttachmentVertices () {
@@ -42,6 +42,12 @@ public:
 
 	cocos2d::Texture2D* _texture;
 	cocos2d::Triangles* _triangles;
+
+	// Bind pose of a weighted mesh for GPU skinning, built on first use and shared by every skeleton
+	// using the attachment. _skinnedBones maps the mesh bone palette to skeleton bone indices.
+	cocos2d::SmartPtr<cocos2d::SkinnedMesh> _skinnedMesh;
+	std::vector<int> _skinnedBones;
+	bool _skinnedMeshBuilt;
 };
 
 }
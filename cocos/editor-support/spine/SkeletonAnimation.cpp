@@ -31,6 +31,8 @@
 #include <spine/SkeletonAnimation.h>
 #include <spine/spine-cocos2dx.h>
 #include <spine/extension.h>
+#include <spine/SkeletonBatch.h>
+#include "base/ccUtils.h"
 #include <algorithm>
 
 USING_NS_CC;
@@ -118,6 +120,20 @@ void SkeletonAnimation::initialize () {
 	_spAnimationState* stateInternal = (_spAnimationState*)_state;
 	
 	_firstDraw = true;
+
+	_bakedTime = 0;
+	_bakedFrame = -1;
+	_bakedLoop = false;
+
+	_lodScreenSize = 0;
+	_lodInterval = 1;
+	_lodCounter = 0;
+	_lodDeltaTime = 0;
+	_cullingPadding = std::max(_skeleton->data->width, _skeleton->data->height) / 2;
+	_screenSize = FLT_MAX;
+	_visibleOnlyUpdate = false;
+	_offscreen = false;
+	_worldTransformDirty = false;
 }
 
 SkeletonAnimation::SkeletonAnimation ()
@@ -145,12 +161,27 @@ SkeletonAnimation::~SkeletonAnimation () {
 }
 
 void SkeletonAnimation::update (float deltaTime) {
+	if (_bakedCache) {
+		Node::update(deltaTime);
+		updateBaked(deltaTime * _timeScale);
+		return;
+	}
 	super::update(deltaTime);
 
 	deltaTime *= _timeScale;
+	bool skipWorldTransform = _visibleOnlyUpdate && _offscreen;
+	_lodDeltaTime += deltaTime;
+	if (!skipWorldTransform && _lodInterval > 1 && _screenSize < _lodScreenSize && ++_lodCounter < _lodInterval) return;
+	deltaTime = _lodDeltaTime;
+	_lodDeltaTime = 0;
+	_lodCounter = 0;
 	spAnimationState_update(_state, deltaTime);
 	spAnimationState_apply(_state, _skeleton);
-	spSkeleton_updateWorldTransform(_skeleton);
+	if (skipWorldTransform) {
+		_worldTransformDirty = true;
+		return;
+	}
+	updateWorldTransformAndBounds();
 }
 
 void SkeletonAnimation::draw(cocos2d::IRenderer *renderer, const cocos2d::Mat4 &transform, uint32_t transformFlags) {
@@ -158,9 +189,173 @@ void SkeletonAnimation::draw(cocos2d::IRenderer *renderer, const cocos2d::Mat4 &
 		_firstDraw = false;
 		update(0);
 	}
+	if (_bakedCache) {
+		drawBaked(transform);
+		return;
+	}
+	if (isLodEnabled()) {
+		Rect bounds = _bonesBounds;
+		bounds.origin.x -= _cullingPadding;
+		bounds.origin.y -= _cullingPadding;
+		bounds.size.width += _cullingPadding * 2;
+		bounds.size.height += _cullingPadding * 2;
+		Rect screenRect = utils::getScreenRect(transform, bounds);
+		_screenSize = std::max(screenRect.size.width, screenRect.size.height);
+		_offscreen = !utils::getVisibleRect().intersectsRect(screenRect);
+		if (_visibleOnlyUpdate && _offscreen) return;
+	}
+	if (_worldTransformDirty) {
+		// Back in view, catch up with the pose applied while off screen.
+		updateWorldTransformAndBounds();
+	}
 	super::draw(renderer, transform, transformFlags);
 }
 
+void SkeletonAnimation::updateWorldTransformAndBounds () {
+	spSkeleton_updateWorldTransform(_skeleton);
+	_worldTransformDirty = false;
+	if (isLodEnabled()) updateBonesBounds();
+}
+
+void SkeletonAnimation::updateBonesBounds () {
+	float minX = FLT_MAX, minY = FLT_MAX, maxX = -FLT_MAX, maxY = -FLT_MAX;
+	for (int i = 0; i < _skeleton->bonesCount; ++i) {
+		spBone* bone = _skeleton->bones[i];
+		minX = std::min(minX, bone->worldX);
+		minY = std::min(minY, bone->worldY);
+		maxX = std::max(maxX, bone->worldX);
+		maxY = std::max(maxY, bone->worldY);
+	}
+	if (minX == FLT_MAX) minX = minY = maxX = maxY = 0;
+	_bonesBounds.setRect(minX, minY, maxX - minX, maxY - minY);
+}
+
+bool SkeletonAnimation::isLodEnabled () const {
+	return _lodInterval > 1 || _visibleOnlyUpdate;
+}
+
+void SkeletonAnimation::setUpdateLod (float screenSize, int interval) {
+	_lodScreenSize = screenSize;
+	_lodInterval = std::max(interval, 1);
+	_lodCounter = 0;
+	updateBonesBounds();
+}
+
+void SkeletonAnimation::setVisibleOnlyUpdate (bool enabled) {
+	_visibleOnlyUpdate = enabled;
+	if (!enabled) _offscreen = false;
+	updateBonesBounds();
+}
+
+bool SkeletonAnimation::isVisibleOnlyUpdate () const {
+	return _visibleOnlyUpdate;
+}
+
+void SkeletonAnimation::setCullingPadding (float padding) {
+	_cullingPadding = padding;
+}
+
+bool SkeletonAnimation::setBakedAnimation (const std::string& name, bool loop, float frameRate) {
+	SkeletonCache* cache = SkeletonCacheManager::getInstance()->getCache(_skeleton->data, name, _skeleton->skin, _premultipliedAlpha, frameRate);
+	if (!cache) {
+		log("Spine: Animation not found: %s", name.c_str());
+		return false;
+	}
+	_bakedCache = cache;
+	_bakedLoop = loop;
+	_bakedTime = 0;
+	_bakedFrame = -1;
+	return true;
+}
+
+void SkeletonAnimation::clearBakedAnimation () {
+	_bakedCache = nullptr;
+	_bakedFrame = -1;
+}
+
+bool SkeletonAnimation::isBaked () const {
+	return _bakedCache.get() != nullptr;
+}
+
+void SkeletonAnimation::updateBaked (float deltaTime) {
+	if (_bakedCache->getSkin() != _skeleton->skin) {
+		// The skin changed, go on playing from the frames sampled with the new one
+		_bakedCache = SkeletonCacheManager::getInstance()->getCache(_skeleton->data, _bakedCache->getAnimation()->name,
+			_skeleton->skin, _premultipliedAlpha, _bakedCache->getFrameRate());
+	}
+	float duration = _bakedCache->getDuration();
+	int lastFrame = _bakedCache->getFrameCount() - 1;
+	_bakedTime += deltaTime;
+	if (_bakedTime >= duration) {
+		if (_bakedLoop && duration > 0) {
+			fireBakedEvents(_bakedFrame, lastFrame);
+			if (_completeListener) _completeListener(nullptr);
+			_bakedTime = fmodf(_bakedTime, duration);
+			_bakedFrame = -1;
+		}
+		else {
+			_bakedTime = duration;
+			if (_bakedFrame < lastFrame) {
+				fireBakedEvents(_bakedFrame, lastFrame);
+				_bakedFrame = lastFrame;
+				if (_completeListener) _completeListener(nullptr);
+			}
+			return;
+		}
+	}
+	int frame = std::min(static_cast<int>(_bakedTime * _bakedCache->getFrameRate()), lastFrame);
+	fireBakedEvents(_bakedFrame, frame);
+	_bakedFrame = frame;
+}
+
+void SkeletonAnimation::fireBakedEvents (int fromFrame, int toFrame) {
+	if (!_eventListener) return;
+	// Frames are sampled in order, so this also fills the cache for everyone behind us.
+	for (int i = fromFrame + 1; i <= toFrame; ++i) {
+		for (spEvent* event : _bakedCache->getFrame(i)->events) {
+			_eventListener(nullptr, event);
+		}
+	}
+}
+
+void SkeletonAnimation::drawBaked (const cocos2d::Mat4& transform) {
+	if (getDisplayedOpacity() == 0) return;
+	const SkeletonCache::Frame* frame = _bakedCache->getFrame(std::max(_bakedFrame, 0));
+	if (frame->segments.empty()) return;
+
+	// The cache is baked with a white node, modulate by our displayed color only when it differs.
+	const Color3B& displayedColor = getDisplayedColor();
+	bool tinted = displayedColor != Color3B::WHITE || getDisplayedOpacity() != 255;
+	float alpha = getDisplayedOpacity() / 255.0f;
+	float multiplier = _premultipliedAlpha ? alpha : 1.0f;
+	float red = displayedColor.r / 255.0f * multiplier;
+	float green = displayedColor.g / 255.0f * multiplier;
+	float blue = displayedColor.b / 255.0f * multiplier;
+
+	// The cache holds single color vertices, the dark color of a two color tint is not baked.
+	SpriteProgram* program = isTwoColorTint() ? SharedRenderer.getDefaultProgram() : program_.get();
+	SkeletonBatch* batch = SkeletonBatch::getInstance();
+	SharedRendererManager.setCurrent(SharedRenderer.getTarget());
+	for (const SkeletonCache::Segment& segment : frame->segments) {
+		V3F_C4B_T2F* verts = const_cast<V3F_C4B_T2F*>(frame->vertices.data()) + segment.vertexStart;
+		if (tinted) {
+			V3F_C4B_T2F* tintedVerts = batch->allocateVertices(segment.vertexCount);
+			for (uint32_t v = 0; v < segment.vertexCount; ++v) {
+				tintedVerts[v] = verts[v];
+				Color4B& color = tintedVerts[v].colors;
+				color.r = (GLubyte)(color.r * red);
+				color.g = (GLubyte)(color.g * green);
+				color.b = (GLubyte)(color.b * blue);
+				color.a = (GLubyte)(color.a * alpha);
+			}
+			verts = tintedVerts;
+		}
+		SharedRenderer.push(verts, segment.vertexCount,
+			const_cast<uint16_t*>(frame->indices.data()) + segment.indexStart, segment.indexCount,
+			program, segment.texture, segment.state, segment.texture->getFlags(), transform);
+	}
+}
+
 void SkeletonAnimation::setAnimationStateData (spAnimationStateData* stateData) {
 	CCASSERT(stateData, "stateData cannot be null.");
 
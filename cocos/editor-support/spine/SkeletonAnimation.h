@@ -33,6 +33,7 @@
 
 #include <spine/spine.h>
 #include <spine/SkeletonRenderer.h>
+#include <spine/SkeletonCache.h>
 #include "cocos2d.h"
 
 namespace spine {
@@ -101,6 +102,24 @@ public:
 
 	spAnimationState* getState() const;
 
+	/* Plays an animation from a SkeletonCache sampled at frameRate and shared by every instance baked from the same
+	 * skeleton data and skin, so drawing only copies precomputed vertices. Mixing, other tracks and vertex effects are not
+	 * applied while baked, and listeners receive a null track entry. Returns false if the animation was not found. */
+	bool setBakedAnimation (const std::string& name, bool loop, float frameRate = 30);
+	void clearBakedAnimation ();
+	bool isBaked () const;
+
+	/* Update-rate LOD. While the skeleton covers less than screenSize points on screen, it is posed only every interval
+	 * updates by the accumulated time. Listeners fire for the same events, at most interval - 1 updates late. An interval
+	 * of 1 disables it. */
+	void setUpdateLod (float screenSize, int interval);
+	/* While the skeleton is off screen, spSkeleton_updateWorldTransform and drawing are skipped until it is visible again.
+	 * The animation state is still updated and applied every update, so listeners fire on time. */
+	void setVisibleOnlyUpdate (bool enabled);
+	bool isVisibleOnlyUpdate () const;
+	/* Margin added around the bones when measuring the skeleton on screen. Defaults to half the skeleton data size. */
+	void setCullingPadding (float padding);
+
 CC_CONSTRUCTOR_ACCESS:
 	SkeletonAnimation ();
 	SkeletonAnimation(spSkeletonData* skeletonData, bool ownsSkeletonData = false);
@@ -110,6 +129,13 @@ CC_CONSTRUCTOR_ACCESS:
 	virtual void initialize () override;
 
 protected:
+	void updateBaked (float deltaTime);
+	void fireBakedEvents (int fromFrame, int toFrame);
+	void drawBaked (const cocos2d::Mat4& transform);
+	void updateWorldTransformAndBounds ();
+	void updateBonesBounds ();
+	bool isLodEnabled () const;
+
 	spAnimationState* _state;
 
 	bool _ownsAnimationStateData;
@@ -122,6 +148,22 @@ protected:
 	CompleteListener _completeListener;
 	EventListener _eventListener;
 
+	cocos2d::SmartPtr<SkeletonCache> _bakedCache;
+	float _bakedTime;
+	int _bakedFrame;
+	bool _bakedLoop;
+
+	float _lodScreenSize;
+	int _lodInterval;
+	int _lodCounter;
+	float _lodDeltaTime;
+	float _cullingPadding;
+	float _screenSize;
+	cocos2d::Rect _bonesBounds;
+	bool _visibleOnlyUpdate;
+	bool _offscreen;
+	bool _worldTransformDirty;
+
 private:
 	typedef SkeletonRenderer super;
 };
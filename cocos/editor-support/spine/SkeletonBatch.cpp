@@ -30,6 +30,7 @@
 
 #include <spine/SkeletonBatch.h>
 #include <spine/extension.h>
+#include "base/FrameAllocator.h"
 #include <algorithm>
 
 USING_NS_CC;
@@ -54,9 +55,7 @@ void SkeletonBatch::destroyInstance () {
 }
 
 SkeletonBatch::SkeletonBatch () {
-	for (unsigned int i = 0; i < INITIAL_SIZE; i++) {
-		_commandsPool.push_back(new Triangles());
-	}
+	_commands.reserve(INITIAL_SIZE);
 	
 	_indices = spUnsignedShortArray_create(8);
 	
@@ -73,11 +72,6 @@ SkeletonBatch::~SkeletonBatch () {
 	SharedDirector.getEventDispatcher()->removeCustomEventListeners(EVENT_AFTER_DRAW_RESET_POSITION);
 
 	spUnsignedShortArray_dispose(_indices);
-	
-	for (unsigned int i = 0; i < _commandsPool.size(); i++) {
-		delete _commandsPool[i];
-		_commandsPool[i] = nullptr;
-	}
 }
 
 void SkeletonBatch::update (float delta) {
@@ -89,8 +83,8 @@ cocos2d::V3F_C4B_T2F* SkeletonBatch::allocateVertices(uint32_t numVertices) {
 		cocos2d::V3F_C4B_T2F* oldData = _vertices.data();
 		_vertices.resize((_vertices.size() + numVertices) * 2 + 1);
 		cocos2d::V3F_C4B_T2F* newData = _vertices.data();
-		for (uint32_t i = 0; i < this->_nextFreeCommand; i++) {
-			cocos2d::Triangles& triangles = *_commandsPool[i];
+		for (cocos2d::Triangles* command : _commands) {
+			cocos2d::Triangles& triangles = *command;
 			triangles.verts = newData + (triangles.verts - oldData);
 		}
 	}
@@ -111,8 +105,8 @@ unsigned short* SkeletonBatch::allocateIndices(uint32_t numIndices) {
 		int oldSize = _indices->size;
 		spUnsignedShortArray_ensureCapacity(_indices, _indices->size + numIndices);
 		unsigned short* newData = _indices->items;
-		for (uint32_t i = 0; i < this->_nextFreeCommand; i++) {
-			cocos2d::Triangles& triangles = *_commandsPool[i];
+		for (cocos2d::Triangles* command : _commands) {
+			cocos2d::Triangles& triangles = *command;
 			if (triangles.indices >= oldData && triangles.indices < oldData + oldSize) {
 				triangles.indices = newData + (triangles.indices - oldData);
 			}
@@ -137,18 +131,14 @@ cocos2d::Triangles* SkeletonBatch::addCommand(cocos2d::IRenderer* renderer, floa
 }
 
 void SkeletonBatch::reset() {
-	_nextFreeCommand = 0;
+	_commands.clear();
 	_numVertices = 0;
 	_indices->size = 0;
 }
 
 cocos2d::Triangles* SkeletonBatch::nextFreeCommand() {
-	if (_commandsPool.size() <= _nextFreeCommand) {
-		size_t newSize = _commandsPool.size() * 2 + 1;
-		for (size_t i = _commandsPool.size();  i < newSize; i++) {
-			_commandsPool.push_back(new Triangles());
-		}
-	}
-	return _commandsPool[_nextFreeCommand++];
+	Triangles* command = SharedFrameAllocator.create<Triangles>();
+	_commands.push_back(command);
+	return command;
 }
 }
@@ -59,9 +59,8 @@ namespace spine {
 		
 		cocos2d::Triangles* nextFreeCommand ();
 		
-		// pool of commands
-		std::vector<cocos2d::Triangles*> _commandsPool;
-		uint32_t _nextFreeCommand;
+		// commands of the frame, allocated from the frame allocator
+		std::vector<cocos2d::Triangles*> _commands;
 		
 		// pool of vertices
 		std::vector<cocos2d::V3F_C4B_T2F> _vertices;
@@ -0,0 +1,249 @@
+#include "ccHeader.h"
+#include <spine/SkeletonCache.h>
+#include <spine/extension.h>
+#include <spine/AttachmentVertices.h>
+
+USING_NS_CC;
+
+namespace spine {
+
+SkeletonCache::SkeletonCache (spSkeletonData* skeletonData, spAnimation* animation, spSkin* skin, bool premultipliedAlpha, float frameRate)
+	: _skeletonData(skeletonData)
+	, _animation(animation)
+	, _skin(skin)
+	, _premultipliedAlpha(premultipliedAlpha)
+	, _frameRate(frameRate)
+	, _frameCount(static_cast<int>(animation->duration * frameRate) + 1)
+	, _sampledCount(0) {
+	_frames.resize(_frameCount);
+
+	_skeleton = spSkeleton_create(skeletonData);
+	if (skin) spSkeleton_setSkin(_skeleton, skin);
+	spSkeleton_setToSetupPose(_skeleton);
+	_state = spAnimationState_create(spAnimationStateData_create(skeletonData));
+	_state->rendererObject = this;
+	_state->listener = samplerCallback;
+	spAnimationState_setAnimation(_state, 0, animation, 0);
+	_clipper = spSkeletonClipping_create();
+}
+
+SkeletonCache::~SkeletonCache () {
+	disposeSampler();
+}
+
+void SkeletonCache::disposeSampler () {
+	if (_state) {
+		spAnimationStateData_dispose(_state->data);
+		spAnimationState_dispose(_state);
+		_state = nullptr;
+	}
+	if (_skeleton) {
+		spSkeleton_dispose(_skeleton);
+		_skeleton = nullptr;
+	}
+	if (_clipper) {
+		spSkeletonClipping_dispose(_clipper);
+		_clipper = nullptr;
+	}
+}
+
+void SkeletonCache::samplerCallback (spAnimationState* state, spEventType type, spTrackEntry* entry, spEvent* event) {
+	if (type == SP_ANIMATION_EVENT) {
+		static_cast<SkeletonCache*>(state->rendererObject)->_pendingEvents.push_back(event);
+	}
+}
+
+const SkeletonCache::Frame* SkeletonCache::getFrame (int index) {
+	index = std::max(0, std::min(index, _frameCount - 1));
+	while (_sampledCount <= index) {
+		sampleNextFrame();
+	}
+	return &_frames[index];
+}
+
+void SkeletonCache::sampleNextFrame () {
+	spAnimationState_update(_state, _sampledCount == 0 ? 0 : 1 / _frameRate);
+	spAnimationState_apply(_state, _skeleton);
+	spSkeleton_updateWorldTransform(_skeleton);
+
+	Frame& frame = _frames[_sampledCount];
+	frame.events.swap(_pendingEvents);
+	_pendingEvents.clear();
+
+	for (int i = 0, n = _skeleton->slotsCount; i < n; ++i) {
+		spSlot* slot = _skeleton->drawOrder[i];
+		if (!slot->attachment || slot->color.a == 0) {
+			spSkeletonClipping_clipEnd(_clipper, slot);
+			continue;
+		}
+
+		size_t vertexStart = frame.vertices.size();
+		AttachmentVertices* attachmentVertices = nullptr;
+		spColor* attachmentColor = nullptr;
+		switch (slot->attachment->type) {
+		case SP_ATTACHMENT_REGION: {
+			spRegionAttachment* attachment = (spRegionAttachment*)slot->attachment;
+			attachmentVertices = (AttachmentVertices*)attachment->rendererObject;
+			attachmentColor = &attachment->color;
+			if (attachmentColor->a == 0) break;
+			frame.vertices.resize(vertexStart + attachmentVertices->_triangles->vertCount);
+			V3F_C4B_T2F* verts = frame.vertices.data() + vertexStart;
+			memcpy(verts, attachmentVertices->_triangles->verts, sizeof(V3F_C4B_T2F) * attachmentVertices->_triangles->vertCount);
+			spRegionAttachment_computeWorldVertices(attachment, slot->bone, (float*)verts, 0, 6);
+			break;
+		}
+		case SP_ATTACHMENT_MESH: {
+			spMeshAttachment* attachment = (spMeshAttachment*)slot->attachment;
+			attachmentVertices = (AttachmentVertices*)attachment->rendererObject;
+			attachmentColor = &attachment->color;
+			if (attachmentColor->a == 0) break;
+			frame.vertices.resize(vertexStart + attachmentVertices->_triangles->vertCount);
+			V3F_C4B_T2F* verts = frame.vertices.data() + vertexStart;
+			memcpy(verts, attachmentVertices->_triangles->verts, sizeof(V3F_C4B_T2F) * attachmentVertices->_triangles->vertCount);
+			spVertexAttachment_computeWorldVertices(SUPER(attachment), slot, 0, attachment->super.worldVerticesLength, (float*)verts, 0, sizeof(V3F_C4B_T2F) / sizeof(float));
+			break;
+		}
+		case SP_ATTACHMENT_CLIPPING: {
+			spSkeletonClipping_clipStart(_clipper, slot, (spClippingAttachment*)slot->attachment);
+			continue;
+		}
+		default:
+			break;
+		}
+
+		float alpha = attachmentColor ? _skeleton->color.a * slot->color.a * attachmentColor->a * 255 : 0;
+		if (alpha == 0) {
+			frame.vertices.resize(vertexStart);
+			spSkeletonClipping_clipEnd(_clipper, slot);
+			continue;
+		}
+
+		unsigned short* indices = attachmentVertices->_triangles->indices;
+		int indexCount = attachmentVertices->_triangles->indexCount;
+		if (spSkeletonClipping_isClipping(_clipper)) {
+			V3F_C4B_T2F* verts = frame.vertices.data() + vertexStart;
+			int vertCount = static_cast<int>(frame.vertices.size() - vertexStart);
+			spSkeletonClipping_clipTriangles(_clipper, (float*)&verts[0].vertices, vertCount * sizeof(V3F_C4B_T2F) / 4, indices, indexCount, (float*)&verts[0].texCoords, 6);
+			frame.vertices.resize(vertexStart);
+			if (_clipper->clippedTriangles->size == 0) {
+				spSkeletonClipping_clipEnd(_clipper, slot);
+				continue;
+			}
+			float* clippedVerts = _clipper->clippedVertices->items;
+			float* uvs = _clipper->clippedUVs->items;
+			frame.vertices.resize(vertexStart + (_clipper->clippedVertices->size >> 1));
+			for (size_t v = vertexStart, vv = 0; v < frame.vertices.size(); ++v, vv += 2) {
+				V3F_C4B_T2F& vertex = frame.vertices[v];
+				vertex.vertices.set(clippedVerts[vv], clippedVerts[vv + 1], 0);
+				vertex.texCoords.u = uvs[vv];
+				vertex.texCoords.v = uvs[vv + 1];
+			}
+			indices = _clipper->clippedTriangles->items;
+			indexCount = _clipper->clippedTriangles->size;
+		}
+
+		// Baked with a white node, the instance modulates by its displayed color when drawing.
+		float multiplier = _premultipliedAlpha ? alpha : 255;
+		Color4B color(
+			(GLubyte)(_skeleton->color.r * slot->color.r * attachmentColor->r * multiplier),
+			(GLubyte)(_skeleton->color.g * slot->color.g * attachmentColor->g * multiplier),
+			(GLubyte)(_skeleton->color.b * slot->color.b * attachmentColor->b * multiplier),
+			(GLubyte)alpha);
+		for (size_t v = vertexStart; v < frame.vertices.size(); ++v) {
+			frame.vertices[v].colors = color;
+		}
+
+		BlendFunc blendFunc;
+		switch (slot->data->blendMode) {
+		case SP_BLEND_MODE_ADDITIVE:
+			blendFunc.src = _premultipliedAlpha ? BlendFunc::One : BlendFunc::SrcAlpha;
+			blendFunc.dst = BlendFunc::One;
+			break;
+		case SP_BLEND_MODE_MULTIPLY:
+			blendFunc.src = BlendFunc::DstColor;
+			blendFunc.dst = BlendFunc::InvSrcAlpha;
+			break;
+		case SP_BLEND_MODE_SCREEN:
+			blendFunc.src = BlendFunc::One;
+			blendFunc.dst = BlendFunc::InvSrcColor;
+			break;
+		default:
+			blendFunc.src = _premultipliedAlpha ? BlendFunc::One : BlendFunc::SrcAlpha;
+			blendFunc.dst = BlendFunc::InvSrcAlpha;
+		}
+		uint64_t state = (BGFX_STATE_WRITE_RGB | BGFX_STATE_WRITE_A | BGFX_STATE_MSAA | blendFunc.toValue());
+
+		// Consecutive slots sharing texture and state become one segment, one push at draw time.
+		uint32_t vertexCount = static_cast<uint32_t>(frame.vertices.size() - vertexStart);
+		Segment* segment = frame.segments.empty() ? nullptr : &frame.segments.back();
+		if (!segment || segment->texture != attachmentVertices->_texture || segment->state != state || segment->vertexCount + vertexCount > UINT16_MAX) {
+			Segment newSegment = { attachmentVertices->_texture, state, static_cast<uint32_t>(vertexStart), 0, static_cast<uint32_t>(frame.indices.size()), 0 };
+			frame.segments.push_back(newSegment);
+			segment = &frame.segments.back();
+		}
+		uint16_t offset = static_cast<uint16_t>(segment->vertexCount);
+		for (int ii = 0; ii < indexCount; ++ii) {
+			frame.indices.push_back(indices[ii] + offset);
+		}
+		segment->vertexCount += vertexCount;
+		segment->indexCount += indexCount;
+
+		spSkeletonClipping_clipEnd(_clipper, slot);
+	}
+	spSkeletonClipping_clipEnd2(_clipper);
+
+	frame.vertices.shrink_to_fit();
+	frame.indices.shrink_to_fit();
+
+	if (++_sampledCount == _frameCount) {
+		disposeSampler();
+	}
+}
+
+static SkeletonCacheManager* instance = nullptr;
+
+SkeletonCacheManager* SkeletonCacheManager::getInstance () {
+	if (!instance) instance = new SkeletonCacheManager();
+	return instance;
+}
+
+void SkeletonCacheManager::destroyInstance () {
+	if (instance) {
+		delete instance;
+		instance = nullptr;
+	}
+}
+
+SkeletonCache* SkeletonCacheManager::getCache (spSkeletonData* skeletonData, const std::string& animationName, spSkin* skin, bool premultipliedAlpha, float frameRate) {
+	char prefix[96];
+	snprintf(prefix, sizeof(prefix), "%p:%p:%d:%g:", skeletonData, skin, premultipliedAlpha ? 1 : 0, frameRate);
+	std::string key = prefix + animationName;
+	auto it = _caches.find(key);
+	if (it != _caches.end()) {
+		return it->second;
+	}
+	spAnimation* animation = spSkeletonData_findAnimation(skeletonData, animationName.c_str());
+	if (!animation || frameRate <= 0) {
+		return nullptr;
+	}
+	SkeletonCache* cache = SkeletonCache::create(skeletonData, animation, skin, premultipliedAlpha, frameRate);
+	_caches[key] = cache;
+	return cache;
+}
+
+void SkeletonCacheManager::removeCaches (spSkeletonData* skeletonData) {
+	for (auto it = _caches.begin(); it != _caches.end();) {
+		if (it->second->getSkeletonData() == skeletonData) {
+			it = _caches.erase(it);
+		}
+		else {
+			++it;
+		}
+	}
+}
+
+void SkeletonCacheManager::removeAllCaches () {
+	_caches.clear();
+}
+
+}
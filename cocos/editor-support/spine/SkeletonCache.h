@@ -0,0 +1,87 @@
+#pragma once
+
+#include <spine/spine.h>
+#include "cocos2d.h"
+
+namespace spine {
+
+/* Pre-sampled vertex data of one animation, shared by every SkeletonAnimation that plays it in baked mode.
+ * Frames are sampled lazily in order the first time any instance reaches them, so the bones, constraints
+ * and mesh deformation of an animation are evaluated once no matter how many instances play it. */
+class SkeletonCache : public cocos2d::Ref {
+public:
+	struct Segment {
+		cocos2d::Texture2D* texture;
+		uint64_t state;
+		uint32_t vertexStart;
+		uint32_t vertexCount;
+		uint32_t indexStart;
+		uint32_t indexCount;
+	};
+
+	struct Frame {
+		std::vector<Segment> segments;
+		std::vector<cocos2d::V3F_C4B_T2F> vertices;
+		std::vector<uint16_t> indices;
+		std::vector<spEvent*> events;
+	};
+
+	CREATE_FUNC(SkeletonCache);
+
+	/* Returns the frame, sampling every frame up to it first if needed. */
+	const Frame* getFrame (int index);
+
+	int getFrameCount () const { return _frameCount; }
+	float getFrameRate () const { return _frameRate; }
+	float getDuration () const { return _animation->duration; }
+	spSkeletonData* getSkeletonData () const { return _skeletonData; }
+	spAnimation* getAnimation () const { return _animation; }
+	/* The skin the frames were sampled with, null for the default skin. */
+	spSkin* getSkin () const { return _skin; }
+	bool isComplete () const { return _sampledCount == _frameCount; }
+
+	virtual ~SkeletonCache ();
+
+protected:
+	SkeletonCache (spSkeletonData* skeletonData, spAnimation* animation, spSkin* skin, bool premultipliedAlpha, float frameRate);
+
+	void sampleNextFrame ();
+	void disposeSampler ();
+
+	static void samplerCallback (spAnimationState* state, spEventType type, spTrackEntry* entry, spEvent* event);
+
+	spSkeletonData* _skeletonData;
+	spAnimation* _animation;
+	spSkin* _skin;
+	bool _premultipliedAlpha;
+	float _frameRate;
+	int _frameCount;
+	int _sampledCount;
+	std::vector<Frame> _frames;
+
+	// Only alive while frames are still being sampled.
+	spSkeleton* _skeleton;
+	spAnimationState* _state;
+	spSkeletonClipping* _clipper;
+	std::vector<spEvent*> _pendingEvents;
+};
+
+/* Owns the caches, keyed by skeleton data, animation, skin, alpha mode and frame rate. */
+class SkeletonCacheManager {
+public:
+	static SkeletonCacheManager* getInstance ();
+	static void destroyInstance ();
+
+	SkeletonCache* getCache (spSkeletonData* skeletonData, const std::string& animationName, spSkin* skin, bool premultipliedAlpha, float frameRate);
+
+	/* Must be called before skeleton data shared by baked instances is disposed. */
+	void removeCaches (spSkeletonData* skeletonData);
+	void removeAllCaches ();
+
+protected:
+	SkeletonCacheManager () {}
+
+	std::unordered_map<std::string, cocos2d::SmartPtr<SkeletonCache>> _caches;
+};
+
+}
@@ -32,6 +32,7 @@
 #include <spine/extension.h>
 #include <spine/SkeletonBatch.h>
 #include <spine/SkeletonTwoColorBatch.h>
+#include <spine/SkeletonCache.h>
 #include <spine/AttachmentVertices.h>
 #include <spine/Cocos2dAttachmentLoader.h>
 #include <algorithm>
@@ -108,34 +109,14 @@ namespace spine {
 
 	void SkeletonRenderer::setupGLProgramState(bool twoColorTintEnabled) {
 		if (twoColorTintEnabled) {
-			//setGLProgramState(SkeletonTwoColorBatch::getInstance()->getTwoColorTintProgramState());
+			program_ = SharedRenderer.getTwoColorProgram();
 			return;
 		}
 
-		Texture2D *texture = nullptr;
-		for (int i = 0, n = _skeleton->slotsCount; i < n; i++) {
-			spSlot* slot = _skeleton->drawOrder[i];
-			if (!slot->attachment) continue;
-			switch (slot->attachment->type) {
-			case SP_ATTACHMENT_REGION: {
-				spRegionAttachment* attachment = (spRegionAttachment*)slot->attachment;
-				texture = static_cast<AttachmentVertices*>(attachment->rendererObject)->_texture;
-				break;
-			}
-			case SP_ATTACHMENT_MESH: {
-				spMeshAttachment* attachment = (spMeshAttachment*)slot->attachment;
-				texture = static_cast<AttachmentVertices*>(attachment->rendererObject)->_texture;
-				break;
-			}
-			default:
-				continue;
-			}
-
-			if (texture != nullptr) {
-				break;
-			}
+		// a custom program set on the node is kept
+		if (program_.get() == SharedRenderer.getTwoColorProgram()) {
+			program_ = SharedRenderer.getDefaultProgram();
 		}
-		//setGLProgramState(GLProgramState::getOrCreateWithGLProgramName(GLProgram::SHADER_NAME_POSITION_TEXTURE_COLOR_NO_MVP));
 	}
 
 	void SkeletonRenderer::setSkeletonData(spSkeletonData *skeletonData, bool ownsSkeletonData) {
@@ -144,7 +125,7 @@ namespace spine {
 	}
 
 	SkeletonRenderer::SkeletonRenderer()
-		: _ownsSkeletonData(false), _ownsSkeleton(false), _atlas(nullptr), _attachmentLoader(nullptr), _premultipliedAlpha(false), _skeleton(nullptr), _debugSlots(false), _debugBones(false), _debugMeshes(false), _clipper(nullptr), _timeScale(1), _effect(nullptr), _startSlotIndex(-1), _endSlotIndex(-1) {
+		: _ownsSkeletonData(false), _ownsSkeleton(false), _atlas(nullptr), _attachmentLoader(nullptr), _premultipliedAlpha(false), _skeleton(nullptr), _debugSlots(false), _debugBones(false), _debugMeshes(false), _clipper(nullptr), _timeScale(1), _effect(nullptr), _startSlotIndex(-1), _endSlotIndex(-1), _gpuSkinning(false) {
 	}
 
 	SkeletonRenderer::SkeletonRenderer(spSkeleton* skeleton, bool ownsSkeleton, bool ownsSkeletonData)
@@ -168,7 +149,10 @@ namespace spine {
 	}
 
 	SkeletonRenderer::~SkeletonRenderer() {
-		if (_ownsSkeletonData) spSkeletonData_dispose(_skeleton->data);
+		if (_ownsSkeletonData) {
+			SkeletonCacheManager::getInstance()->removeCaches(_skeleton->data);
+			spSkeletonData_dispose(_skeleton->data);
+		}
 		if (_ownsSkeleton) spSkeleton_dispose(_skeleton);
 		if (_atlas) spAtlas_dispose(_atlas);
 		if (_attachmentLoader) spAttachmentLoader_dispose(_attachmentLoader);
@@ -280,7 +264,6 @@ namespace spine {
 		Color4F color;
 		Color4F darkColor;
 		AttachmentVertices* attachmentVertices = nullptr;
-		TwoColorTrianglesCommand* lastTwoColorTrianglesCommand = nullptr;
 		bool inRange = _startSlotIndex != -1 || _endSlotIndex != -1 ? false : true;
 
         if (!isTwoColorTint)
@@ -315,6 +298,7 @@ namespace spine {
                 }
 
                 cocos2d::Triangles triangles;
+                SkinnedMesh* skinnedMesh = nullptr;
 
                 switch (slot->attachment->type) {
                 case SP_ATTACHMENT_REGION: {
@@ -351,13 +335,20 @@ namespace spine {
                         continue;
                     }
 
-                    triangles.indices = attachmentVertices->_triangles->indices;
-                    triangles.indexCount = attachmentVertices->_triangles->indexCount;
-                    triangles.verts = batch->allocateVertices(attachmentVertices->_triangles->vertCount);
-                    triangles.vertCount = attachmentVertices->_triangles->vertCount;
-                    memcpy(triangles.verts, attachmentVertices->_triangles->verts, sizeof(cocos2d::V3F_C4B_T2F) * attachmentVertices->_triangles->vertCount);
-                    int vertexSizeInFloats = sizeof(cocos2d::V3F_C4B_T2F) / sizeof(float);
-                    spVertexAttachment_computeWorldVertices(SUPER(attachment), slot, 0, attachment->super.worldVerticesLength, (float*)triangles.verts, 0, vertexSizeInFloats);
+                    if (_gpuSkinning && attachment->super.bones && slot->attachmentVerticesCount == 0 && !_effect &&
+                        !spSkeletonClipping_isClipping(_clipper) && program_.get() == SharedRenderer.getDefaultProgram()) {
+                        skinnedMesh = getSkinnedMesh(attachment, attachmentVertices);
+                    }
+
+                    if (!skinnedMesh) {
+                        triangles.indices = attachmentVertices->_triangles->indices;
+                        triangles.indexCount = attachmentVertices->_triangles->indexCount;
+                        triangles.verts = batch->allocateVertices(attachmentVertices->_triangles->vertCount);
+                        triangles.vertCount = attachmentVertices->_triangles->vertCount;
+                        memcpy(triangles.verts, attachmentVertices->_triangles->verts, sizeof(cocos2d::V3F_C4B_T2F) * attachmentVertices->_triangles->vertCount);
+                        int vertexSizeInFloats = sizeof(cocos2d::V3F_C4B_T2F) / sizeof(float);
+                        spVertexAttachment_computeWorldVertices(SUPER(attachment), slot, 0, attachment->super.worldVerticesLength, (float*)triangles.verts, 0, vertexSizeInFloats);
+                    }
 
                     color.r = attachment->color.r;
                     color.g = attachment->color.g;
@@ -428,7 +419,21 @@ namespace spine {
                     BGFX_STATE_WRITE_RGB | BGFX_STATE_WRITE_A |
                     BGFX_STATE_MSAA | blendFunc.toValue());
 
-                if (spSkeletonClipping_isClipping(_clipper)) {
+                if (skinnedMesh) {
+                    const std::vector<int>& bones = attachmentVertices->_skinnedBones;
+                    _bonePalette.resize(bones.size() * 2);
+                    for (size_t b = 0; b < bones.size(); ++b) {
+                        spBone* bone = _skeleton->bones[bones[b]];
+                        _bonePalette[b * 2].set(bone->a, bone->b, bone->worldX, 0);
+                        _bonePalette[b * 2 + 1].set(bone->c, bone->d, bone->worldY, 0);
+                    }
+                    SharedRendererManager.setCurrent(SharedRenderer.getTarget());
+                    SharedRenderer.push(skinnedMesh, _bonePalette.data(),
+                        Color4B((GLubyte)color.r, (GLubyte)color.g, (GLubyte)color.b, (GLubyte)color.a),
+                        attachmentVertices->_texture,
+                        state, attachmentVertices->_texture->getFlags(), transform);
+                }
+                else if (spSkeletonClipping_isClipping(_clipper)) {
                     spSkeletonClipping_clipTriangles(_clipper, (float*)&triangles.verts[0].vertices, triangles.vertCount * sizeof(cocos2d::V3F_C4B_T2F) / 4, triangles.indices, triangles.indexCount, (float*)&triangles.verts[0].texCoords, 6);
                     batch->deallocateVertices(triangles.vertCount);
 
@@ -683,9 +688,12 @@ namespace spine {
                     blendFunc.dst = BlendFunc::InvSrcAlpha;
                 }
 
+                uint64_t state = (
+                    BGFX_STATE_WRITE_RGB | BGFX_STATE_WRITE_A |
+                    BGFX_STATE_MSAA | blendFunc.toValue());
 
                 if (spSkeletonClipping_isClipping(_clipper)) {
-                    spSkeletonClipping_clipTriangles(_clipper, (float*)&trianglesTwoColor.verts[0].position, trianglesTwoColor.vertCount * sizeof(V3F_C4B_C4B_T2F) / 4, trianglesTwoColor.indices, trianglesTwoColor.indexCount, (float*)&trianglesTwoColor.verts[0].texCoords, 7);
+                    spSkeletonClipping_clipTriangles(_clipper, (float*)&trianglesTwoColor.verts[0].vertices, trianglesTwoColor.vertCount * sizeof(V3F_C4B_C4B_T2F) / 4, trianglesTwoColor.indices, trianglesTwoColor.indexCount, (float*)&trianglesTwoColor.verts[0].texCoords, 7);
                     twoColorBatch->deallocateVertices(trianglesTwoColor.vertCount);
 
                     if (_clipper->clippedTriangles->size == 0) {
@@ -699,8 +707,6 @@ namespace spine {
                     trianglesTwoColor.indices = twoColorBatch->allocateIndices(trianglesTwoColor.indexCount);
                     memcpy(trianglesTwoColor.indices, _clipper->clippedTriangles->items, sizeof(unsigned short) * _clipper->clippedTriangles->size);
 
-                    TwoColorTrianglesCommand* batchedTriangles = lastTwoColorTrianglesCommand = twoColorBatch->addCommand(renderer, _globalZOrder, attachmentVertices->_texture->getName(), /*_glProgramState*/nullptr, blendFunc, trianglesTwoColor, transform, transformFlags);
-
                     float* verts = _clipper->clippedVertices->items;
                     float* uvs = _clipper->clippedUVs->items;
 
@@ -714,47 +720,45 @@ namespace spine {
                         dark.r = darkColor.r / 255.0f;
                         dark.g = darkColor.g / 255.0f;
                         dark.b = darkColor.b / 255.0f;
-                        // dark.a = darkColor.a / 255.0f;
-                        for (int v = 0, vn = batchedTriangles->getTriangles().vertCount, vv = 0; v < vn; ++v, vv += 2) {
-                            V3F_C4B_C4B_T2F* vertex = batchedTriangles->getTriangles().verts + v;
+                        dark.a = darkColor.a / 255.0f;
+                        for (int v = 0, vn = trianglesTwoColor.vertCount, vv = 0; v < vn; ++v, vv += 2) {
+                            V3F_C4B_C4B_T2F* vertex = trianglesTwoColor.verts + v;
                             spColor lightCopy = light;
                             spColor darkCopy = dark;
-                            vertex->position.x = verts[vv];
-                            vertex->position.y = verts[vv + 1];
+                            vertex->vertices.x = verts[vv];
+                            vertex->vertices.y = verts[vv + 1];
                             vertex->texCoords.u = uvs[vv];
                             vertex->texCoords.v = uvs[vv + 1];
-                            _effect->transform(_effect, &vertex->position.x, &vertex->position.y, &vertex->texCoords.u, &vertex->texCoords.v, &lightCopy, &darkCopy);
-                            vertex->color.r = (GLubyte)(lightCopy.r * 255);
-                            vertex->color.g = (GLubyte)(lightCopy.g * 255);
-                            vertex->color.b = (GLubyte)(lightCopy.b * 255);
-                            vertex->color.a = (GLubyte)(lightCopy.a * 255);
-                            vertex->color2.r = (GLubyte)(darkCopy.r * 255);
-                            vertex->color2.g = (GLubyte)(darkCopy.g * 255);
-                            vertex->color2.b = (GLubyte)(darkCopy.b * 255);
-                            vertex->color2.a = (GLubyte)darkColor.a;
+                            _effect->transform(_effect, &vertex->vertices.x, &vertex->vertices.y, &vertex->texCoords.u, &vertex->texCoords.v, &lightCopy, &darkCopy);
+                            vertex->colors.r = (GLubyte)(lightCopy.r * 255);
+                            vertex->colors.g = (GLubyte)(lightCopy.g * 255);
+                            vertex->colors.b = (GLubyte)(lightCopy.b * 255);
+                            vertex->colors.a = (GLubyte)(lightCopy.a * 255);
+                            vertex->colors2.r = (GLubyte)(darkCopy.r * 255);
+                            vertex->colors2.g = (GLubyte)(darkCopy.g * 255);
+                            vertex->colors2.b = (GLubyte)(darkCopy.b * 255);
+                            vertex->colors2.a = (GLubyte)darkColor.a;
                         }
                     }
                     else {
-                        for (int v = 0, vn = batchedTriangles->getTriangles().vertCount, vv = 0; v < vn; ++v, vv += 2) {
-                            V3F_C4B_C4B_T2F* vertex = batchedTriangles->getTriangles().verts + v;
-                            vertex->position.x = verts[vv];
-                            vertex->position.y = verts[vv + 1];
+                        for (int v = 0, vn = trianglesTwoColor.vertCount, vv = 0; v < vn; ++v, vv += 2) {
+                            V3F_C4B_C4B_T2F* vertex = trianglesTwoColor.verts + v;
+                            vertex->vertices.x = verts[vv];
+                            vertex->vertices.y = verts[vv + 1];
                             vertex->texCoords.u = uvs[vv];
                             vertex->texCoords.v = uvs[vv + 1];
-                            vertex->color.r = (GLubyte)color.r;
-                            vertex->color.g = (GLubyte)color.g;
-                            vertex->color.b = (GLubyte)color.b;
-                            vertex->color.a = (GLubyte)color.a;
-                            vertex->color2.r = (GLubyte)darkColor.r;
-                            vertex->color2.g = (GLubyte)darkColor.g;
-                            vertex->color2.b = (GLubyte)darkColor.b;
-                            vertex->color2.a = (GLubyte)darkColor.a;
+                            vertex->colors.r = (GLubyte)color.r;
+                            vertex->colors.g = (GLubyte)color.g;
+                            vertex->colors.b = (GLubyte)color.b;
+                            vertex->colors.a = (GLubyte)color.a;
+                            vertex->colors2.r = (GLubyte)darkColor.r;
+                            vertex->colors2.g = (GLubyte)darkColor.g;
+                            vertex->colors2.b = (GLubyte)darkColor.b;
+                            vertex->colors2.a = (GLubyte)darkColor.a;
                         }
                     }
                 }
                 else {
-                    TwoColorTrianglesCommand* batchedTriangles = lastTwoColorTrianglesCommand = twoColorBatch->addCommand(renderer, _globalZOrder, attachmentVertices->_texture->getName(), /*_glProgramState*/nullptr, blendFunc, trianglesTwoColor, transform, transformFlags);
-
                     if (_effect) {
                         spColor light;
                         spColor dark;
@@ -767,80 +771,50 @@ namespace spine {
                         dark.b = darkColor.b / 255.0f;
                         dark.a = darkColor.a / 255.0f;
 
-                        for (int v = 0, vn = batchedTriangles->getTriangles().vertCount; v < vn; ++v) {
-                            V3F_C4B_C4B_T2F* vertex = batchedTriangles->getTriangles().verts + v;
+                        for (int v = 0, vn = trianglesTwoColor.vertCount; v < vn; ++v) {
+                            V3F_C4B_C4B_T2F* vertex = trianglesTwoColor.verts + v;
                             spColor lightCopy = light;
                             spColor darkCopy = dark;
-                            _effect->transform(_effect, &vertex->position.x, &vertex->position.y, &vertex->texCoords.u, &vertex->texCoords.v, &lightCopy, &darkCopy);
-                            vertex->color.r = (GLubyte)(lightCopy.r * 255);
-                            vertex->color.g = (GLubyte)(lightCopy.g * 255);
-                            vertex->color.b = (GLubyte)(lightCopy.b * 255);
-                            vertex->color.a = (GLubyte)(lightCopy.a * 255);
-                            vertex->color2.r = (GLubyte)(darkCopy.r * 255);
-                            vertex->color2.g = (GLubyte)(darkCopy.g * 255);
-                            vertex->color2.b = (GLubyte)(darkCopy.b * 255);
-                            // vertex->color2.a = (GLubyte)darkColor.a;
+                            _effect->transform(_effect, &vertex->vertices.x, &vertex->vertices.y, &vertex->texCoords.u, &vertex->texCoords.v, &lightCopy, &darkCopy);
+                            vertex->colors.r = (GLubyte)(lightCopy.r * 255);
+                            vertex->colors.g = (GLubyte)(lightCopy.g * 255);
+                            vertex->colors.b = (GLubyte)(lightCopy.b * 255);
+                            vertex->colors.a = (GLubyte)(lightCopy.a * 255);
+                            vertex->colors2.r = (GLubyte)(darkCopy.r * 255);
+                            vertex->colors2.g = (GLubyte)(darkCopy.g * 255);
+                            vertex->colors2.b = (GLubyte)(darkCopy.b * 255);
+                            vertex->colors2.a = (GLubyte)darkColor.a;
                         }
                     }
                     else {
-                        for (int v = 0, vn = batchedTriangles->getTriangles().vertCount; v < vn; ++v) {
-                            V3F_C4B_C4B_T2F* vertex = batchedTriangles->getTriangles().verts + v;
-                            vertex->color.r = (GLubyte)color.r;
-                            vertex->color.g = (GLubyte)color.g;
-                            vertex->color.b = (GLubyte)color.b;
-                            vertex->color.a = (GLubyte)color.a;
-                            vertex->color2.r = (GLubyte)darkColor.r;
-                            vertex->color2.g = (GLubyte)darkColor.g;
-                            vertex->color2.b = (GLubyte)darkColor.b;
-                            vertex->color2.a = (GLubyte)darkColor.a;
+                        for (int v = 0, vn = trianglesTwoColor.vertCount; v < vn; ++v) {
+                            V3F_C4B_C4B_T2F* vertex = trianglesTwoColor.verts + v;
+                            vertex->colors.r = (GLubyte)color.r;
+                            vertex->colors.g = (GLubyte)color.g;
+                            vertex->colors.b = (GLubyte)color.b;
+                            vertex->colors.a = (GLubyte)color.a;
+                            vertex->colors2.r = (GLubyte)darkColor.r;
+                            vertex->colors2.g = (GLubyte)darkColor.g;
+                            vertex->colors2.b = (GLubyte)darkColor.b;
+                            vertex->colors2.a = (GLubyte)darkColor.a;
                         }
                     }
                 }
 
+                // The Renderer keeps batching across skeletons, so consecutive two color tinted
+                // skeletons sharing an atlas and a blend mode end up in the same draw call.
+                SharedRendererManager.setCurrent(SharedRenderer.getTarget());
+                SharedRenderer.push(trianglesTwoColor.verts, uint32_t(trianglesTwoColor.vertCount),
+                    trianglesTwoColor.indices, trianglesTwoColor.indexCount,
+                    program_,
+                    attachmentVertices->_texture,
+                    state, attachmentVertices->_texture->getFlags(), transform);
+
                 spSkeletonClipping_clipEnd(_clipper, slot);
             }
         }
 		spSkeletonClipping_clipEnd2(_clipper);
 
-		if (lastTwoColorTrianglesCommand) {
-			Node* parent = this->getParent();
-
-			// We need to decide if we can postpone flushing the current
-			// batch. We can postpone if the next sibling node is a
-			// two color tinted skeleton with the same global-z.
-			// The parent->getChildrenCount() > 100 check is a hack
-			// as checking for a sibling is an O(n) operation, and if
-			// all children of this nodes parent are skeletons, we
-			// are in O(n2) territory.
-			if (!parent || parent->getChildrenCount() > 100 || getChildrenCount() != 0) {
-				lastTwoColorTrianglesCommand->setForceFlush(true);
-			}
-			else {
-				Vector<Node*>& children = parent->getChildren();
-				Node* sibling = nullptr;
-				for (ssize_t i = 0; i < children.size(); i++) {
-					if (children.at(i) == this) {
-						if (i < children.size() - 1) {
-							sibling = children.at(i + 1);
-							break;
-						}
-					}
-				}
-				if (!sibling) {
-					lastTwoColorTrianglesCommand->setForceFlush(true);
-				}
-				else {
-					SkeletonRenderer* siblingSkeleton = CocosCast<SkeletonRenderer>(sibling);
-					if (!siblingSkeleton || // flush is next sibling isn't a SkeletonRenderer
-						!siblingSkeleton->isTwoColorTint() || // flush if next sibling isn't two color tinted
-						!siblingSkeleton->isVisible() || // flush if next sibling is two color tinted but not visible
-						(siblingSkeleton->getGlobalZOrder() != this->getGlobalZOrder())) { // flush if next sibling is two color tinted but z-order differs
-						lastTwoColorTrianglesCommand->setForceFlush(true);
-					}
-				}
-			}
-		}
-
 		if (_effect) _effect->end(_effect);
 
 		if (_debugSlots || _debugBones || _debugMeshes) {
@@ -1057,8 +1031,57 @@ namespace spine {
 		setupGLProgramState(enabled);
 	}
 
+	void SkeletonRenderer::setGpuSkinning(bool enabled) {
+		_gpuSkinning = enabled;
+	}
+
+	bool SkeletonRenderer::isGpuSkinning() const {
+		return _gpuSkinning;
+	}
+
+	SkinnedMesh* SkeletonRenderer::getSkinnedMesh(spMeshAttachment* attachment, AttachmentVertices* attachmentVertices) const {
+		if (attachmentVertices->_skinnedMeshBuilt) {
+			return attachmentVertices->_skinnedMesh.get();
+		}
+		attachmentVertices->_skinnedMeshBuilt = true;
+
+		// Weighted vertices store, per bone, the position local to that bone and the weight.
+		int* bones = attachment->super.bones;
+		float* vertices = attachment->super.vertices;
+		int vertexCount = attachment->super.worldVerticesLength >> 1;
+		std::vector<SkinnedVertex> skinnedVertices(vertexCount);
+		std::vector<int>& palette = attachmentVertices->_skinnedBones;
+		for (int i = 0, v = 0, b = 0; i < vertexCount; ++i) {
+			SkinnedVertex& vertex = skinnedVertices[i];
+			int n = bones[v++];
+			if (n > (int)SkinnedMesh::MAX_INFLUENCES) {
+				palette.clear();
+				return nullptr;
+			}
+			for (int j = 0; j < n; ++j, ++v, b += 3) {
+				auto it = std::find(palette.begin(), palette.end(), bones[v]);
+				if (it == palette.end()) {
+					if (palette.size() == SkinnedMesh::MAX_BONES) {
+						palette.clear();
+						return nullptr;
+					}
+					it = palette.insert(palette.end(), bones[v]);
+				}
+				vertex.positions[j * 2] = vertices[b];
+				vertex.positions[j * 2 + 1] = vertices[b + 1];
+				vertex.weights[j] = vertices[b + 2];
+				vertex.bones[j] = (float)(it - palette.begin());
+			}
+			vertex.u = attachmentVertices->_triangles->verts[i].texCoords.u;
+			vertex.v = attachmentVertices->_triangles->verts[i].texCoords.v;
+		}
+		attachmentVertices->_skinnedMesh = SkinnedMesh::create(skinnedVertices.data(), (uint32_t)vertexCount,
+			attachmentVertices->_triangles->indices, (uint32_t)attachmentVertices->_triangles->indexCount, (uint32_t)palette.size());
+		return attachmentVertices->_skinnedMesh.get();
+	}
+
 	bool SkeletonRenderer::isTwoColorTint() {
-		return false;//getGLProgramState() == SkeletonTwoColorBatch::getInstance()->getTwoColorTintProgramState();
+		return program_.get() == SharedRenderer.getTwoColorProgram();
 	}
     void SkeletonRenderer::setHighLight(bool enabled) {
         if(enabled)
@@ -109,6 +109,13 @@ public:
     void setHighLight(bool enabled);
 
     void setGray(bool gray);
+
+	/* Skins weighted meshes in the vertex shader from their bind pose instead of on the CPU. A mesh falls back
+	 * to the CPU while it is deformed, clipped, two color tinted or under a vertex effect, when it uses more than
+	 * SkinnedMesh::MAX_BONES bones or MAX_INFLUENCES per vertex, or when drawn with a gray or highlight program.
+	 * Every GPU skinned mesh is a draw call of its own. */
+	void setGpuSkinning (bool enabled);
+	bool isGpuSkinning () const;
 	
 	/* Sets the vertex effect to be used, set to 0 to disable vertex effects */
 	void setVertexEffect(spVertexEffect* effect);
@@ -149,6 +156,7 @@ protected:
 	virtual AttachmentVertices* getAttachmentVertices (spRegionAttachment* attachment) const;
 	virtual AttachmentVertices* getAttachmentVertices (spMeshAttachment* attachment) const;
 	void setupGLProgramState(bool twoColorTintEnabled);
+	cocos2d::SkinnedMesh* getSkinnedMesh (spMeshAttachment* attachment, AttachmentVertices* attachmentVertices) const;
 
 	bool _ownsSkeletonData;
 	bool _ownsSkeleton;
@@ -168,7 +176,9 @@ protected:
 	
 	int _startSlotIndex;
 	int _endSlotIndex;
-    COCOS_TYPE_OVERRIDE(SkeletonRenderer);
+	bool _gpuSkinning;
+	std::vector<cocos2d::Vec4> _bonePalette;
+    COCOS_TYPE_OVERRIDE(SkeletonRenderer, cocos2d::Node);
 };
 
 }
@@ -36,12 +36,7 @@
 #include <vector>
 
 namespace spine {
-	struct V3F_C4B_C4B_T2F {
-		cocos2d::Vec3 position;
-		cocos2d::Color4B color;
-		cocos2d::Color4B color2;
-		cocos2d::Tex2F texCoords;
-	};
+	using cocos2d::V3F_C4B_C4B_T2F;
 	
 	struct TwoColorTriangles {
 		V3F_C4B_C4B_T2F* verts;
@@ -49,91 +44,11 @@ namespace spine {
 		int vertCount;
 		int indexCount;
 	};
-    class TwoColorTrianglesCommand
-    {
-    public:
-        TwoColorTrianglesCommand();
-
-        ~TwoColorTrianglesCommand() {}
-
-        inline GLuint getTextureID() const { return _textureID; }
-
-        inline const TwoColorTriangles& getTriangles() const { return _triangles; }
-
-        inline ssize_t getVertexCount() const { return _triangles.vertCount; }
-
-        inline ssize_t getIndexCount() const { return _triangles.indexCount; }
-
-        inline const V3F_C4B_C4B_T2F* getVertices() const { return _triangles.verts; }
-
-        inline const unsigned short* getIndices() const { return _triangles.indices; }
-
-        inline cocos2d::BlendFunc getBlendType() const { return _blendType; }
-
-        inline const cocos2d::Mat4& getModelView() const { return _mv; }
-
-        void setForceFlush(bool forceFlush) { _forceFlush = forceFlush; }
-
-        bool isForceFlush() { return _forceFlush; };
-    private:
-        uint32_t _materialID;
-        GLuint _textureID;
-        cocos2d::BlendFunc _blendType;
-        TwoColorTriangles _triangles;
-        cocos2d::Mat4 _mv;
-        GLuint _alphaTextureID;
-        bool _forceFlush;
-    };
-	
-	/*class TwoColorTrianglesCommand : public cocos2d::CustomCommand {
-	public:
-		TwoColorTrianglesCommand();
-		
-		~TwoColorTrianglesCommand();
-	
-		void init(float globalOrder, GLuint textureID, cocos2d::GLProgramState* glProgramState, cocos2d::BlendFunc blendType, const TwoColorTriangles& triangles, const cocos2d::Mat4& mv, uint32_t flags);
-		
-		void useMaterial() const;
-		
-		inline uint32_t getMaterialID() const { return _materialID; }
-		
-		inline GLuint getTextureID() const { return _textureID; }
-		
-		inline const TwoColorTriangles& getTriangles() const { return _triangles; }
-		
-		inline ssize_t getVertexCount() const { return _triangles.vertCount; }
-		
-		inline ssize_t getIndexCount() const { return _triangles.indexCount; }
-		
-		inline const V3F_C4B_C4B_T2F* getVertices() const { return _triangles.verts; }
-		
-		inline const unsigned short* getIndices() const { return _triangles.indices; }
-		
-		inline cocos2d::GLProgramState* getGLProgramState() const { return _glProgramState; }
-		
-		inline cocos2d::BlendFunc getBlendType() const { return _blendType; }
-		
-		inline const cocos2d::Mat4& getModelView() const { return _mv; }
-		
-		void draw ();
-		
-		void setForceFlush (bool forceFlush) { _forceFlush = forceFlush; }
-		
-		bool isForceFlush () { return _forceFlush; };
-		
-	protected:
-		void generateMaterialID();
-		uint32_t _materialID;
-		GLuint _textureID;
-		cocos2d::GLProgramState* _glProgramState;
-		cocos2d::GLProgram* _glProgram;
-		cocos2d::BlendFunc _blendType;
-		TwoColorTriangles _triangles;
-		cocos2d::Mat4 _mv;
-		GLuint _alphaTextureID;
-		bool _forceFlush;
-	};*/
 
+	/** Scratch memory for the two color tinted vertices of a frame. SkeletonRenderer fills a slot's
+	 * vertices here and pushes them to the Renderer right away, which copies them into its batch, so
+	 * there are no commands to keep alive and reset() only rewinds two offsets. A pointer handed out
+	 * stays valid until the next allocation of the same kind grows the arena. */
     class SkeletonTwoColorBatch {
     public:
         static SkeletonTwoColorBatch* getInstance ();
@@ -147,16 +62,6 @@ namespace spine {
 		
 		unsigned short* allocateIndices(uint32_t numIndices);
 		void deallocateIndices(uint32_t numIndices);
-
-		TwoColorTrianglesCommand* addCommand(cocos2d::IRenderer* renderer, float globalOrder, GLuint textureID, cocos2d::Program* program, cocos2d::BlendFunc blendType, const TwoColorTriangles& triangles, const cocos2d::Mat4& mv, uint32_t flags);
-
-		//cocos2d::GLProgramState* getTwoColorTintProgramState () { return _twoColorTintShaderState; }
-		
-		void batch (TwoColorTrianglesCommand* command);
-		
-		void flush (TwoColorTrianglesCommand* materialCommand);
-		
-		uint32_t getNumBatches () { return _numBatches; };
 		
     protected:
         SkeletonTwoColorBatch ();
@@ -164,40 +69,13 @@ namespace spine {
 
 		void reset ();
 
-		TwoColorTrianglesCommand* nextFreeCommand ();
-
-		// pool of commands
-		std::vector<TwoColorTrianglesCommand*> _commandsPool;
-		uint32_t _nextFreeCommand;
-
-		// pool of vertices
+		// frame arena of vertices
 		std::vector<V3F_C4B_C4B_T2F> _vertices;
 		uint32_t _numVertices;
 		
-		// pool of indices
-		spUnsignedShortArray* _indices;
-		
-		// two color tint shader and state
-		/*cocos2d::GLProgram* _twoColorTintShader;
-		cocos2d::GLProgramState* _twoColorTintShaderState;*/
-		
-		// VBO handles & attribute locations
-		GLuint _vertexBufferHandle;
-		V3F_C4B_C4B_T2F* _vertexBuffer;
-		uint32_t _numVerticesBuffer;
-		GLuint _indexBufferHandle;
-		uint32_t _numIndicesBuffer;
-		unsigned short* _indexBuffer;
-		GLint _positionAttributeLocation;
-		GLint _colorAttributeLocation;
-		GLint _color2AttributeLocation;
-		GLint _texCoordsAttributeLocation;
-		
-		// last batched command, needed for flushing to set material
-		TwoColorTrianglesCommand* _lastCommand;
-		
-		// number of batches in the last frame
-		uint32_t _numBatches;
+		// frame arena of indices
+		std::vector<unsigned short> _indices;
+		uint32_t _numIndices;
 	};
 }
 
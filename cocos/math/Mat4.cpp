@@ -696,6 +696,38 @@ bool Mat4::inverse()
     return true;
 }
 
+Mat4 Mat4::getInversedAffine2D() const
+{
+    Mat4 mat(*this);
+    mat.inverseAffine2D();
+    return mat;
+}
+
+bool Mat4::inverseAffine2D()
+{
+    GP_ASSERT(isAffine2D());
+
+    float det = m[0] * m[5] - m[1] * m[4];
+
+    // Close to zero, can't invert.
+    if (std::abs(det) <= MATH_TOLERANCE || std::abs(m[10]) <= MATH_TOLERANCE)
+        return false;
+
+    float invDet = 1.0f / det;
+    float a = m[5] * invDet, b = -m[1] * invDet;
+    float c = -m[4] * invDet, d = m[0] * invDet;
+    float tx = m[12], ty = m[13];
+
+    m[0] = a, m[1] = b;
+    m[4] = c, m[5] = d;
+    m[12] = -(a * tx + c * ty);
+    m[13] = -(b * tx + d * ty);
+    m[10] = 1.0f / m[10];
+    m[14] = -m[14] * m[10];
+
+    return true;
+}
+
 bool Mat4::isIdentity() const
 {
     return (memcmp(m, &IDENTITY, MATRIX_SIZE) == 0);
@@ -736,6 +768,36 @@ void Mat4::multiply(const Mat4& m1, const Mat4& m2, Mat4* dst)
 #endif
 }
 
+void Mat4::multiplyAffine2D(const Mat4& m1, const Mat4& m2, Mat4* dst)
+{
+    GP_ASSERT(dst);
+    GP_ASSERT(m2.isAffine2D());
+#ifdef __SSE__
+    // m2 columns 0 and 1 only weight the first two columns of m1, column 2 only scales z
+    __m128 c0 = _mm_add_ps(_mm_mul_ps(m1.col[0], _mm_set1_ps(m2.m[0])), _mm_mul_ps(m1.col[1], _mm_set1_ps(m2.m[1])));
+    __m128 c1 = _mm_add_ps(_mm_mul_ps(m1.col[0], _mm_set1_ps(m2.m[4])), _mm_mul_ps(m1.col[1], _mm_set1_ps(m2.m[5])));
+    __m128 c2 = _mm_mul_ps(m1.col[2], _mm_set1_ps(m2.m[10]));
+    __m128 c3 = _mm_add_ps(
+        _mm_add_ps(_mm_mul_ps(m1.col[0], _mm_set1_ps(m2.m[12])), _mm_mul_ps(m1.col[1], _mm_set1_ps(m2.m[13]))),
+        _mm_add_ps(_mm_mul_ps(m1.col[2], _mm_set1_ps(m2.m[14])), m1.col[3]));
+    dst->col[0] = c0;
+    dst->col[1] = c1;
+    dst->col[2] = c2;
+    dst->col[3] = c3;
+#else
+    // Support the case where m1 or m2 is the same array as dst.
+    float product[16];
+    for (int i = 0; i < 4; i++)
+    {
+        product[i] = m1.m[i] * m2.m[0] + m1.m[4 + i] * m2.m[1];
+        product[4 + i] = m1.m[i] * m2.m[4] + m1.m[4 + i] * m2.m[5];
+        product[8 + i] = m1.m[8 + i] * m2.m[10];
+        product[12 + i] = m1.m[i] * m2.m[12] + m1.m[4 + i] * m2.m[13] + m1.m[8 + i] * m2.m[14] + m1.m[12 + i];
+    }
+    memcpy(dst->m, product, MATRIX_SIZE);
+#endif
+}
+
 void Mat4::negate()
 {
 #ifdef __SSE__
@@ -508,6 +508,29 @@ public:
      */
     Mat4 getInversed() const;
 
+    /**
+     * Inverts this matrix, which must be affine 2D (see isAffine2D).
+     *
+     * @return true if the matrix can be inverted, false otherwise.
+     */
+    bool inverseAffine2D();
+
+    /**
+     * Get the inversed matrix of this affine 2D matrix (see isAffine2D).
+     */
+    Mat4 getInversedAffine2D() const;
+
+    /**
+     * Determines if this matrix only scales, rotates, skews and translates in the xy plane,
+     * z being scaled and translated apart and w left untouched.
+     * Such a matrix multiplies, inverts and transforms points with a fraction of the math.
+     */
+    inline bool isAffine2D() const
+    {
+        return m[2] == 0.0f && m[3] == 0.0f && m[6] == 0.0f && m[7] == 0.0f
+            && m[8] == 0.0f && m[9] == 0.0f && m[11] == 0.0f && m[15] == 1.0f;
+    }
+
     /**
      * Determines if this matrix is equal to the identity matrix.
      *
@@ -555,6 +578,15 @@ public:
      */
     static void multiply(const Mat4& m1, const Mat4& m2, Mat4* dst);
 
+    /**
+     * Multiplies m1 by the affine 2D matrix m2 (see isAffine2D) and stores the result in dst.
+     *
+     * @param m1 The first matrix to multiply.
+     * @param m2 The affine 2D matrix to multiply.
+     * @param dst A matrix to store the result in.
+     */
+    static void multiplyAffine2D(const Mat4& m1, const Mat4& m2, Mat4* dst);
+
     /**
      * Negates this matrix.
      */
@@ -788,6 +820,23 @@ public:
      */
     inline void transformPoint(const Vec3& point, Vec3* dst) const { GP_ASSERT(dst); transformVector(point.x, point.y, point.z, 1.0f, dst); }
 
+    /**
+     * Transforms the specified point by this affine 2D matrix (see isAffine2D),
+     * and stores the result in dst.
+     *
+     * @param point The point to transform.
+     * @param dst A vector to store the transformed point in.
+     */
+    inline void transformPointAffine2D(const Vec3& point, Vec3* dst) const
+    {
+        GP_ASSERT(dst);
+        float x = m[0] * point.x + m[4] * point.y + m[12];
+        float y = m[1] * point.x + m[5] * point.y + m[13];
+        dst->z = m[10] * point.z + m[14];
+        dst->x = x;
+        dst->y = y;
+    }
+
     /**
      * Transforms the specified vector by this matrix by
      * treating the fourth (w) coordinate as zero.
@@ -8,6 +8,7 @@ LOCAL_MODULE_FILENAME := libnetwork
 LOCAL_ARM_MODE := arm
 
 LOCAL_SRC_FILES := HttpClient-android.cpp \
+HttpClient-common.cpp \
 SocketIO.cpp \
 WebSocket-libwebsockets.cpp \
 CCDownloader.cpp \
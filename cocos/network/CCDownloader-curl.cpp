@@ -25,12 +25,16 @@
 #include "ccHeader.h"
 #include "network/CCDownloader-curl.h"
 
+#include <atomic>
+#include <mutex>
 #include <curl/curl.h>
 
 #include "base/CCDirector.h"
 #include "base/CCScheduler.h"
+#include "base/ccUtils.h"
 #include "platform/CCFileUtils.h"
 #include "network/CCDownloader.h"
+#include "xxhash/xxhash.h"
 
 // **NOTE**
 // In the file:
@@ -53,9 +57,24 @@ namespace cocos2d { namespace network {
     public:
         int serialId;
 
+        // One range request of a segmented file task, written in place into the temp file
+        struct Segment
+        {
+            DownloadTaskCURL* owner;
+            int64_t offset;
+            int64_t length;
+            int64_t received;
+            XXH32_stateSpace_t hashState;   // of the received bytes
+            FILE* fp;
+            CURL* handle;
+            bool rangeChecked;
+        };
+
         DownloadTaskCURL()
         : serialId(_sSerialId++)
         , _fp(nullptr)
+        , _task(nullptr)
+        , _receivedCounter(nullptr)
         {
             _initInternal();
             DLLOG("Construct DownloadTaskCURL %p", this);
@@ -74,6 +93,7 @@ namespace cocos2d { namespace network {
                 fclose(_fp);
                 _fp = nullptr;
             }
+            closeSegmentsProc();
             DLLOG("Destruct DownloadTaskCURL %p", this);
         }
 
@@ -166,6 +186,10 @@ namespace cocos2d { namespace network {
             size_t ret = 0;
             if (_fp)
             {
+                if (_onData)
+                {
+                    _onData(*_task, buffer, size * count);
+                }
                 ret = fwrite(buffer, size, count, _fp);
             }
             else
@@ -183,10 +207,187 @@ namespace cocos2d { namespace network {
             {
                 _bytesReceived += ret;
                 _totalBytesReceived += ret;
+                if (_receivedCounter)
+                {
+                    *_receivedCounter += ret;
+                }
             }
             return ret;
         }
 
+        size_t writeSegmentProc(Segment& segment, unsigned char *buffer, size_t size, size_t count)
+        {
+            lock_guard<mutex> lock(_mutex);
+            size_t len = size * count;
+            // a server sending more than the requested range is not trusted with the rest either
+            if (segment.received + (int64_t)len > segment.length || len != fwrite(buffer, 1, len, segment.fp))
+            {
+                return 0;
+            }
+            XXH32_update(&segment.hashState, buffer, (int)len);
+            segment.received += len;
+            _bytesReceived += len;
+            _totalBytesReceived += len;
+            if (_receivedCounter)
+            {
+                *_receivedCounter += len;
+            }
+            return len;
+        }
+
+        string segmentMapPath() const
+        {
+            return _tempFileName + SEGMENT_MAP_SUFFIX;
+        }
+
+        bool segmented() const
+        {
+            return !_segments.empty();
+        }
+
+        // Loads the segments of a previous attempt, for the file of the given size and ETag, and checks
+        // the bytes they received against their hashes; a segment whose bytes changed starts over.
+        bool loadSegmentsProc(int64_t totalSize, const string& validator)
+        {
+            FILE *fp = fopen(FileUtils::getInstance()->getSuitableFOpen(segmentMapPath()).c_str(), "rb");
+            if (nullptr == fp)
+            {
+                return false;
+            }
+            vector<unique_ptr<Segment>> segments;
+            vector<unsigned int> hashes;
+            bool ok = false;
+            do
+            {
+                char magic[16] = {0};
+                char etag[256] = {0};
+                int version = 0;
+                long long size = 0;
+                unsigned int count = 0;
+                if (5 != fscanf(fp, "%15s %d %lld %255s %u", magic, &version, &size, etag, &count)
+                    || 0 != strcmp(magic, SEGMENT_MAP_MAGIC) || SEGMENT_MAP_VERSION != version
+                    || size != totalSize || validator != etag || 0 == count || count > MAX_SEGMENTS)
+                {
+                    break;
+                }
+                int64_t offset = 0;
+                for (unsigned int i = 0; i < count; ++i)
+                {
+                    long long segOffset = 0, segLength = 0, segReceived = 0;
+                    unsigned int hash = 0;
+                    if (4 != fscanf(fp, "%lld %lld %lld %u", &segOffset, &segLength, &segReceived, &hash)
+                        || segOffset != offset || segLength <= 0 || segReceived < 0 || segReceived > segLength)
+                    {
+                        break;
+                    }
+                    segments.push_back(_newSegment(segOffset, segLength, segReceived));
+                    hashes.push_back(hash);
+                    offset += segLength;
+                }
+                ok = segments.size() == count && offset == totalSize;
+            } while (0);
+            fclose(fp);
+            if (!ok)
+            {
+                return false;
+            }
+
+            _segments = std::move(segments);
+            if (!_openSegmentsProc())
+            {
+                return false;
+            }
+            for (size_t i = 0; i < _segments.size(); ++i)
+            {
+                if (XXH32_intermediateDigest(&_segments[i]->hashState) != hashes[i])
+                {
+                    DLLOG("    segment %d of %s changed, downloading it again", (int)i, _tempFileName.c_str());
+                    _resetSegmentProc(*_segments[i]);
+                }
+            }
+            return true;
+        }
+
+        // Splits the file into count segments, the first one keeps what a single stream left in the temp file
+        bool createSegmentsProc(int64_t totalSize, uint32_t count, int64_t partialSize)
+        {
+            count = std::min(count, MAX_SEGMENTS);
+            int64_t length = (totalSize + count - 1) / count;
+            _segments.clear();
+            for (int64_t offset = 0; offset < totalSize; offset += length)
+            {
+                int64_t segLength = std::min(length, totalSize - offset);
+                _segments.push_back(_newSegment(offset, segLength, offset ? 0 : std::min(partialSize, segLength)));
+            }
+            return _openSegmentsProc();
+        }
+
+        // written before the first range request, so the temp file is never taken for a single stream
+        bool saveSegmentsProc(const string& validator)
+        {
+            FILE *fp = fopen(FileUtils::getInstance()->getSuitableFOpen(segmentMapPath()).c_str(), "wb");
+            if (nullptr == fp)
+            {
+                return false;
+            }
+            int64_t totalSize = 0;
+            for (auto& segment : _segments)
+            {
+                // the hashes must not cover bytes still in the stdio buffers
+                fflush(segment->fp);
+                totalSize += segment->length;
+            }
+            fprintf(fp, "%s %d %lld %s %u\n", SEGMENT_MAP_MAGIC, SEGMENT_MAP_VERSION,
+                    (long long)totalSize, validator.c_str(), (unsigned int)_segments.size());
+            for (auto& segment : _segments)
+            {
+                lock_guard<mutex> lock(_mutex);
+                fprintf(fp, "%lld %lld %lld %u\n", (long long)segment->offset, (long long)segment->length,
+                        (long long)segment->received, XXH32_intermediateDigest(&segment->hashState));
+            }
+            bool ok = 0 == ferror(fp);
+            fclose(fp);
+            return ok;
+        }
+
+        void closeSegmentsProc()
+        {
+            for (auto& segment : _segments)
+            {
+                if (segment->fp)
+                {
+                    fclose(segment->fp);
+                    segment->fp = nullptr;
+                }
+            }
+        }
+
+        // drops what a previous attempt left, for downloading the file as a single stream
+        void truncateProc()
+        {
+            lock_guard<mutex> lock(_mutex);
+            closeSegmentsProc();
+            _segments.clear();
+            FileUtils::getInstance()->removeFile(segmentMapPath());
+            if (_fp)
+            {
+                _fp = freopen(FileUtils::getInstance()->getSuitableFOpen(_tempFileName).c_str(), "wb", _fp);
+            }
+            _totalBytesReceived = 0;
+        }
+
+        // size of the data a previous attempt left in the temp file
+        int64_t partialFileSizeProc()
+        {
+            lock_guard<mutex> lock(_mutex);
+            if (nullptr == _fp || 0 != utils::fseek64(_fp, 0, SEEK_END))
+            {
+                return 0;
+            }
+            int64_t size = utils::ftell64(_fp);
+            return size > 0 ? size : 0;
+        }
+
     private:
         friend class DownloaderCURL;
 
@@ -215,6 +416,81 @@ namespace cocos2d { namespace network {
         vector<unsigned char> _buf;
         FILE*  _fp;
 
+        // for observing file data, set by DownloaderCURL::createCoTask
+        const DownloadTask* _task;
+        function<void(const DownloadTask&, const unsigned char*, size_t)> _onData;
+
+        // bytes received by all the tasks of the work thread, for tuning the concurrency
+        atomic<int64_t>* _receivedCounter;
+
+        // a content request of at least _splitThreshold bytes is aborted at its headers to be split, 0 never
+        int64_t _splitThreshold;
+        bool    _splitRequested;
+
+        // for segmented download
+        static const char* SEGMENT_MAP_SUFFIX;
+        static const char* SEGMENT_MAP_MAGIC;
+        static const int SEGMENT_MAP_VERSION = 1;
+        static const uint32_t MAX_SEGMENTS = 16;
+        vector<unique_ptr<Segment>> _segments;
+        string _validator;      // ETag of the file the segments belong to
+
+        unique_ptr<Segment> _newSegment(int64_t offset, int64_t length, int64_t received)
+        {
+            unique_ptr<Segment> segment(new Segment);
+            segment->owner = this;
+            segment->offset = offset;
+            segment->length = length;
+            segment->received = received;
+            segment->fp = nullptr;
+            segment->handle = nullptr;
+            segment->rangeChecked = false;
+            return segment;
+        }
+
+        // opens a handle for each segment at its write position, hashing the bytes it already received
+        bool _openSegmentsProc()
+        {
+            static const size_t HASH_BUFFER_SIZE = 64 * 1024;
+            vector<unsigned char> buffer(HASH_BUFFER_SIZE);
+            auto path = FileUtils::getInstance()->getSuitableFOpen(_tempFileName);
+            for (auto& segment : _segments)
+            {
+                segment->fp = fopen(path.c_str(), "r+b");
+                if (nullptr == segment->fp || 0 != utils::fseek64(segment->fp, segment->offset, SEEK_SET))
+                {
+                    return false;
+                }
+                XXH32_resetState(&segment->hashState, 0);
+                int64_t left = segment->received;
+                while (left > 0)
+                {
+                    size_t len = fread(buffer.data(), 1, (size_t)std::min<int64_t>(left, HASH_BUFFER_SIZE), segment->fp);
+                    if (0 == len)
+                    {
+                        break;
+                    }
+                    XXH32_update(&segment->hashState, buffer.data(), (int)len);
+                    left -= len;
+                }
+                if (left > 0)
+                {
+                    // the temp file is shorter than the map says
+                    _resetSegmentProc(*segment);
+                }
+                // switching from reading to writing needs a seek
+                utils::fseek64(segment->fp, segment->offset + segment->received, SEEK_SET);
+            }
+            return true;
+        }
+
+        void _resetSegmentProc(Segment& segment)
+        {
+            segment.received = 0;
+            XXH32_resetState(&segment.hashState, 0);
+            utils::fseek64(segment.fp, segment.offset, SEEK_SET);
+        }
+
         void _initInternal()
         {
             _acceptRanges = (false);
@@ -222,6 +498,8 @@ namespace cocos2d { namespace network {
             _bytesReceived = (0);
             _totalBytesReceived = (0);
             _totalBytesExpected = (0);
+            _splitThreshold = (0);
+            _splitRequested = (false);
             _errCode = (DownloadTask::ERROR_NO_ERROR);
             _errCodeInternal = (CURLE_OK);
             _header.resize(0);
@@ -230,9 +508,106 @@ namespace cocos2d { namespace network {
     };
     int DownloadTaskCURL::_sSerialId;
     set<string> DownloadTaskCURL::_sStoragePathSet;
+    const char* DownloadTaskCURL::SEGMENT_MAP_SUFFIX = ".seg";
+    const char* DownloadTaskCURL::SEGMENT_MAP_MAGIC = "CCSEGMAP";
+    const int DownloadTaskCURL::SEGMENT_MAP_VERSION;
+    const uint32_t DownloadTaskCURL::MAX_SEGMENTS;
 
     typedef pair< shared_ptr<const DownloadTask>, DownloadTaskCURL *> TaskWrapper;
 
+////////////////////////////////////////////////////////////////////////////////
+//  Implementation ConcurrencyTuner
+    // Hill climbs the count of processing tasks: keeps moving the limit the same way while the
+    // throughput measured over each window improves, turns back when it drops and holds on a plateau.
+    // The received bytes are counted by the write callbacks, the rest is locked since a work thread
+    // ending and the next one starting may both use it.
+    class ConcurrencyTuner
+    {
+        static const uint32_t MIN_LIMIT = 2;
+        static const uint32_t INITIAL_LIMIT = 8;
+        static const uint32_t UNBOUNDED_LIMIT = 64;
+        static const int32_t  STEP = 2;
+    public:
+        ConcurrencyTuner()
+        : _limit(INITIAL_LIMIT)
+        , _maxLimit(UNBOUNDED_LIMIT)
+        , _step(STEP)
+        , _lastRate(0)
+        , _bytes(0)
+        {
+        }
+
+        void init(uint32_t maxLimit)
+        {
+            lock_guard<mutex> lock(_mutex);
+            _maxLimit = maxLimit ? maxLimit : UNBOUNDED_LIMIT;
+            _limit = INITIAL_LIMIT < _maxLimit ? INITIAL_LIMIT : _maxLimit;
+        }
+
+        uint32_t limit()
+        {
+            lock_guard<mutex> lock(_mutex);
+            return _limit;
+        }
+
+        atomic<int64_t>* counter() { return &_bytes; }
+
+        // the thread has been idle, the bytes of the next window are not comparable with the last one
+        void restartWindowProc()
+        {
+            lock_guard<mutex> lock(_mutex);
+            _bytes = 0;
+            _lastRate = 0;
+            _windowStart = chrono::steady_clock::now();
+        }
+
+        // saturated: the limit, not the queue, bounded the tasks in this window
+        void updateProc(bool saturated)
+        {
+            static const double WINDOW_SECONDS = 1.0;
+            static const double TOLERANCE = 0.1;
+
+            lock_guard<mutex> lock(_mutex);
+            auto now = chrono::steady_clock::now();
+            double elapsed = chrono::duration<double>(now - _windowStart).count();
+            if (elapsed < WINDOW_SECONDS)
+            {
+                return;
+            }
+            double rate = _bytes.exchange(0) / elapsed;
+            _windowStart = now;
+
+            double lastRate = _lastRate;
+            _lastRate = rate;
+            if (false == saturated || rate <= 0)
+            {
+                return;
+            }
+            if (rate < lastRate * (1 - TOLERANCE))
+            {
+                _step = -_step;
+            }
+            else if (rate <= lastRate * (1 + TOLERANCE))
+            {
+                return;
+            }
+
+            int64_t next = (int64_t)_limit + _step;
+            int64_t minLimit = MIN_LIMIT < _maxLimit ? MIN_LIMIT : _maxLimit;
+            _limit = (uint32_t)(next < minLimit ? minLimit : (next > _maxLimit ? _maxLimit : next));
+            DLLOG("    ConcurrencyTuner: %.0f bytes/s, limit %u", rate, _limit);
+        }
+
+    private:
+        uint32_t _limit;
+        uint32_t _maxLimit;
+        int32_t  _step;
+        double   _lastRate;
+        atomic<int64_t> _bytes;
+        chrono::steady_clock::time_point _windowStart;
+        mutex    _mutex;
+    };
+
 ////////////////////////////////////////////////////////////////////////////////
 //  Implementation DownloaderCURL::Impl
     // This class shared by DownloaderCURL and work thread.
@@ -245,11 +620,33 @@ namespace cocos2d { namespace network {
 //        : _thread(nullptr)
         {
             DLLOG("Construct DownloaderCURL::Impl %p", this);
+            // DNS lookups, TLS sessions and, with libcurl 7.57 or later, connections
+            // outlive the work thread, which exits whenever the queue drains
+            _shareHandle = curl_share_init();
+            if (_shareHandle)
+            {
+                curl_share_setopt(_shareHandle, CURLSHOPT_LOCKFUNC, DownloaderCURL::Impl::_lockShareProc);
+                curl_share_setopt(_shareHandle, CURLSHOPT_UNLOCKFUNC, DownloaderCURL::Impl::_unlockShareProc);
+                curl_share_setopt(_shareHandle, CURLSHOPT_USERDATA, this);
+                curl_share_setopt(_shareHandle, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS);
+                curl_share_setopt(_shareHandle, CURLSHOPT_SHARE, CURL_LOCK_DATA_SSL_SESSION);
+                curl_share_setopt(_shareHandle, CURLSHOPT_SHARE, CURL_LOCK_DATA_CONNECT);
+            }
         }
 
         ~Impl()
         {
             DLLOG("Destruct DownloaderCURL::Impl %p %d", this, _thread.joinable());
+            if (_shareHandle)
+            {
+                curl_share_cleanup(_shareHandle);
+            }
+        }
+
+        void setHints(const DownloaderHints& value)
+        {
+            hints = value;
+            _tuner.init(hints.countOfMaxProcessingTasks);
         }
 
         void addTask(std::shared_ptr<const DownloadTask> task, DownloadTaskCURL* coTask)
@@ -307,6 +704,61 @@ namespace cocos2d { namespace network {
         }
 
     private:
+        // a stopped thread may still be running when the next one starts, both use the share handle
+        static void _lockShareProc(CURL *handle, curl_lock_data data, curl_lock_access access, void *userptr)
+        {
+            Impl *impl = (Impl*)userptr;
+            impl->_shareMutex[data < CURL_LOCK_DATA_LAST ? data : 0].lock();
+        }
+
+        static void _unlockShareProc(CURL *handle, curl_lock_data data, void *userptr)
+        {
+            Impl *impl = (Impl*)userptr;
+            impl->_shareMutex[data < CURL_LOCK_DATA_LAST ? data : 0].unlock();
+        }
+
+        // headers of a content request, which may not have been preceded by a header request
+        static size_t _contentHeaderCallbackProc(void *buffer, size_t size, size_t count, void *userdata)
+        {
+            size_t len = size * count;
+            DownloadTaskCURL& coTask = *((DownloadTaskCURL*)(userdata));
+            string line((const char *)buffer, len);
+            if (0 == line.compare(0, 5, "HTTP/"))
+            {
+                // a new response, after a redirect
+                coTask._header.resize(0);
+            }
+            coTask._header.append(line);
+            if ("\r\n" != line && "\n" != line)
+            {
+                return len;
+            }
+
+            // end of the headers
+            string contentLength = _headerValueProc(coTask._header, "Content-Length");
+            int64_t totalBytesExpected = 0;
+            {
+                lock_guard<mutex> lock(coTask._mutex);
+                if (contentLength.length())
+                {
+                    coTask._totalBytesExpected = coTask._totalBytesReceived + strtoll(contentLength.c_str(), nullptr, 10);
+                }
+                totalBytesExpected = coTask._totalBytesExpected;
+            }
+
+            // a large file requested at once is split into range requests instead, see _startSegmentsProc
+            long httpResponseCode = 0;
+            sscanf(coTask._header.c_str(), "HTTP/%*s %ld", &httpResponseCode);
+            if (coTask._splitThreshold > 0 && 200 == httpResponseCode && totalBytesExpected >= coTask._splitThreshold
+                && string::npos != _headerValueProc(coTask._header, "Accept-Ranges").find("bytes"))
+            {
+                coTask._splitRequested = true;
+                coTask._acceptRanges = true;
+                return 0;
+            }
+            return len;
+        }
+
         static size_t _outputHeaderCallbackProc(void *buffer, size_t size, size_t count, void *userdata)
         {
             int strLen = int(size * count);
@@ -325,17 +777,74 @@ namespace cocos2d { namespace network {
             return coTask->writeDataProc((unsigned char *)buffer, size, count);
         }
 
+        static size_t _outputSegmentCallbackProc(void *buffer, size_t size, size_t count, void *userdata)
+        {
+            DownloadTaskCURL::Segment& segment = *((DownloadTaskCURL::Segment*)userdata);
+            if (!segment.rangeChecked)
+            {
+                // a server ignoring the range sends the whole file from its start
+                long httpResponseCode = 0;
+                curl_easy_getinfo(segment.handle, CURLINFO_RESPONSE_CODE, &httpResponseCode);
+                if (206 != httpResponseCode)
+                {
+                    return 0;
+                }
+                segment.rangeChecked = true;
+            }
+            return segment.owner->writeSegmentProc(segment, (unsigned char *)buffer, size, count);
+        }
+
+        // value of a header in the header string of a response, empty if missing
+        static string _headerValueProc(const string& header, const char *name)
+        {
+            size_t nameLen = strlen(name);
+            size_t lineStart = 0;
+            while (lineStart < header.size())
+            {
+                size_t lineEnd = header.find('\n', lineStart);
+                if (string::npos == lineEnd)
+                {
+                    lineEnd = header.size();
+                }
+                size_t i = 0;
+                while (i < nameLen && lineStart + i < lineEnd
+                       && tolower((unsigned char)header[lineStart + i]) == tolower((unsigned char)name[i]))
+                {
+                    ++i;
+                }
+                if (nameLen == i && lineStart + i < lineEnd && ':' == header[lineStart + i])
+                {
+                    size_t valueStart = header.find_first_not_of(" \t", lineStart + i + 1);
+                    size_t valueEnd = header.find_last_not_of(" \t\r\n", lineEnd);
+                    if (string::npos != valueStart && string::npos != valueEnd && valueEnd >= valueStart && valueEnd < lineEnd + 1)
+                    {
+                        return header.substr(valueStart, valueEnd - valueStart + 1);
+                    }
+                    return string();
+                }
+                lineStart = lineEnd + 1;
+            }
+            return string();
+        }
+
         // this function designed call in work thread
         // the curl handle destroyed in _threadProc
         // handle inited for get header
-        void _initCurlHandleProc(CURL *handle, TaskWrapper& wrapper, bool forContent = false)
+        void _initCurlHandleProc(CURL *handle, TaskWrapper& wrapper, bool forContent = false, DownloadTaskCURL::Segment *segment = nullptr)
         {
             const DownloadTask& task = *wrapper.first;
-            const DownloadTaskCURL* coTask = wrapper.second;
+            DownloadTaskCURL* coTask = wrapper.second;
 
             // set url
             curl_easy_setopt(handle, CURLOPT_URL, task.requestURL.c_str());
 
+            if (_shareHandle)
+            {
+                curl_easy_setopt(handle, CURLOPT_SHARE, _shareHandle);
+            }
+            // multiplex over an HTTP/2 connection to the same host rather than opening another one
+            curl_easy_setopt(handle, CURLOPT_PIPEWAIT, 1L);
+
             // set write func
             if (forContent)
             {
@@ -354,13 +863,28 @@ namespace cocos2d { namespace network {
             curl_easy_setopt(handle, CURLOPT_FAILONERROR, true);
             curl_easy_setopt(handle, CURLOPT_NOSIGNAL, 1L);
 
-            if (forContent)
+            if (segment)
+            {
+                char range[64];
+                sprintf(range, "%lld-%lld", (long long)(segment->offset + segment->received),
+                        (long long)(segment->offset + segment->length - 1));
+                curl_easy_setopt(handle, CURLOPT_RANGE, range);
+                curl_easy_setopt(handle, CURLOPT_WRITEFUNCTION, DownloaderCURL::Impl::_outputSegmentCallbackProc);
+                curl_easy_setopt(handle, CURLOPT_WRITEDATA, segment);
+                segment->handle = handle;
+                segment->rangeChecked = false;
+                coTask->_receivedCounter = hints.adaptiveConcurrency ? _tuner.counter() : nullptr;
+            }
+            else if (forContent)
             {
                 /** if server acceptRanges and local has part of file, we continue to download **/
                 if (coTask->_acceptRanges && coTask->_totalBytesReceived > 0)
                 {
                     curl_easy_setopt(handle, CURLOPT_RESUME_FROM_LARGE,(curl_off_t)coTask->_totalBytesReceived);
                 }
+                curl_easy_setopt(handle, CURLOPT_HEADERFUNCTION, DownloaderCURL::Impl::_contentHeaderCallbackProc);
+                curl_easy_setopt(handle, CURLOPT_HEADERDATA, coTask);
+                coTask->_receivedCounter = hints.adaptiveConcurrency ? _tuner.counter() : nullptr;
             }
             else
             {
@@ -451,6 +975,114 @@ namespace cocos2d { namespace network {
             return coTask._headerAchieved;
         }
 
+        bool _segmentableProc(const DownloadTaskCURL& coTask) const
+        {
+            return hints.countOfSegments > 1 && coTask._tempFileName.length();
+        }
+
+        // After the header request of a file task: continues the segments of a previous attempt, or splits
+        // a large file whose server accepts ranges into segments, and adds their range requests.
+        // Returns -1 when the file is downloaded as a single stream, else the count of requests added;
+        // 0 means the task is finished, the file complete or the error set.
+        int _startSegmentsProc(CURLM *curlmHandle, TaskWrapper& wrapper,
+                               unordered_map<CURL*, TaskWrapper>& coTaskMap,
+                               unordered_map<CURL*, DownloadTaskCURL::Segment*>& segmentHandles)
+        {
+            DownloadTaskCURL& coTask = *wrapper.second;
+            string validator = _headerValueProc(coTask._header, "ETag");
+            if (validator.empty() || string::npos != validator.find_first_of(" \t"))
+            {
+                validator = "-";
+            }
+
+            int64_t totalSize = coTask._totalBytesExpected;
+            int64_t threshold = std::max<int64_t>(hints.segmentThreshold, 1);
+            bool splittable = coTask._acceptRanges && totalSize >= threshold;
+            bool resumed = splittable && coTask.loadSegmentsProc(totalSize, validator);
+            if (!resumed)
+            {
+                // a stale segment map means the temp file has holes
+                if (coTask.segmented() || FileUtils::getInstance()->isFileExist(coTask.segmentMapPath()))
+                {
+                    coTask.truncateProc();
+                }
+                if (!splittable || !coTask.createSegmentsProc(totalSize, hints.countOfSegments, coTask._totalBytesReceived))
+                {
+                    if (coTask.segmented())
+                    {
+                        coTask.truncateProc();
+                    }
+                    return -1;
+                }
+            }
+            coTask._validator = validator;
+            if (!coTask.saveSegmentsProc(validator))
+            {
+                coTask.setErrorProc(DownloadTask::ERROR_FILE_OP_FAILED, 0, "Can't save segment map.");
+                return 0;
+            }
+
+            int64_t received = 0;
+            for (auto& segment : coTask._segments)
+            {
+                received += segment->received;
+            }
+            {
+                lock_guard<mutex> lock(coTask._mutex);
+                coTask._totalBytesReceived = received;
+            }
+            DLLOG("    _threadProc %s in %d segments, %lld bytes left", wrapper.first->requestURL.c_str(),
+                  (int)coTask._segments.size(), (long long)(totalSize - received));
+
+            int added = 0;
+            for (auto& segment : coTask._segments)
+            {
+                if (segment->received == segment->length)
+                {
+                    continue;
+                }
+                CURL* curlHandle = curl_easy_init();
+                CURLMcode mcode = CURLM_OK;
+                if (curlHandle)
+                {
+                    _initCurlHandleProc(curlHandle, wrapper, true, segment.get());
+                    mcode = curl_multi_add_handle(curlmHandle, curlHandle);
+                }
+                if (nullptr == curlHandle || CURLM_OK != mcode)
+                {
+                    if (curlHandle)
+                    {
+                        curl_easy_cleanup(curlHandle);
+                    }
+                    segment->handle = nullptr;
+                    coTask.setErrorProc(DownloadTask::ERROR_IMPL_INTERNAL, mcode, "Add segment request failed.");
+                    _abortSegmentsProc(curlmHandle, coTask, coTaskMap, segmentHandles);
+                    return 0;
+                }
+                coTaskMap[curlHandle] = wrapper;
+                segmentHandles[curlHandle] = segment.get();
+                ++added;
+            }
+            return added;
+        }
+
+        void _abortSegmentsProc(CURLM *curlmHandle, DownloadTaskCURL& coTask,
+                                unordered_map<CURL*, TaskWrapper>& coTaskMap,
+                                unordered_map<CURL*, DownloadTaskCURL::Segment*>& segmentHandles)
+        {
+            for (auto& segment : coTask._segments)
+            {
+                if (segment->handle)
+                {
+                    curl_multi_remove_handle(curlmHandle, segment->handle);
+                    curl_easy_cleanup(segment->handle);
+                    coTaskMap.erase(segment->handle);
+                    segmentHandles.erase(segment->handle);
+                    segment->handle = nullptr;
+                }
+            }
+        }
+
         void _threadProc()
         {
             DLLOG("++++DownloaderCURL::Impl::_threadProc begin %p", this);
@@ -458,12 +1090,18 @@ namespace cocos2d { namespace network {
             auto holder = this->shared_from_this();
             auto thisThreadId = this_thread::get_id();
             uint32_t countOfMaxProcessingTasks = this->hints.countOfMaxProcessingTasks;
+            if (this->hints.adaptiveConcurrency)
+            {
+                _tuner.restartWindowProc();
+            }
             // init curl content
             CURLM* curlmHandle = curl_multi_init();
+            curl_multi_setopt(curlmHandle, CURLMOPT_PIPELINING, CURLPIPE_MULTIPLEX);
             unordered_map<CURL*, TaskWrapper> coTaskMap;
+            unordered_map<CURL*, DownloadTaskCURL::Segment*> segmentHandles;
+            auto segmentMapSaved = chrono::steady_clock::now();
             int runningHandles = 0;
             CURLMcode mcode = CURLM_OK;
-            int rc = 0;                 // select return code
 
             do
             {
@@ -488,41 +1126,20 @@ namespace cocos2d { namespace network {
                         timeoutMS = 1000;
                     }
 
-                    /* get file descriptors from the transfers */
-                    fd_set fdread;
-                    fd_set fdwrite;
-                    fd_set fdexcep;
-                    int maxfd = -1;
-
-                    FD_ZERO(&fdread);
-                    FD_ZERO(&fdwrite);
-                    FD_ZERO(&fdexcep);
-
-                    mcode = curl_multi_fdset(curlmHandle, &fdread, &fdwrite, &fdexcep, &maxfd);
+                    // wait on the sockets of the transfers, poll based so it has no FD_SETSIZE limit
+                    int numfds = 0;
+                    mcode = curl_multi_wait(curlmHandle, nullptr, 0, (int)timeoutMS, &numfds);
                     if (CURLM_OK != mcode)
                     {
+                        DLLOG("    _threadProc: curl_multi_wait return unexpect code: %d", mcode);
                         break;
                     }
 
-                    // do wait action
-                    if(maxfd == -1)
+                    // nothing to wait on yet, e.g. resolving: curl_multi_wait returns at once
+                    if (0 == numfds)
                     {
-                        this_thread::sleep_for(chrono::milliseconds(timeoutMS));
-                        rc = 0;
-                    }
-                    else
-                    {
-                        struct timeval timeout;
-
-                        timeout.tv_sec = timeoutMS / 1000;
-                        timeout.tv_usec = (timeoutMS % 1000) * 1000;
-
-                        rc = select(maxfd+1, &fdread, &fdwrite, &fdexcep, &timeout);
-                    }
-
-                    if (rc < 0)
-                    {
-                        DLLOG("    _threadProc: select return unexpect code: %d", rc);
+                        static const long MAX_IDLE_WAIT_MS = 100;
+                        this_thread::sleep_for(chrono::milliseconds(std::min(timeoutMS, MAX_IDLE_WAIT_MS)));
                     }
                 }
 
@@ -551,9 +1168,92 @@ namespace cocos2d { namespace network {
 
                             // remove from multi-handle
                             curl_multi_remove_handle(curlmHandle, curlHandle);
+
+                            auto segmentIt = segmentHandles.find(curlHandle);
+                            if (segmentHandles.end() != segmentIt)
+                            {
+                                DownloadTaskCURL& coTask = *wrapper.second;
+                                DownloadTaskCURL::Segment& segment = *segmentIt->second;
+                                segmentHandles.erase(segmentIt);
+                                coTaskMap.erase(curlHandle);
+                                curl_easy_cleanup(curlHandle);
+                                segment.handle = nullptr;
+
+                                bool failed = true;
+                                if (CURLE_OK != errCode)
+                                {
+                                    coTask.setErrorProc(DownloadTask::ERROR_IMPL_INTERNAL, errCode,
+                                                        segment.rangeChecked ? curl_easy_strerror(errCode) : "Server ignored the range request.");
+                                }
+                                else if (segment.received != segment.length)
+                                {
+                                    coTask.setErrorProc(DownloadTask::ERROR_IMPL_INTERNAL, 0, "Range response shorter than the segment.");
+                                }
+                                else
+                                {
+                                    failed = false;
+                                }
+                                if (failed)
+                                {
+                                    // the other segments go on when the task is started again
+                                    _abortSegmentsProc(curlmHandle, coTask, coTaskMap, segmentHandles);
+                                    coTask.saveSegmentsProc(coTask._validator);
+                                }
+
+                                bool running = false;
+                                for (auto& it : coTask._segments)
+                                {
+                                    running = running || nullptr != it->handle;
+                                }
+                                if (running)
+                                {
+                                    continue;
+                                }
+                                coTask.closeSegmentsProc();
+                                {
+                                    lock_guard<mutex> lock(_processMutex);
+                                    _processSet.erase(wrapper);
+                                }
+                                {
+                                    lock_guard<mutex> lock(_finishedMutex);
+                                    _finishedQueue.push_back(wrapper);
+                                }
+                                continue;
+                            }
+
                             bool reinited = false;
+                            bool segmentsStarted = false;
                             do
                             {
+                                // the content request stopped at its headers, the file is large enough to split
+                                if (wrapper.second->_splitRequested)
+                                {
+                                    wrapper.second->_splitRequested = false;
+                                    wrapper.second->_splitThreshold = 0;
+                                    int added = _startSegmentsProc(curlmHandle, wrapper, coTaskMap, segmentHandles);
+                                    segmentsStarted = added > 0;
+                                    if (added >= 0)
+                                    {
+                                        if (!segmentsStarted)
+                                        {
+                                            wrapper.second->closeSegmentsProc();
+                                        }
+                                        break;
+                                    }
+
+                                    // request the content again, as a single stream
+                                    curl_easy_reset(curlHandle);
+                                    _initCurlHandleProc(curlHandle, wrapper, true);
+                                    mcode = curl_multi_add_handle(curlmHandle, curlHandle);
+                                    if (CURLM_OK != mcode)
+                                    {
+                                        wrapper.second->setErrorProc(DownloadTask::ERROR_IMPL_INTERNAL, mcode, curl_multi_strerror(mcode));
+                                        break;
+                                    }
+                                    reinited = true;
+                                    break;
+                                }
+
                                 if (CURLE_OK != errCode)
                                 {
                                     long httpResponseCode = 0;
@@ -576,6 +1276,20 @@ namespace cocos2d { namespace network {
                                     break;
                                 }
 
+                                if (_segmentableProc(*wrapper.second))
+                                {
+                                    int added = _startSegmentsProc(curlmHandle, wrapper, coTaskMap, segmentHandles);
+                                    segmentsStarted = added > 0;
+                                    if (added >= 0)
+                                    {
+                                        if (!segmentsStarted)
+                                        {
+                                            wrapper.second->closeSegmentsProc();
+                                        }
+                                        break;
+                                    }
+                                }
+
                                 // after get header info success
                                 // wrapper.second->_totalBytesReceived inited by local file size
                                 // if the local file size equal with the content size from header, the file has downloaded finish
@@ -603,6 +1317,12 @@ namespace cocos2d { namespace network {
                                 continue;
                             }
                             curl_easy_cleanup(curlHandle);
+                            if (segmentsStarted)
+                            {
+                                // the task goes on with its range requests
+                                coTaskMap.erase(curlHandle);
+                                continue;
+                            }
                             DLLOG("    _threadProc task clean cur handle :%p with errCode:%d",  curlHandle, errCode);
 
                            // remove from coTaskMap
@@ -625,9 +1345,30 @@ namespace cocos2d { namespace network {
                     } while(m);
                 }
 
+                // keep the segment maps close to the temp files, for resuming after the app is killed
+                static const auto SEGMENT_MAP_SAVE_INTERVAL = chrono::seconds(1);
+                if (segmentHandles.size() && chrono::steady_clock::now() - segmentMapSaved >= SEGMENT_MAP_SAVE_INTERVAL)
+                {
+                    set<DownloadTaskCURL*> segmentedTasks;
+                    for (auto& it : segmentHandles)
+                    {
+                        segmentedTasks.insert(it.second->owner);
+                    }
+                    for (auto coTask : segmentedTasks)
+                    {
+                        coTask->saveSegmentsProc(coTask->_validator);
+                    }
+                    segmentMapSaved = chrono::steady_clock::now();
+                }
+
+                if (this->hints.adaptiveConcurrency)
+                {
+                    _tuner.updateProc(coTaskMap.size() >= countOfMaxProcessingTasks);
+                    countOfMaxProcessingTasks = _tuner.limit();
+                }
+
                 // process tasks in _requestList
-                auto size = coTaskMap.size();
-                while (0 == countOfMaxProcessingTasks || size < countOfMaxProcessingTasks)
+                while (0 == countOfMaxProcessingTasks || coTaskMap.size() < countOfMaxProcessingTasks)
                 {
                     // get task wrapper from request queue
                     TaskWrapper wrapper;
@@ -659,8 +1400,25 @@ namespace cocos2d { namespace network {
                         continue;
                     }
 
-                    // init curl handle for get header info
-                    _initCurlHandleProc(curlHandle, wrapper);
+                    // the header request only tells whether a partial file can be resumed,
+                    // without one the content is requested at once, one round trip per file
+                    if (wrapper.second->partialFileSizeProc() > 0)
+                    {
+                        // init curl handle for get header info
+                        _initCurlHandleProc(curlHandle, wrapper);
+                    }
+                    else
+                    {
+                        {
+                            lock_guard<mutex> lock(wrapper.second->_mutex);
+                            wrapper.second->_headerAchieved = true;
+                        }
+                        if (_segmentableProc(*wrapper.second))
+                        {
+                            wrapper.second->_splitThreshold = std::max<int64_t>(hints.segmentThreshold, 1);
+                        }
+                        _initCurlHandleProc(curlHandle, wrapper, true);
+                    }
 
                     // add curl handle to process list
                     mcode = curl_multi_add_handle(curlmHandle, curlHandle);
@@ -679,6 +1437,17 @@ namespace cocos2d { namespace network {
                 }
             } while (coTaskMap.size());
 
+            // the handles must not hold the share handle once the Impl is destroyed
+            for (auto& it : segmentHandles)
+            {
+                it.second->owner->saveSegmentsProc(it.second->owner->_validator);
+                it.second->handle = nullptr;
+            }
+            for (auto& it : coTaskMap)
+            {
+                curl_multi_remove_handle(curlmHandle, it.first);
+                curl_easy_cleanup(it.first);
+            }
             curl_multi_cleanup(curlmHandle);
             this->stop();
             DLLOG("----DownloaderCURL::Impl::_threadProc end");
@@ -693,6 +1462,12 @@ namespace cocos2d { namespace network {
         mutex _requestMutex;
         mutex _processMutex;
         mutex _finishedMutex;
+
+        CURLSH* _shareHandle;
+        mutex _shareMutex[CURL_LOCK_DATA_LAST];
+
+        // only used in thread proc, except setHints
+        ConcurrencyTuner _tuner;
     };
 
 
@@ -703,7 +1478,7 @@ namespace cocos2d { namespace network {
     , _currTask(nullptr)
     {
         DLLOG("Construct DownloaderCURL %p", this);
-        _impl->hints = hints;
+        _impl->setHints(hints);
         _scheduler = SharedDirector.getScheduler();
         _scheduler->retain();
 
@@ -745,6 +1520,8 @@ namespace cocos2d { namespace network {
     {
         DownloadTaskCURL *coTask = new (std::nothrow) DownloadTaskCURL;
         coTask->init(task->storagePath, _impl->hints.tempFileNameSuffix);
+        coTask->_task = task.get();
+        coTask->_onData = onTaskData;
 
         DLLOG("    DownloaderCURL: createTask: Id(%d)", coTask->serialId);
 
@@ -817,6 +1594,12 @@ namespace cocos2d { namespace network {
                         break;
                     }
 
+                    // the segments of a failed task are resumed from the temp file
+                    if (coTask.segmented() && DownloadTask::ERROR_NO_ERROR != coTask._errCode)
+                    {
+                        break;
+                    }
+
                     auto util = FileUtils::getInstance();
                     // if file already exist, remove it
                     if (util->isFileExist(coTask._fileName))
@@ -836,6 +1619,11 @@ namespace cocos2d { namespace network {
                     {
                         // success, remove storage from set
                         DownloadTaskCURL::_sStoragePathSet.erase(coTask._tempFileName);
+                        // removed after the rename, a temp file without its map would be taken for a single stream
+                        if (coTask.segmented())
+                        {
+                            util->removeFile(coTask.segmentMapPath());
+                        }
                         break;
                     }
                     // failed
@@ -63,7 +63,10 @@ namespace cocos2d { namespace network {
         {
             6,
             45,
-            ".tmp"
+            ".tmp",
+            false,
+            0,
+            0
         };
         new(this)Downloader(hints);
     }
@@ -166,6 +169,7 @@ namespace cocos2d { namespace network {
                 task.reset();
                 break;
             }
+            _impl->onTaskData = onTaskDataProc;
             task_->_coTask.reset(_impl->createCoTask(task));
         } while (0);
 
@@ -63,6 +63,12 @@ namespace cocos2d { namespace network {
         uint32_t countOfMaxProcessingTasks;
         uint32_t timeoutInSeconds;
         std::string tempFileNameSuffix;
+        // tune the count of processing tasks from the observed throughput, up to countOfMaxProcessingTasks
+        bool adaptiveConcurrency;
+        // split file tasks of at least segmentThreshold bytes into countOfSegments parallel range requests,
+        // resumable across restarts; 0 or 1 disables it, only the curl downloader supports it
+        uint32_t countOfSegments;
+        int64_t segmentThreshold;
     };
 
     class CC_DLL Downloader final
@@ -87,6 +93,13 @@ namespace cocos2d { namespace network {
                            int errorCodeInternal,
                            const std::string& errorStr)> onTaskError;
         
+        // Called on the downloader thread with each chunk of a file task before it is written,
+        // so it can be hashed while downloading. It is copied into a task when the task is created,
+        // only the curl downloader calls it, and not for segmented tasks whose chunks come out of order.
+        std::function<void(const DownloadTask& task,
+                           const unsigned char* data,
+                           size_t size)> onTaskDataProc;
+        
         void setOnFileTaskSuccess(const std::function<void(const DownloadTask& task)>& callback) {onFileTaskSuccess = callback;};
         
         void setOnTaskProgress(const std::function<void(const DownloadTask& task,
@@ -64,6 +64,10 @@ namespace cocos2d { namespace network
                            const std::string& errorStr,
                            std::vector<unsigned char>& data)> onTaskFinish;
 
+        std::function<void(const DownloadTask& task,
+                           const unsigned char* data,
+                           size_t size)> onTaskData;
+
         virtual IDownloadTask *createCoTask(std::shared_ptr<const DownloadTask>& task) = 0;
     };
 
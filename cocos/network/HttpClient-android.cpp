@@ -832,12 +832,7 @@ void HttpClient::networkThread()
         _responseQueue.pushBack(response);
         _responseQueueMutex.unlock();
         
-        _schedulerMutex.lock();
-        if (nullptr != _scheduler)
-        {
-            _scheduler->performFunctionInCocosThread(CC_CALLBACK_0(HttpClient::dispatchResponseCallbacks, this));
-        }
-        _schedulerMutex.unlock();
+        scheduleDispatch();
     }
     
     // cleanup: if worker thread received quit signal, clean up un-completed request queue
@@ -944,6 +939,9 @@ HttpClient::HttpClient()
 , _timeoutForConnect(30)
 , _timeoutForRead(60)
 , _threadCount(0)
+, _dispatchScheduled(false)
+, _dispatchRemovedCount(0)
+, _dispatchTimeBudget(DEFAULT_DISPATCH_TIME_BUDGET)
 , _cookie(nullptr)
 , _requestSentinel(new HttpRequest())
 {
@@ -1013,39 +1011,6 @@ void HttpClient::sendImmediate(HttpRequest* request)
     t.detach();
 }
 
-// Poll and notify main thread if responses exists in queue
-void HttpClient::dispatchResponseCallbacks()
-{
-    // log("CCHttpClient::dispatchResponseCallbacks is running");
-    //occurs when cocos thread fires but the network thread has already quited
-    HttpResponse* response = nullptr;
-    
-    _responseQueueMutex.lock();
-
-    if (!_responseQueue.empty())
-    {
-        response = _responseQueue.at(0);
-        _responseQueue.erase(0);
-    }
-
-    _responseQueueMutex.unlock();
-    
-    if (response)
-    {
-        HttpRequest *request = response->getHttpRequest();
-        const ccHttpRequestCallback& callback = request->getResponseCallback();
-
-        if (callback != nullptr)
-        {
-            callback(this, response);
-        }
-
-        response->release();
-        // do not release in other thread
-        request->release();
-    }
-}
-
 void HttpClient::increaseThreadCount()
 {
     _threadCountMutex.lock();
@@ -0,0 +1,116 @@
+/****************************************************************************
+ Copyright (c) 2012      greathqy
+ Copyright (c) 2012      cocos2d-x.org
+ Copyright (c) 2013-2017 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+// The response dispatch shared by the curl, android and apple implementations of HttpClient
+
+#include "ccHeader.h"
+#include "network/HttpClient.h"
+#include <chrono>
+
+NS_CC_BEGIN
+
+namespace network {
+
+const float HttpClient::DEFAULT_DISPATCH_TIME_BUDGET = 0.004f;
+
+// Poll and notify main thread if responses exists in queue
+void HttpClient::dispatchResponseCallbacks()
+{
+    // log("CCHttpClient::dispatchResponseCallbacks is running");
+    //occurs when cocos thread fires but the network thread has already quited
+    auto start = std::chrono::steady_clock::now();
+    bool first = true;
+    while (true)
+    {
+        HttpResponse* response = nullptr;
+        {
+            std::lock_guard<std::mutex> lock(_responseQueueMutex);
+            if (_responseQueue.empty())
+            {
+                _dispatchScheduled = false;
+                return;
+            }
+            // the responses left wait for the next frame
+            if (!first && _dispatchTimeBudget > 0
+                && std::chrono::duration<float>(std::chrono::steady_clock::now() - start).count() >= _dispatchTimeBudget)
+            {
+                _dispatchScheduled = false;
+                break;
+            }
+            response = _responseQueue.at(0);
+            _responseQueue.erase(0);
+        }
+        first = false;
+
+        HttpRequest *request = response->getHttpRequest();
+        const ccHttpRequestCallback& callback = request->getResponseCallback();
+
+        if (callback != nullptr)
+        {
+            callback(this, response);
+        }
+
+#if (CC_TARGET_PLATFORM != CC_PLATFORM_ANDROID) && (CC_TARGET_PLATFORM != CC_PLATFORM_IOS) && (CC_TARGET_PLATFORM != CC_PLATFORM_MAC)
+        // nobody kept the response, its buffer serves the next requests
+        if (response->getReferenceCount() == 1)
+        {
+            recycleResponseBuffer(response->getResponseData());
+        }
+#endif
+        response->release();
+        // do not release in other thread
+        request->release();
+    }
+
+    scheduleDispatch();
+}
+
+void HttpClient::scheduleDispatch()
+{
+    std::lock_guard<std::mutex> schedulerLock(_schedulerMutex);
+    if (nullptr == _scheduler)
+    {
+        return;
+    }
+
+    // the dispatch asked for is dropped when the scheduler removes its pending functions, e.g. on a director reset
+    unsigned int removedCount = _scheduler->getFunctionsToPerformRemovedCount();
+    {
+        std::lock_guard<std::mutex> lock(_responseQueueMutex);
+        if (_dispatchScheduled && _dispatchRemovedCount == removedCount)
+        {
+            return;
+        }
+        _dispatchScheduled = true;
+        _dispatchRemovedCount = removedCount;
+    }
+
+    _scheduler->performFunctionInCocosThread(CC_CALLBACK_0(HttpClient::dispatchResponseCallbacks, this));
+}
+
+} // namespace network
+
+NS_CC_END
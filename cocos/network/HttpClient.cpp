@@ -27,6 +27,9 @@
 #include "ccHeader.h"
 #include "network/HttpClient.h"
 #include <queue>
+#include <algorithm>
+#include <chrono>
+#include <thread>
 #include <errno.h>
 #include <curl/curl.h>
 #include "base/CCDirector.h"
@@ -42,6 +45,16 @@ typedef int int32_t;
 
 static HttpClient* _httpClient = nullptr; // pointer to singleton
 
+// Requests the network thread transfers at the same time, the others wait in the request queue
+static const int MAX_CONCURRENT_REQUESTS = 32;
+// Upper bound of the wait for socket activity, so new requests join the transfers soon enough
+static const int MULTI_WAIT_TIMEOUT_MS = 10;
+// Content-Length above this is not trusted to reserve the response buffer
+static const size_t MAX_RESERVED_RESPONSE_SIZE = 8 * 1024 * 1024;
+// Buffers bigger than this are freed instead of recycled
+static const size_t MAX_POOLED_RESPONSE_SIZE = 1024 * 1024;
+static const size_t MAX_POOLED_RESPONSE_BUFFERS = 16;
+
 typedef size_t (*write_callback)(void *ptr, size_t size, size_t nmemb, void *stream);
 
 // Callback function used by libcurl for collect response data
@@ -60,106 +73,33 @@ static size_t writeData(void *ptr, size_t size, size_t nmemb, void *stream)
 // Callback function used by libcurl for collect header data
 static size_t writeHeaderData(void *ptr, size_t size, size_t nmemb, void *stream)
 {
-    std::vector<char> *recvBuffer = (std::vector<char>*)stream;
+    HttpResponse *response = (HttpResponse*)stream;
+    std::vector<char> *recvBuffer = response->getResponseHeader();
     size_t sizes = size * nmemb;
     
     // add data to the end of recvBuffer
     // write data maybe called more than once in a single request
     recvBuffer->insert(recvBuffer->end(), (char*)ptr, (char*)ptr+sizes);
-    
-    return sizes;
-}
-
 
-static int processGetTask(HttpClient* client, HttpRequest* request, write_callback callback, void *stream, long *errorCode, write_callback headerCallback, void *headerStream, char* errorBuffer);
-static int processPostTask(HttpClient* client, HttpRequest* request, write_callback callback, void *stream, long *errorCode, write_callback headerCallback, void *headerStream, char* errorBuffer);
-static int processPutTask(HttpClient* client,  HttpRequest* request, write_callback callback, void *stream, long *errorCode, write_callback headerCallback, void *headerStream, char* errorBuffer);
-static int processDeleteTask(HttpClient* client,  HttpRequest* request, write_callback callback, void *stream, long *errorCode, write_callback headerCallback, void *headerStream, char* errorBuffer);
-// int processDownloadTask(HttpRequest *task, write_callback callback, void *stream, int32_t *errorCode);
-
-// Worker thread
-void HttpClient::networkThread()
-{
-    increaseThreadCount();
-
-    while (true)
+    // reserve the body once, instead of growing it while it is received
+    static const char contentLength[] = "content-length:";
+    const size_t prefixLength = sizeof(contentLength) - 1;
+    size_t matched = 0;
+    while (matched < prefixLength && matched < sizes && tolower(((const char*)ptr)[matched]) == contentLength[matched])
     {
-        HttpRequest *request;
-
-        // step 1: send http request if the requestQueue isn't empty
-        {
-            std::lock_guard<std::mutex> lock(_requestQueueMutex);
-            while (_requestQueue.empty())
-            {
-                _sleepCondition.wait(_requestQueueMutex);
-            }
-            request = _requestQueue.at(0);
-            _requestQueue.erase(0);
-        }
-
-        if (request == _requestSentinel) {
-            break;
-        }
-
-        // step 2: libcurl sync access
-        
-        // Create a HttpResponse object, the default setting is http access failed
-        HttpResponse *response = new (std::nothrow) HttpResponse(request);
-
-        processResponse(response, _responseMessage);
-
-
-        // add response packet into queue
-        _responseQueueMutex.lock();
-        _responseQueue.pushBack(response);
-        _responseQueueMutex.unlock();
-
-        _schedulerMutex.lock();
-        if (nullptr != _scheduler)
+        ++matched;
+    }
+    if (matched == prefixLength)
+    {
+        std::string value((const char*)ptr + prefixLength, sizes - prefixLength);
+        long long length = atoll(value.c_str());
+        if (length > 0 && (size_t)length <= MAX_RESERVED_RESPONSE_SIZE)
         {
-            _scheduler->performFunctionInCocosThread(CC_CALLBACK_0(HttpClient::dispatchResponseCallbacks, this));
+            response->getResponseData()->reserve((size_t)length);
         }
-        _schedulerMutex.unlock();
     }
     
-    // cleanup: if worker thread received quit signal, clean up un-completed request queue
-    _requestQueueMutex.lock();
-    _requestQueue.clear();
-    _requestQueueMutex.unlock();
-
-    _responseQueueMutex.lock();
-    _responseQueue.clear();
-    _responseQueueMutex.unlock();
-
-    decreaseThreadCountAndMayDeleteThis();
-}
-
-// Worker thread
-void HttpClient::networkThreadAlone(HttpRequest* request, HttpResponse* response)
-{
-    increaseThreadCount();
-
-    char responseMessage[RESPONSE_BUFFER_SIZE] = { 0 };
-    processResponse(response, responseMessage);
-
-    _schedulerMutex.lock();
-    if (nullptr != _scheduler)
-    {
-        _scheduler->performFunctionInCocosThread([this, response, request]{
-            const ccHttpRequestCallback& callback = request->getResponseCallback();
-
-            if (callback != nullptr)
-            {
-                callback(this, response);
-            }
-            response->release();
-            // do not release in other thread
-            request->release();
-        });
-    }
-    _schedulerMutex.unlock();
-
-    decreaseThreadCountAndMayDeleteThis();
+    return sizes;
 }
 
 //Configure curl's timeout property
@@ -224,6 +164,8 @@ public:
             curl_slist_free_all(_headers);
     }
 
+    CURL* getHandle() const { return _curl; }
+
     template <class T>
     bool setOption(CURLoption option, T data)
     {
@@ -271,66 +213,225 @@ public:
                 && setOption(CURLOPT_HEADERDATA, headerStream);
         
     }
+};
+
+// A request being transferred by the multi handle of the network thread
+struct HttpTransfer
+{
+    HttpResponse *response;
+    CURLRaii curl;
+    char errorBuffer[HttpClient::RESPONSE_BUFFER_SIZE];
 
-    /// @param responseCode Null not allowed
-    bool perform(long *responseCode)
+    explicit HttpTransfer(HttpResponse *response_)
+        : response(response_)
     {
-        if (CURLE_OK != curl_easy_perform(_curl))
-            return false;
-        CURLcode code = curl_easy_getinfo(_curl, CURLINFO_RESPONSE_CODE, responseCode);
-        if (code != CURLE_OK || !(*responseCode >= 200 && *responseCode < 300)) {
-            CCLOGERROR("Curl curl_easy_getinfo failed: %s", curl_easy_strerror(code));
-            return false;
-        }
-        // Get some mor data.
-        
-        return true;
+        memset(errorBuffer, 0, sizeof(errorBuffer));
     }
 };
 
-//Process Get Request
-static int processGetTask(HttpClient* client, HttpRequest* request, write_callback callback, void* stream, long* responseCode, write_callback headerCallback, void* headerStream, char* errorBuffer)
+//Prepare Get Request
+static bool prepareGetTask(HttpClient* client, HttpRequest* request, HttpTransfer* transfer)
 {
-    CURLRaii curl;
-    bool ok = curl.init(client, request, callback, stream, headerCallback, headerStream, errorBuffer)
-            && curl.setOption(CURLOPT_FOLLOWLOCATION, true)
-            && curl.perform(responseCode);
-    return ok ? 0 : 1;
+    return transfer->curl.init(client, request, writeData, transfer->response->getResponseData(), writeHeaderData, transfer->response, transfer->errorBuffer)
+            && transfer->curl.setOption(CURLOPT_FOLLOWLOCATION, true);
 }
 
-//Process POST Request
-static int processPostTask(HttpClient* client, HttpRequest* request, write_callback callback, void* stream, long* responseCode, write_callback headerCallback, void* headerStream, char* errorBuffer)
+//Prepare POST Request
+static bool preparePostTask(HttpClient* client, HttpRequest* request, HttpTransfer* transfer)
 {
-    CURLRaii curl;
-    bool ok = curl.init(client, request, callback, stream, headerCallback, headerStream, errorBuffer)
-            && curl.setOption(CURLOPT_POST, 1)
-            && curl.setOption(CURLOPT_POSTFIELDS, request->getRequestData())
-            && curl.setOption(CURLOPT_POSTFIELDSIZE, request->getRequestDataSize())
-            && curl.perform(responseCode);
-    return ok ? 0 : 1;
+    return transfer->curl.init(client, request, writeData, transfer->response->getResponseData(), writeHeaderData, transfer->response, transfer->errorBuffer)
+            && transfer->curl.setOption(CURLOPT_POST, 1)
+            && transfer->curl.setOption(CURLOPT_POSTFIELDS, request->getRequestData())
+            && transfer->curl.setOption(CURLOPT_POSTFIELDSIZE, request->getRequestDataSize());
 }
 
-//Process PUT Request
-static int processPutTask(HttpClient* client, HttpRequest* request, write_callback callback, void* stream, long* responseCode, write_callback headerCallback, void* headerStream, char* errorBuffer)
+//Prepare PUT Request
+static bool preparePutTask(HttpClient* client, HttpRequest* request, HttpTransfer* transfer)
 {
-    CURLRaii curl;
-    bool ok = curl.init(client, request, callback, stream, headerCallback, headerStream, errorBuffer)
-            && curl.setOption(CURLOPT_CUSTOMREQUEST, "PUT")
-            && curl.setOption(CURLOPT_POSTFIELDS, request->getRequestData())
-            && curl.setOption(CURLOPT_POSTFIELDSIZE, request->getRequestDataSize())
-            && curl.perform(responseCode);
-    return ok ? 0 : 1;
+    return transfer->curl.init(client, request, writeData, transfer->response->getResponseData(), writeHeaderData, transfer->response, transfer->errorBuffer)
+            && transfer->curl.setOption(CURLOPT_CUSTOMREQUEST, "PUT")
+            && transfer->curl.setOption(CURLOPT_POSTFIELDS, request->getRequestData())
+            && transfer->curl.setOption(CURLOPT_POSTFIELDSIZE, request->getRequestDataSize());
 }
 
-//Process DELETE Request
-static int processDeleteTask(HttpClient* client, HttpRequest* request, write_callback callback, void* stream, long* responseCode, write_callback headerCallback, void* headerStream, char* errorBuffer)
+//Prepare DELETE Request
+static bool prepareDeleteTask(HttpClient* client, HttpRequest* request, HttpTransfer* transfer)
 {
-    CURLRaii curl;
-    bool ok = curl.init(client, request, callback, stream, headerCallback, headerStream, errorBuffer)
-            && curl.setOption(CURLOPT_CUSTOMREQUEST, "DELETE")
-            && curl.setOption(CURLOPT_FOLLOWLOCATION, true)
-            && curl.perform(responseCode);
-    return ok ? 0 : 1;
+    return transfer->curl.init(client, request, writeData, transfer->response->getResponseData(), writeHeaderData, transfer->response, transfer->errorBuffer)
+            && transfer->curl.setOption(CURLOPT_CUSTOMREQUEST, "DELETE")
+            && transfer->curl.setOption(CURLOPT_FOLLOWLOCATION, true);
+}
+
+static bool prepareTask(HttpClient* client, HttpTransfer* transfer)
+{
+    auto request = transfer->response->getHttpRequest();
+    switch (request->getRequestType())
+    {
+    case HttpRequest::Type::GET: // HTTP GET
+        return prepareGetTask(client, request, transfer);
+
+    case HttpRequest::Type::POST: // HTTP POST
+        return preparePostTask(client, request, transfer);
+
+    case HttpRequest::Type::PUT:
+        return preparePutTask(client, request, transfer);
+
+    case HttpRequest::Type::DELETE:
+        return prepareDeleteTask(client, request, transfer);
+
+    default:
+        CCASSERT(false, "CCHttpClient: unknown request type, only GET, POST, PUT or DELETE is supported");
+        return false;
+    }
+}
+
+// Worker thread, all the requests are transferred together by a curl multi handle
+void HttpClient::networkThread()
+{
+    increaseThreadCount();
+
+    CURLM *multi = curl_multi_init();
+    curl_multi_setopt(multi, CURLMOPT_PIPELINING, CURLPIPE_MULTIPLEX);
+    // only used by this thread, so no lock functions
+    CURLSH *share = curl_share_init();
+    curl_share_setopt(share, CURLSHOPT_SHARE, CURL_LOCK_DATA_COOKIE);
+    curl_share_setopt(share, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS);
+    curl_share_setopt(share, CURLSHOPT_SHARE, CURL_LOCK_DATA_SSL_SESSION);
+
+    std::vector<HttpTransfer*> transfers;
+    std::vector<HttpRequest*> requests;
+    bool quit = false;
+
+    // after the quit signal the requests taken before it are still transferred, as when they were sent one by one
+    while (!quit || !transfers.empty())
+    {
+        // step 1: take the queued requests, sleep only when nothing is being transferred
+        if (!quit)
+        {
+            std::lock_guard<std::mutex> lock(_requestQueueMutex);
+            while (transfers.empty() && _requestQueue.empty())
+            {
+                _sleepCondition.wait(_requestQueueMutex);
+            }
+            while (!_requestQueue.empty() && (int)(transfers.size() + requests.size()) < MAX_CONCURRENT_REQUESTS)
+            {
+                HttpRequest *request = _requestQueue.at(0);
+                _requestQueue.erase(0);
+                if (request == _requestSentinel)
+                {
+                    quit = true;
+                    break;
+                }
+                requests.push_back(request);
+            }
+        }
+
+        // step 2: add them to the multi handle
+        for (auto request : requests)
+        {
+            // Create a HttpResponse object, the default setting is http access failed
+            HttpResponse *response = new (std::nothrow) HttpResponse(request);
+            acquireResponseBuffer(response->getResponseData());
+
+            HttpTransfer *transfer = new (std::nothrow) HttpTransfer(response);
+            if (prepareTask(this, transfer)
+                && transfer->curl.setOption(CURLOPT_SHARE, share)
+                && transfer->curl.setOption(CURLOPT_PRIVATE, transfer)
+                && CURLM_OK == curl_multi_add_handle(multi, transfer->curl.getHandle()))
+            {
+                transfers.push_back(transfer);
+                continue;
+            }
+
+            response->setSucceed(false);
+            response->setErrorBuffer(transfer->errorBuffer);
+            delete transfer;
+
+            std::lock_guard<std::mutex> lock(_responseQueueMutex);
+            _responseQueue.pushBack(response);
+        }
+        if (!requests.empty())
+        {
+            requests.clear();
+            scheduleDispatch();
+        }
+
+        // step 3: libcurl async access
+        int running = 0;
+        curl_multi_perform(multi, &running);
+
+        CURLMsg *msg = nullptr;
+        int msgsLeft = 0;
+        bool finished = false;
+        while ((msg = curl_multi_info_read(multi, &msgsLeft)))
+        {
+            if (msg->msg != CURLMSG_DONE)
+            {
+                continue;
+            }
+
+            HttpTransfer *transfer = nullptr;
+            curl_easy_getinfo(msg->easy_handle, CURLINFO_PRIVATE, (char**)&transfer);
+            CURLcode result = msg->data.result;
+            curl_multi_remove_handle(multi, msg->easy_handle);
+
+            // write data to HttpResponse
+            HttpResponse *response = transfer->response;
+            long responseCode = -1;
+            bool succeed = (CURLE_OK == result);
+            if (succeed)
+            {
+                CURLcode code = curl_easy_getinfo(transfer->curl.getHandle(), CURLINFO_RESPONSE_CODE, &responseCode);
+                if (code != CURLE_OK || !(responseCode >= 200 && responseCode < 300)) {
+                    CCLOGERROR("Curl curl_easy_getinfo failed: %s", curl_easy_strerror(code));
+                    succeed = false;
+                }
+            }
+            response->setResponseCode(responseCode);
+            response->setSucceed(succeed);
+            if (!succeed)
+            {
+                response->setErrorBuffer(transfer->errorBuffer);
+            }
+
+            transfers.erase(std::find(transfers.begin(), transfers.end(), transfer));
+            delete transfer;
+
+            // add response packet into queue
+            std::lock_guard<std::mutex> lock(_responseQueueMutex);
+            _responseQueue.pushBack(response);
+            finished = true;
+        }
+        if (finished)
+        {
+            scheduleDispatch();
+        }
+
+        if (!transfers.empty())
+        {
+            int numfds = 0;
+            curl_multi_wait(multi, nullptr, 0, MULTI_WAIT_TIMEOUT_MS, &numfds);
+            if (0 == numfds)
+            {
+                // nothing to wait for yet, e.g. while resolving, do not spin
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+        }
+    }
+
+    curl_multi_cleanup(multi);
+    curl_share_cleanup(share);
+    
+    // cleanup: if worker thread received quit signal, clean up un-completed request queue
+    _requestQueueMutex.lock();
+    _requestQueue.clear();
+    _requestQueueMutex.unlock();
+
+    _responseQueueMutex.lock();
+    _responseQueue.clear();
+    _responseQueueMutex.unlock();
+
+    decreaseThreadCountAndMayDeleteThis();
 }
 
 // HttpClient implementation
@@ -395,11 +496,13 @@ HttpClient::HttpClient()
 , _timeoutForConnect(30)
 , _timeoutForRead(60)
 , _threadCount(0)
+, _dispatchScheduled(false)
+, _dispatchRemovedCount(0)
+, _dispatchTimeBudget(DEFAULT_DISPATCH_TIME_BUDGET)
 , _cookie(nullptr)
 , _requestSentinel(new HttpRequest())
 {
     CCLOG("In the constructor of HttpClient!");
-    memset(_responseMessage, 0, RESPONSE_BUFFER_SIZE * sizeof(char));
     _scheduler = SharedDirector.getScheduler();
     increaseThreadCount();
 }
@@ -452,115 +555,49 @@ void HttpClient::send(HttpRequest* request)
 
 void HttpClient::sendImmediate(HttpRequest* request)
 {
+    if (false == lazyInitThreadSemaphore())
+    {
+        return;
+    }
+
     if(!request)
     {
         return;
     }
 
     request->retain();
-    // Create a HttpResponse object, the default setting is http access failed
-    HttpResponse *response = new (std::nothrow) HttpResponse(request);
 
-    auto t = std::thread(&HttpClient::networkThreadAlone, this, request, response);
-    t.detach();
+    // the network thread starts it before the queued requests
+    _requestQueueMutex.lock();
+    _requestQueue.insert(0, request);
+    _requestQueueMutex.unlock();
+
+    _sleepCondition.notify_one();
 }
 
-// Poll and notify main thread if responses exists in queue
-void HttpClient::dispatchResponseCallbacks()
+void HttpClient::acquireResponseBuffer(std::vector<char>* buffer)
 {
-    // log("CCHttpClient::dispatchResponseCallbacks is running");
-    //occurs when cocos thread fires but the network thread has already quited
-    HttpResponse* response = nullptr;
-
-    _responseQueueMutex.lock();
-    if (!_responseQueue.empty())
-    {
-        response = _responseQueue.at(0);
-        _responseQueue.erase(0);
-    }
-    _responseQueueMutex.unlock();
-    
-    if (response)
+    std::lock_guard<std::mutex> lock(_responseBufferPoolMutex);
+    if (!_responseBufferPool.empty())
     {
-        HttpRequest *request = response->getHttpRequest();
-        const ccHttpRequestCallback& callback = request->getResponseCallback();
-
-        if (callback != nullptr)
-        {
-            callback(this, response);
-        }
-
-        response->release();
-        // do not release in other thread
-        request->release();
+        buffer->swap(_responseBufferPool.back());
+        _responseBufferPool.pop_back();
     }
 }
 
-// Process Response
-void HttpClient::processResponse(HttpResponse* response, char* responseMessage)
+void HttpClient::recycleResponseBuffer(std::vector<char>* buffer)
 {
-    auto request = response->getHttpRequest();
-    long responseCode = -1;
-    int retValue = 0;
-
-    // Process the request -> get response packet
-    switch (request->getRequestType())
+    if (buffer->capacity() == 0 || buffer->capacity() > MAX_POOLED_RESPONSE_SIZE)
     {
-    case HttpRequest::Type::GET: // HTTP GET
-        retValue = processGetTask(this, request,
-            writeData,
-            response->getResponseData(),
-            &responseCode,
-            writeHeaderData,
-            response->getResponseHeader(),
-            responseMessage);
-        break;
-
-    case HttpRequest::Type::POST: // HTTP POST
-        retValue = processPostTask(this, request,
-            writeData,
-            response->getResponseData(),
-            &responseCode,
-            writeHeaderData,
-            response->getResponseHeader(),
-            responseMessage);
-        break;
-
-    case HttpRequest::Type::PUT:
-        retValue = processPutTask(this, request,
-            writeData,
-            response->getResponseData(),
-            &responseCode,
-            writeHeaderData,
-            response->getResponseHeader(),
-            responseMessage);
-        break;
-
-    case HttpRequest::Type::DELETE:
-        retValue = processDeleteTask(this, request,
-            writeData,
-            response->getResponseData(),
-            &responseCode,
-            writeHeaderData,
-            response->getResponseHeader(),
-            responseMessage);
-        break;
-
-    default:
-        CCASSERT(false, "CCHttpClient: unknown request type, only GET, POST, PUT or DELETE is supported");
-        break;
+        return;
     }
 
-    // write data to HttpResponse
-    response->setResponseCode(responseCode);
-    if (retValue != 0)
-    {
-        response->setSucceed(false);
-        response->setErrorBuffer(responseMessage);
-    }
-    else
+    std::lock_guard<std::mutex> lock(_responseBufferPoolMutex);
+    if (_responseBufferPool.size() < MAX_POOLED_RESPONSE_BUFFERS)
     {
-        response->setSucceed(true);
+        buffer->clear();
+        _responseBufferPool.emplace_back();
+        _responseBufferPool.back().swap(*buffer);
     }
 }
 
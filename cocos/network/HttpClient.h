@@ -29,6 +29,7 @@
 
 #include <thread>
 #include <condition_variable>
+#include "platform/CCPlatformConfig.h"
 #include "base/CCVector.h"
 #include "base/CCScheduler.h"
 #include "network/HttpRequest.h"
@@ -60,6 +61,11 @@ public:
     */
     static const int RESPONSE_BUFFER_SIZE = 256;
 
+    /**
+    * The default time the response callbacks may take per frame, in seconds
+    */
+    static const float DEFAULT_DISPATCH_TIME_BUDGET;
+
     /**
      * Get instance of HttpClient.
      *
@@ -148,6 +154,21 @@ public:
      */
     CC_DEPRECATED_ATTRIBUTE int getTimeoutForRead();
 
+    /**
+     * Set the time the response callbacks may take per frame, the responses left wait for the next frames.
+     * At least one response is dispatched per frame.
+     *
+     * @param seconds the time budget, 0 dispatches every finished response at once.
+     */
+    void setDispatchTimeBudget(float seconds) { _dispatchTimeBudget = seconds; }
+
+    /**
+     * Get the time the response callbacks may take per frame.
+     *
+     * @return float the time budget in seconds.
+     */
+    float getDispatchTimeBudget() const { return _dispatchTimeBudget; }
+
     HttpCookie* getCookie() const {return _cookie; }
 
     std::mutex& getCookieFileMutex() {return _cookieFileMutex;}
@@ -164,11 +185,19 @@ private:
      */
     bool lazyInitThreadSemaphore();
     void networkThread();
-    void networkThreadAlone(HttpRequest* request, HttpResponse* response);
     /** Poll function called from main thread to dispatch callbacks when http requests finished **/
     void dispatchResponseCallbacks();
+    /** Asks the main thread for dispatchResponseCallbacks, unless it is already asked **/
+    void scheduleDispatch();
 
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_ANDROID) || (CC_TARGET_PLATFORM == CC_PLATFORM_IOS) || (CC_TARGET_PLATFORM == CC_PLATFORM_MAC)
+    void networkThreadAlone(HttpRequest* request, HttpResponse* response);
     void processResponse(HttpResponse* response, char* responseMessage);
+#else
+    /** Response bodies are received into recycled buffers, which keep their capacity **/
+    void acquireResponseBuffer(std::vector<char>* buffer);
+    void recycleResponseBuffer(std::vector<char>* buffer);
+#endif
     void increaseThreadCount();
     void decreaseThreadCountAndMayDeleteThis();
 
@@ -192,6 +221,17 @@ private:
 
     Vector<HttpResponse*> _responseQueue;
     std::mutex _responseQueueMutex;
+    // guarded by _responseQueueMutex
+    bool _dispatchScheduled;
+    // the scheduler's removed count when the dispatch was asked for, guarded by _responseQueueMutex
+    unsigned int _dispatchRemovedCount;
+    // only used in the cocos thread
+    float _dispatchTimeBudget;
+
+#if (CC_TARGET_PLATFORM != CC_PLATFORM_ANDROID) && (CC_TARGET_PLATFORM != CC_PLATFORM_IOS) && (CC_TARGET_PLATFORM != CC_PLATFORM_MAC)
+    std::vector<std::vector<char>> _responseBufferPool;
+    std::mutex _responseBufferPoolMutex;
+#endif
 
     std::string _cookieFilename;
     std::mutex _cookieFileMutex;
@@ -203,7 +243,9 @@ private:
 
     std::condition_variable_any _sleepCondition;
 
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_ANDROID) || (CC_TARGET_PLATFORM == CC_PLATFORM_IOS) || (CC_TARGET_PLATFORM == CC_PLATFORM_MAC)
     char _responseMessage[RESPONSE_BUFFER_SIZE];
+#endif
 
     HttpRequest* _requestSentinel;
 };
@@ -393,6 +393,7 @@ bool FileUtils::writeToFile(const ValueMap& dict, const std::string &fullPath)
 
 bool FileUtils::writeValueMapToFile(const ValueMap& dict, const std::string& fullPath)
 {
+    FilesChangedScope filesChanged(this);
     tinyxml2::XMLDocument *doc = new (std::nothrow)tinyxml2::XMLDocument();
     if (nullptr == doc)
         return false;
@@ -433,6 +434,7 @@ bool FileUtils::writeValueMapToFile(const ValueMap& dict, const std::string& ful
 
 bool FileUtils::writeValueVectorToFile(const ValueVector& vecData, const std::string& fullPath)
 {
+    FilesChangedScope filesChanged(this);
     tinyxml2::XMLDocument *doc = new (std::nothrow)tinyxml2::XMLDocument();
     if (nullptr == doc)
         return false;
@@ -584,13 +586,18 @@ void FileUtils::setDelegate(FileUtils *delegate)
 }
 
 FileUtils::FileUtils()
-    : _writablePath("")
+    : _directoryIndexEnabled(false)
+    , _writablePath("")
     , jsEnginePathExist_(false)
 {
 }
 
 FileUtils::~FileUtils()
 {
+    for (auto pack : _packs)
+    {
+        pack->release();
+    }
 }
 
 bool FileUtils::writeStringToFile(const std::string& dataStr, const std::string& fullPath)
@@ -606,6 +613,7 @@ bool FileUtils::writeStringToFile(const std::string& dataStr, const std::string&
 
 bool FileUtils::writeDataToFile(const Data& data, const std::string& fullPath)
 {
+    FilesChangedScope filesChanged(this);
     size_t size = 0;
     const char* mode = "wb";
 
@@ -636,9 +644,157 @@ bool FileUtils::init()
     return true;
 }
 
+bool FileUtils::mountPack(const std::string& filename, bool front)
+{
+    std::string fullPath = fullPathForFilename(filename);
+    if (fullPath.empty())
+    {
+        return false;
+    }
+    unmountPack(fullPath);
+
+    ResourcePack* pack = ResourcePack::open(fullPath);
+    if (!pack)
+    {
+        return false;
+    }
+    {
+        std::lock_guard<std::mutex> lock(_packsMutex);
+        _packs.insert(front ? _packs.begin() : _packs.end(), pack);
+    }
+    clearPathCaches();
+    return true;
+}
+
+void FileUtils::unmountPack(const std::string& filename)
+{
+    std::string fullPath = fullPathForFilename(filename);
+    ResourcePack* pack = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(_packsMutex);
+        auto it = std::find_if(_packs.begin(), _packs.end(), [&fullPath](ResourcePack* pack)
+        {
+            return pack->getPath() == fullPath;
+        });
+        if (it == _packs.end())
+        {
+            return;
+        }
+        pack = *it;
+        _packs.erase(it);
+    }
+    // readers retained the pack they are reading from, it is unmapped after them
+    pack->release();
+    clearPathCaches();
+}
+
+const ResourcePack::Entry* FileUtils::findPackEntry(const std::string& fullPath, ResourcePack** pack) const
+{
+    std::lock_guard<std::mutex> lock(_packsMutex);
+    for (auto mounted : _packs)
+    {
+        const std::string& packPath = mounted->getPath();
+        if (fullPath.size() > packPath.size() && fullPath[packPath.size()] == '/' &&
+            fullPath.compare(0, packPath.size(), packPath) == 0)
+        {
+            size_t start = packPath.size() + 1;
+            auto entry = mounted->find(fullPath.c_str() + start, fullPath.size() - start);
+            if (entry)
+            {
+                mounted->retain();
+                *pack = mounted;
+                return entry;
+            }
+        }
+    }
+    return nullptr;
+}
+
+FileUtils::Status FileUtils::getContentsFromPack(const std::string& fullPath, ResizableBuffer* buffer) const
+{
+    ResourcePack* pack = nullptr;
+    auto entry = findPackEntry(fullPath, &pack);
+    if (!entry)
+    {
+        return Status::NotExists;
+    }
+    bool ok = pack->read(entry, buffer);
+    pack->release();
+    return ok ? Status::OK : Status::ReadFailed;
+}
+
 void FileUtils::purgeCachedEntries()
+{
+    clearPathCaches();
+    _directoryIndex.clear();
+}
+
+void FileUtils::clearPathCaches() const
 {
     _fullPathCache.clear();
+    forgetMissingPaths();
+}
+
+void FileUtils::forgetMissingPaths() const
+{
+    std::lock_guard<std::mutex> lock(_missingPathMutex);
+    _missingPathCache.clear();
+}
+
+void FileUtils::notifyFilesChanged(const std::string& fullPath)
+{
+    clearPathCaches();
+    for (auto it = _directoryIndex.begin(); it != _directoryIndex.end();)
+    {
+        // Either path may contain the other, the index is listed again on next use.
+        const std::string& searchPath = it->first;
+        size_t length = std::min(searchPath.size(), fullPath.size());
+        if (searchPath.compare(0, length, fullPath, 0, length) == 0)
+        {
+            it = _directoryIndex.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+}
+
+void FileUtils::setDirectoryIndexEnabled(bool enabled)
+{
+    _directoryIndexEnabled = enabled;
+    _directoryIndex.clear();
+    clearPathCaches();
+}
+
+bool FileUtils::isDirectoryIndexable(const std::string& dirPath) const
+{
+    return isAbsolutePath(dirPath) && isDirectoryExistInternal(dirPath);
+}
+
+const std::unordered_set<std::string>* FileUtils::getDirectoryIndex(const std::string& searchPath) const
+{
+    auto it = _directoryIndex.find(searchPath);
+    if (it == _directoryIndex.end())
+    {
+        std::unique_ptr<std::unordered_set<std::string>> index;
+        if (isDirectoryIndexable(searchPath))
+        {
+            std::vector<std::string> files;
+            listFilesRecursively(searchPath, &files);
+            index.reset(new std::unordered_set<std::string>());
+            index->reserve(files.size());
+            for (const auto& file : files)
+            {
+                if (file.back() != '/' && file.compare(0, searchPath.size(), searchPath) == 0)
+                {
+                    index->insert(file.substr(searchPath.size()));
+                }
+            }
+        }
+        it = _directoryIndex.emplace(searchPath, std::move(index)).first;
+    }
+    return it->second.get();
 }
 
 std::string FileUtils::getStringFromFile(const std::string& filename)
@@ -662,19 +818,26 @@ void FileUtils::loadFileAsyncUnsafe(String filename, const std::function<void(ui
     {
         ssize_t size = 0;
         uint8_t* buffer = this->getFileData(fileStr, "rb", &size);
-        return TValues::create(buffer, size);
+        return std::make_pair(buffer, size);
     }, 
-    [callback](TValues* result)
+    [callback](const std::pair<uint8_t*, ssize_t>& result)
     {
-        uint8_t* buffer;
-        ssize_t size;
-        result->get(buffer, size);
-        callback(buffer, size);
+        callback(result.first, result.second);
     });
 }
 
 const bgfx::Memory* FileUtils::getDataFromFileBX(const std::string& filename)
 {
+    ResourcePack* pack = nullptr;
+    auto entry = findPackEntry(fullPathForFilename(filename), &pack);
+    if (entry)
+    {
+        // views handed to bgfx hold their own reference
+        const bgfx::Memory* memory = pack->readBX(entry);
+        pack->release();
+        return memory;
+    }
+
     Data d;
     getContents(filename, &d);
     ssize_t size = 0;
@@ -693,6 +856,10 @@ FileUtils::Status FileUtils::getContents(const std::string& filename, ResizableB
     if (fullPath.empty())
         return Status::NotExists;
 
+    Status packStatus = getContentsFromPack(fullPath, buffer);
+    if (packStatus != Status::NotExists)
+        return packStatus;
+
     FILE *fp = fopen(fs->getSuitableFOpen(fullPath).c_str(), "rb");
     if (!fp)
         return Status::OpenFailed;
@@ -874,16 +1041,60 @@ std::string FileUtils::fullPathForFilename(const std::string &filename) const
         return cacheIter->second;
     }
 
+    // Known to be missing ?
+    {
+        std::lock_guard<std::mutex> lock(_missingPathMutex);
+        if (_missingPathCache.find(filename) != _missingPathCache.end())
+        {
+            return "";
+        }
+    }
+
     // Get the new file name.
     const std::string newFilename( getNewFilename(filename) );
 
     std::string fullpath;
 
+    // Mounted packs overlay the search paths.
+    size_t pos = newFilename.find_last_of("/");
+    size_t fileStart = pos == std::string::npos ? 0 : pos + 1;
+    {
+        std::lock_guard<std::mutex> lock(_packsMutex);
+        for (const auto pack : _packs)
+        {
+            for (const auto& resolutionIt : _searchResolutionsOrderArray)
+            {
+                std::string name = newFilename;
+                name.insert(fileStart, resolutionIt);
+                if (pack->find(name))
+                {
+                    fullpath = pack->getPath() + "/" + name;
+                    _fullPathCache.insert(std::make_pair(filename, fullpath));
+                    return fullpath;
+                }
+            }
+        }
+    }
+
+    // Names with dot segments or dot files are not in the index, they are probed.
+    bool indexable = _directoryIndexEnabled && newFilename[0] != '.' &&
+        newFilename.find("/.") == std::string::npos && newFilename.find('\\') == std::string::npos;
+
     for (const auto& searchIt : _searchPathArray)
     {
+        const auto index = indexable ? getDirectoryIndex(searchIt) : nullptr;
         for (const auto& resolutionIt : _searchResolutionsOrderArray)
         {
-            fullpath = this->getPathForFilename(newFilename, resolutionIt, searchIt);
+            if (index)
+            {
+                std::string name = newFilename;
+                name.insert(fileStart, resolutionIt);
+                fullpath = index->find(name) != index->end() ? searchIt + name : "";
+            }
+            else
+            {
+                fullpath = this->getPathForFilename(newFilename, resolutionIt, searchIt);
+            }
 
             if (!fullpath.empty())
             {
@@ -900,6 +1111,8 @@ std::string FileUtils::fullPathForFilename(const std::string &filename) const
     }
 
     // The file wasn't found, return empty string.
+    std::lock_guard<std::mutex> lock(_missingPathMutex);
+    _missingPathCache.insert(filename);
     return "";
 }
 
@@ -911,7 +1124,7 @@ std::string FileUtils::fullPathFromRelativeFile(const std::string &filename, con
 void FileUtils::setSearchResolutionsOrder(const std::vector<std::string>& searchResolutionsOrder)
 {
     bool existDefault = false;
-    _fullPathCache.clear();
+    clearPathCaches();
     _searchResolutionsOrderArray.clear();
     for(const auto& iter : searchResolutionsOrder)
     {
@@ -972,7 +1185,7 @@ void FileUtils::setSearchPaths(const std::vector<std::string>& searchPaths)
 {
     bool existDefaultRootPath = false;
 
-    _fullPathCache.clear();
+    clearPathCaches();
     _searchPathArray.clear();
     for (const auto& iter : searchPaths)
     {
@@ -1022,7 +1235,7 @@ void FileUtils::addSearchPath(const std::string &searchpath,const bool front)
 
 void FileUtils::setFilenameLookupDictionary(const ValueMap& filenameLookupDict)
 {
-    _fullPathCache.clear();
+    clearPathCaches();
     _filenameLookupDict = filenameLookupDict;
 }
 
@@ -1075,6 +1288,12 @@ bool FileUtils::isFileExist(const std::string& filename) const
 {
     if (isAbsolutePath(filename))
     {
+        ResourcePack* pack = nullptr;
+        if (findPackEntry(filename, &pack))
+        {
+            pack->release();
+            return true;
+        }
         return isFileExistInternal(filename);
     }
     else
@@ -1333,6 +1552,7 @@ bool FileUtils::isDirectoryExistInternal(const std::string& dirPath) const
 bool FileUtils::createDirectory(const std::string& path)
 {
     CCASSERT(!path.empty(), "Invalid path");
+    FilesChangedScope filesChanged(this);
 
     if (isDirectoryExist(path))
         return true;
@@ -1410,6 +1630,7 @@ namespace
 
 bool FileUtils::removeDirectory(const std::string& path)
 {
+    FilesChangedScope filesChanged(this);
 #if !defined(CC_TARGET_OS_TVOS)
 
 #if (CC_TARGET_PLATFORM != CC_PLATFORM_ANDROID)
@@ -1434,6 +1655,7 @@ bool FileUtils::removeDirectory(const std::string& path)
 
 bool FileUtils::removeFile(const std::string &path)
 {
+    FilesChangedScope filesChanged(this);
     if (remove(path.c_str())) {
         return false;
     } else {
@@ -1444,6 +1666,7 @@ bool FileUtils::removeFile(const std::string &path)
 bool FileUtils::renameFile(const std::string &oldfullpath, const std::string &newfullpath)
 {
     CCASSERT(!oldfullpath.empty(), "Invalid path");
+    FilesChangedScope filesChanged(this);
     CCASSERT(!newfullpath.empty(), "Invalid path");
 
     int errorCode = rename(oldfullpath.c_str(), newfullpath.c_str());
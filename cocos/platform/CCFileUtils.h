@@ -27,9 +27,13 @@ THE SOFTWARE.
 
 
 #include <type_traits>
+#include <unordered_set>
+#include <memory>
+#include <mutex>
 
 #include "base/CCValue.h"
 #include "base/CCData.h"
+#include "platform/CCResourcePack.h"
 
 NS_CC_BEGIN
 
@@ -151,6 +155,23 @@ public:
      */
     virtual void purgeCachedEntries();
 
+    /**
+     *  Tells the path caches that files under a full path were added, renamed or removed.
+     *  Relative names that were missing, and the directory index of search paths containing the path,
+     *  are looked up again. FileUtils' own write, rename and remove APIs already forget the missing names,
+     *  files changed otherwise, or under an indexed search path, must be announced before they are looked up
+     *  by relative names, from the thread calling fullPathForFilename().
+     */
+    void notifyFilesChanged(const std::string& fullPath);
+
+    /**
+     *  Lists every file under the search paths on first use and resolves relative names with hash lookups
+     *  instead of probing search paths and resolution directories with file system calls.
+     *  Names are matched exactly, so they have to use the case of the files on disk. Disabled by default.
+     */
+    void setDirectoryIndexEnabled(bool enabled);
+    bool isDirectoryIndexEnabled() const { return _directoryIndexEnabled; }
+
     /**
      *  Gets string from a file.
      */
@@ -431,6 +452,22 @@ public:
       */
     void addSearchPath(const std::string & path, const bool front=false);
 
+    /**
+     *  Mounts a resource pack, see ResourcePack. The files in mounted packs overlay the search paths,
+     *  their full paths are the path of the pack followed by their names in it.
+     *  Packs may be mounted and unmounted while other threads are loading files.
+     *
+     *  @param filename The pack, it may be relative to the search paths.
+     *  @param front Whether the pack is searched before the packs mounted earlier.
+     *  @return True if the pack was opened.
+     */
+    bool mountPack(const std::string& filename, bool front = true);
+
+    /**
+     *  Unmounts a pack mounted with mountPack(), views into it stay valid until they are released.
+     */
+    void unmountPack(const std::string& filename);
+
     /**
      *  Gets the array of search paths.
      *
@@ -682,6 +719,53 @@ protected:
      */
     virtual bool isDirectoryExistInternal(const std::string& dirPath) const;
 
+    /**
+     *  Checks whether a search path can be listed into the directory index, it must be a directory on the file system.
+     */
+    virtual bool isDirectoryIndexable(const std::string& dirPath) const;
+
+    /**
+     *  Gets the directory index of a search path, building it on first use.
+     *  @return The files under the search path relative to it, nullptr when it can't be indexed.
+     */
+    const std::unordered_set<std::string>* getDirectoryIndex(const std::string& searchPath) const;
+
+    /**
+     *  Clears the full path cache and the negative lookups, the directory index is kept.
+     */
+    void clearPathCaches() const;
+
+    /**
+     *  Clears the negative lookups, any thread writing files may call it.
+     */
+    void forgetMissingPaths() const;
+
+    /**
+     *  Forgets the missing names when the API writing, renaming or removing files returns,
+     *  so a name looked up before its file existed is searched again.
+     */
+    class FilesChangedScope
+    {
+    public:
+        explicit FilesChangedScope(const FileUtils* fileUtils) : _fileUtils(fileUtils) {}
+        ~FilesChangedScope() { _fileUtils->forgetMissingPaths(); }
+    private:
+        const FileUtils* _fileUtils;
+    };
+
+    /**
+     *  Finds the pack entry of a full path returned by fullPathForFilename().
+     *  The pack is retained, so it stays mapped if it is unmounted meanwhile; release it after reading.
+     *  @return The entry, nullptr when the path is not inside a mounted pack.
+     */
+    const ResourcePack::Entry* findPackEntry(const std::string& fullPath, ResourcePack** pack) const;
+
+    /**
+     *  Reads a full path from the mounted packs.
+     *  @return Status::NotExists when the path is not inside a mounted pack.
+     */
+    Status getContentsFromPack(const std::string& fullPath, ResizableBuffer* buffer) const;
+
     /**
      *  Gets full path for filename, resolution directory and search path.
      *
@@ -740,6 +824,26 @@ protected:
      */
     mutable std::unordered_map<std::string, std::string> _fullPathCache;
 
+    /**
+     *  The relative names nothing was found for, cleared with the full path cache and whenever FileUtils writes files.
+     */
+    mutable std::unordered_set<std::string> _missingPathCache;
+    /** Guards _missingPathCache, files are looked up and written from the worker threads too. */
+    mutable std::mutex _missingPathMutex;
+
+    /**
+     *  Files under each search path when the directory index is enabled, nullptr for search paths that can't be listed.
+     */
+    mutable std::unordered_map<std::string, std::unique_ptr<std::unordered_set<std::string>>> _directoryIndex;
+    bool _directoryIndexEnabled;
+
+    /**
+     *  The mounted packs, searched in order before the search paths.
+     */
+    std::vector<ResourcePack*> _packs;
+    /** Guards _packs, they are searched from the worker threads too. */
+    mutable std::mutex _packsMutex;
+
     /**
      * Writable path.
      */
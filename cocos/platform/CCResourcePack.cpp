@@ -0,0 +1,305 @@
+#include "ccHeader.h"
+#include "platform/CCResourcePack.h"
+#include "platform/CCFileUtils.h"
+#include "xxhash/xxhash.h"
+#include "LzmaDec.h"
+#include <zlib.h>
+
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_WIN32)
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+NS_CC_BEGIN
+
+namespace {
+
+struct Header
+{
+    char magic[4];
+    uint32_t version;
+    uint32_t count;
+    uint32_t namesSize;
+};
+
+static_assert(sizeof(Header) == 16, "pack header layout");
+static_assert(sizeof(ResourcePack::Entry) == 32, "pack entry layout");
+
+void* lzmaAlloc(void* p, size_t size)
+{
+    return malloc(size);
+}
+
+void lzmaFree(void* p, void* address)
+{
+    free(address);
+}
+
+ISzAlloc lzmaAllocator = { lzmaAlloc, lzmaFree };
+
+void releaseDecompressed(void* ptr, void* userData)
+{
+    free(ptr);
+}
+
+} // namespace
+
+const char ResourcePack::MAGIC[4] = { 'C', 'C', 'P', 'K' };
+const uint32_t ResourcePack::VERSION = 1;
+
+ResourcePack* ResourcePack::open(const std::string& fullPath)
+{
+    ResourcePack* pack = new (std::nothrow) ResourcePack(fullPath);
+    if (pack && pack->map() && pack->init())
+    {
+        return pack;
+    }
+    CCLOG("ResourcePack: can not open %s", fullPath.c_str());
+    delete pack;
+    return nullptr;
+}
+
+ResourcePack::ResourcePack(const std::string& fullPath)
+    : _path(fullPath)
+    , _referenceCount(1)
+    , _data(nullptr)
+    , _size(0)
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_WIN32)
+    , _file(INVALID_HANDLE_VALUE)
+    , _mapping(nullptr)
+#endif
+    , _entries(nullptr)
+    , _count(0)
+    , _names(nullptr)
+{
+}
+
+ResourcePack::~ResourcePack()
+{
+    unmap();
+}
+
+void ResourcePack::retain()
+{
+    _referenceCount.fetch_add(1, std::memory_order_relaxed);
+}
+
+void ResourcePack::release()
+{
+    if (_referenceCount.fetch_sub(1, std::memory_order_acq_rel) == 1)
+    {
+        delete this;
+    }
+}
+
+bool ResourcePack::map()
+{
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_WIN32)
+    int length = MultiByteToWideChar(CP_UTF8, 0, _path.c_str(), -1, nullptr, 0);
+    std::wstring widePath(length, L'\0');
+    MultiByteToWideChar(CP_UTF8, 0, _path.c_str(), -1, &widePath[0], length);
+    HANDLE file = CreateFileW(widePath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file != INVALID_HANDLE_VALUE)
+    {
+        LARGE_INTEGER fileSize;
+        HANDLE mapping = GetFileSizeEx(file, &fileSize) && fileSize.QuadPart > 0
+            ? CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr)
+            : nullptr;
+        const void* data = mapping ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+        if (data)
+        {
+            _file = file;
+            _mapping = mapping;
+            _data = static_cast<const uint8_t*>(data);
+            _size = static_cast<size_t>(fileSize.QuadPart);
+            return true;
+        }
+        if (mapping)
+        {
+            CloseHandle(mapping);
+        }
+        CloseHandle(file);
+    }
+#else
+    int fd = ::open(_path.c_str(), O_RDONLY);
+    if (fd >= 0)
+    {
+        struct stat statBuf;
+        void* data = MAP_FAILED;
+        if (fstat(fd, &statBuf) == 0 && statBuf.st_size > 0)
+        {
+            data = mmap(nullptr, static_cast<size_t>(statBuf.st_size), PROT_READ, MAP_SHARED, fd, 0);
+        }
+        // The mapping stays valid once the descriptor is closed.
+        ::close(fd);
+        if (data != MAP_FAILED)
+        {
+            _data = static_cast<const uint8_t*>(data);
+            _size = static_cast<size_t>(statBuf.st_size);
+            return true;
+        }
+    }
+#endif
+
+    // Not a plain file, like the packs inside the APK, it is read once instead.
+    _buffer = FileUtils::getInstance()->getDataFromFile(_path);
+    _data = _buffer.getBytes();
+    _size = static_cast<size_t>(_buffer.getSize());
+    return _data != nullptr;
+}
+
+void ResourcePack::unmap()
+{
+    if (_data && _buffer.isNull())
+    {
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_WIN32)
+        UnmapViewOfFile(_data);
+        CloseHandle(_mapping);
+        CloseHandle(_file);
+        _mapping = nullptr;
+        _file = INVALID_HANDLE_VALUE;
+#else
+        munmap(const_cast<uint8_t*>(_data), _size);
+#endif
+    }
+    _buffer.clear();
+    _data = nullptr;
+    _size = 0;
+}
+
+bool ResourcePack::init()
+{
+    if (_size < sizeof(Header))
+    {
+        return false;
+    }
+    const Header* header = reinterpret_cast<const Header*>(_data);
+    if (memcmp(header->magic, MAGIC, sizeof(MAGIC)) != 0 || header->version != VERSION)
+    {
+        return false;
+    }
+
+    uint64_t namesStart = sizeof(Header) + uint64_t(header->count) * sizeof(Entry);
+    if (namesStart + header->namesSize > _size)
+    {
+        return false;
+    }
+    _entries = reinterpret_cast<const Entry*>(_data + sizeof(Header));
+    _count = header->count;
+    _names = reinterpret_cast<const char*>(_data + namesStart);
+
+    // Checked once here so reads can trust the index.
+    for (uint32_t i = 0; i < _count; ++i)
+    {
+        const Entry& entry = _entries[i];
+        if (uint64_t(entry.nameOffset) + entry.nameSize > header->namesSize ||
+            entry.offset > _size || entry.size > _size - entry.offset ||
+            entry.compression > Compression::Lzma ||
+            (entry.compression == Compression::None && entry.size != entry.rawSize) ||
+            (i > 0 && _entries[i - 1].hash > entry.hash))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+const ResourcePack::Entry* ResourcePack::find(const char* name, size_t length) const
+{
+    uint32_t hash = XXH32(name, static_cast<int>(length), 0);
+    const Entry* end = _entries + _count;
+    const Entry* entry = std::lower_bound(_entries, end, hash, [](const Entry& entry, uint32_t hash)
+    {
+        return entry.hash < hash;
+    });
+    for (; entry != end && entry->hash == hash; ++entry)
+    {
+        if (entry->nameSize == length && memcmp(_names + entry->nameOffset, name, length) == 0)
+        {
+            return entry;
+        }
+    }
+    return nullptr;
+}
+
+const uint8_t* ResourcePack::getView(const Entry* entry) const
+{
+    return entry->compression == Compression::None ? _data + entry->offset : nullptr;
+}
+
+bool ResourcePack::decompress(const Entry* entry, uint8_t* output) const
+{
+    const uint8_t* input = _data + entry->offset;
+    switch (entry->compression)
+    {
+    case Compression::None:
+    {
+        memcpy(output, input, entry->rawSize);
+        return true;
+    }
+    case Compression::Deflate:
+    {
+        uLongf outputSize = entry->rawSize;
+        return uncompress(output, &outputSize, input, entry->size) == Z_OK && outputSize == entry->rawSize;
+    }
+    case Compression::Lzma:
+    {
+        if (entry->size < LZMA_PROPS_SIZE)
+        {
+            return false;
+        }
+        SizeT outputSize = entry->rawSize;
+        SizeT inputSize = entry->size - LZMA_PROPS_SIZE;
+        ELzmaStatus status;
+        SRes ret = LzmaDecode(output, &outputSize, input + LZMA_PROPS_SIZE, &inputSize, input, LZMA_PROPS_SIZE, LZMA_FINISH_ANY, &status, &lzmaAllocator);
+        return ret == SZ_OK && outputSize == entry->rawSize;
+    }
+    }
+    return false;
+}
+
+bool ResourcePack::read(const Entry* entry, ResizableBuffer* buffer) const
+{
+    buffer->resize(entry->rawSize);
+    if (entry->rawSize == 0)
+    {
+        return true;
+    }
+    if (!decompress(entry, static_cast<uint8_t*>(buffer->buffer())))
+    {
+        CCLOG("ResourcePack: can not read %.*s from %s", (int)entry->nameSize, _names + entry->nameOffset, _path.c_str());
+        buffer->resize(0);
+        return false;
+    }
+    return true;
+}
+
+const bgfx::Memory* ResourcePack::readBX(const Entry* entry)
+{
+    if (entry->compression == Compression::None)
+    {
+        retain();
+        return bgfx::makeRef(_data + entry->offset, entry->rawSize, ResourcePack::releaseView, this);
+    }
+
+    // Inflated straight into the block bgfx gets, the only copy made.
+    uint8_t* output = static_cast<uint8_t*>(malloc(entry->rawSize));
+    if (!output || !decompress(entry, output))
+    {
+        CCLOG("ResourcePack: can not read %.*s from %s", (int)entry->nameSize, _names + entry->nameOffset, _path.c_str());
+        free(output);
+        return nullptr;
+    }
+    return bgfx::makeRef(output, entry->rawSize, releaseDecompressed);
+}
+
+void ResourcePack::releaseView(void* ptr, void* userData)
+{
+    static_cast<ResourcePack*>(userData)->release();
+}
+
+NS_CC_END
@@ -0,0 +1,98 @@
+#ifndef __CC_RESOURCE_PACK_H__
+#define __CC_RESOURCE_PACK_H__
+
+#include <atomic>
+#include <string>
+
+#include "platform/CCPlatformMacros.h"
+#include "base/CCData.h"
+
+NS_CC_BEGIN
+
+class ResizableBuffer;
+
+/**
+ * Read only archive of resource files, made by tools/respack/respack.py and mounted with FileUtils::mountPack().
+ *
+ * Layout, little endian: a 16 bytes header ("CCPK", version, entry count, name table size),
+ * the entries sorted by the xxhash32 of their names, the name table, then the entry data aligned to 16 bytes.
+ * Lookups binary search the index, so nothing is scanned or allocated per file.
+ *
+ * A pack on the file system is memory-mapped and stored entries are handed out as views into the mapping,
+ * otherwise (files inside the APK) it is read into memory once. Compressed entries are inflated per file.
+ * The reference count is atomic since bgfx releases the views it was given from its own thread.
+ */
+class CC_DLL ResourcePack
+{
+public:
+    static const char MAGIC[4];
+    static const uint32_t VERSION;
+
+    enum class Compression : uint32_t
+    {
+        None = 0,
+        Deflate = 1, // zlib stream
+        Lzma = 2     // 5 bytes of LZMA properties then the raw stream
+    };
+
+    struct Entry
+    {
+        uint32_t hash;
+        uint32_t nameOffset;
+        uint32_t nameSize;
+        Compression compression;
+        uint64_t offset;
+        uint32_t size;
+        uint32_t rawSize;
+    };
+
+    /** Opens the pack at a full path, returns it with one reference or nullptr when it is missing or invalid. */
+    static ResourcePack* open(const std::string& fullPath);
+
+    void retain();
+    void release();
+
+    const std::string& getPath() const { return _path; }
+    uint32_t getEntryCount() const { return _count; }
+
+    /** Finds an entry by its name relative to the pack root, nullptr when there is none. */
+    const Entry* find(const char* name, size_t length) const;
+    const Entry* find(const std::string& name) const { return find(name.c_str(), name.size()); }
+
+    /** The stored bytes of an uncompressed entry, valid while the pack is referenced, nullptr when compressed. */
+    const uint8_t* getView(const Entry* entry) const;
+
+    /** Fills buffer with the contents of an entry, inflating it when compressed. */
+    bool read(const Entry* entry, ResizableBuffer* buffer) const;
+
+    /** Uncompressed entries are referenced in place and keep the pack alive until bgfx is done with them. */
+    const bgfx::Memory* readBX(const Entry* entry);
+
+private:
+    explicit ResourcePack(const std::string& fullPath);
+    ~ResourcePack();
+
+    bool map();
+    void unmap();
+    bool init();
+    bool decompress(const Entry* entry, uint8_t* output) const;
+
+    static void releaseView(void* ptr, void* userData);
+
+    std::string _path;
+    std::atomic<int> _referenceCount;
+    const uint8_t* _data;
+    size_t _size;
+    Data _buffer;
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_WIN32)
+    void* _file;
+    void* _mapping;
+#endif
+    const Entry* _entries;
+    uint32_t _count;
+    const char* _names;
+};
+
+NS_CC_END
+
+#endif // __CC_RESOURCE_PACK_H__
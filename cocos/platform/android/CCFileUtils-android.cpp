@@ -251,6 +251,12 @@ bool FileUtilsAndroid::isAbsolutePath(const std::string& strPath) const
     return false;
 }
 
+bool FileUtilsAndroid::isDirectoryIndexable(const std::string& dirPath) const
+{
+    // Directories inside the APK can't be listed, lookups there go through the asset manager.
+    return !dirPath.empty() && dirPath[0] == '/' && isDirectoryExistInternal(dirPath);
+}
+
 FileUtils::Status FileUtilsAndroid::getContents(const std::string& filename, ResizableBuffer* buffer)
 {
     static const std::string apkprefix("assets/");
@@ -259,6 +265,10 @@ FileUtils::Status FileUtilsAndroid::getContents(const std::string& filename, Res
 
     string fullPath = fullPathForFilename(filename);
 
+    Status packStatus = getContentsFromPack(fullPath, buffer);
+    if (packStatus != Status::NotExists)
+        return packStatus;
+
     if (fullPath[0] == '/')
         return FileUtils::getContents(fullPath, buffer);
 
@@ -74,6 +74,7 @@ public:
 private:
     virtual bool isFileExistInternal(const std::string& strFilePath) const override;
     virtual bool isDirectoryExistInternal(const std::string& dirPath) const override;
+    virtual bool isDirectoryIndexable(const std::string& dirPath) const override;
 
     static AAssetManager* assetmanager;
     static ZipFile* obbfile;
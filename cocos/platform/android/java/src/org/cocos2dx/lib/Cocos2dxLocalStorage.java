@@ -50,6 +50,7 @@ public class Cocos2dxLocalStorage {
             TABLE_NAME = tableName;
             mDatabaseOpenHelper = new DBOpenHelper(Cocos2dxActivity.getContext());
             mDatabase = mDatabaseOpenHelper.getWritableDatabase();
+            mDatabase.enableWriteAheadLogging();
             return true;
         }
         return false;
@@ -109,6 +110,23 @@ public class Cocos2dxLocalStorage {
         }
     }
 
+    public static void beginBatch() {
+        try {
+            mDatabase.beginTransactionNonExclusive();
+        } catch (Exception e) {
+            e.printStackTrace();
+        }
+    }
+
+    public static void endBatch() {
+        try {
+            mDatabase.setTransactionSuccessful();
+            mDatabase.endTransaction();
+        } catch (Exception e) {
+            e.printStackTrace();
+        }
+    }
+
     /**
      * This creates/opens the database.
      */
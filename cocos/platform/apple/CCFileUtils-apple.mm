@@ -298,6 +298,7 @@ static int unlink_cb(const char *fpath, const struct stat *sb, int typeflag, str
 
 bool FileUtilsApple::removeDirectory(const std::string& path)
 {
+    FilesChangedScope filesChanged(this);
     if (path.empty())
     {
         CCLOGERROR("Fail to remove directory, path is empty!");
@@ -380,6 +381,7 @@ bool FileUtilsApple::writeToFile(const ValueMap& dict, const std::string &fullPa
 
 bool FileUtils::writeValueMapToFile(const ValueMap& dict, const std::string& fullPath)
 {
+    FilesChangedScope filesChanged(this);
     valueMapCompact(const_cast<ValueMap&>(dict));
     //CCLOG("iOS||Mac Dictionary %d write to file %s", dict->_ID, fullPath.c_str());
     NSMutableDictionary *nsDict = [NSMutableDictionary dictionary];
@@ -448,6 +450,7 @@ void FileUtilsApple::valueVectorCompact(ValueVector& valueVector)
 
 bool FileUtils::writeValueVectorToFile(const ValueVector& vecData, const std::string& fullPath)
 {
+    FilesChangedScope filesChanged(this);
     NSString* path = [NSString stringWithUTF8String:fullPath.c_str()];
     NSMutableArray* array = [NSMutableArray array];
 
@@ -483,6 +486,7 @@ ValueVector FileUtilsApple::getValueVectorFromFile(const std::string& filename)
 
 bool FileUtilsApple::createDirectory(const std::string& path)
 {
+    FilesChangedScope filesChanged(this);
     CCASSERT(!path.empty(), "Invalid path");
     
     if (isDirectoryExist(path))
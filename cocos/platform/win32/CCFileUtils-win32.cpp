@@ -171,6 +171,10 @@ FileUtils::Status FileUtilsWin32::getContents(const std::string& filename, Resiz
     // read the file from hardware
     std::string fullPath = FileUtils::getInstance()->fullPathForFilename(filename);
 
+    Status packStatus = getContentsFromPack(fullPath, buffer);
+    if (packStatus != Status::NotExists)
+        return packStatus;
+
     HANDLE fileHandle = ::CreateFile(StringUtf8ToWideChar(fullPath).c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, NULL, OPEN_EXISTING, NULL, nullptr);
     if (fileHandle == INVALID_HANDLE_VALUE)
         return FileUtils::Status::OpenFailed;
@@ -274,21 +278,15 @@ string FileUtilsWin32::getWritablePath() const
 
 bool FileUtilsWin32::renameFile(const std::string &oldfullpath, const std::string& newfullpath)
 {
+    FilesChangedScope filesChanged(this);
     CCASSERT(!oldfullpath.empty(), "Invalid path");
     CCASSERT(!newfullpath.empty(), "Invalid path");
 
     std::wstring _wNew = StringUtf8ToWideChar(newfullpath);
     std::wstring _wOld = StringUtf8ToWideChar(oldfullpath);
 
-    if (FileUtils::getInstance()->isFileExist(newfullpath))
-    {
-        if (!DeleteFile(_wNew.c_str()))
-        {
-            CCLOGERROR("Fail to delete file %s !Error code is 0x%x", newfullpath.c_str(), GetLastError());
-        }
-    }
-
-    if (MoveFile(_wOld.c_str(), _wNew.c_str()))
+    // Replaces an existing file in one step, readers see either the old or the new content
+    if (MoveFileEx(_wOld.c_str(), _wNew.c_str(), MOVEFILE_REPLACE_EXISTING))
     {
         return true;
     }
@@ -314,6 +312,7 @@ bool FileUtilsWin32::renameFile(const std::string &path, const std::string &oldn
 
 bool FileUtilsWin32::createDirectory(const std::string& dirPath)
 {
+    FilesChangedScope filesChanged(this);
     CCASSERT(!dirPath.empty(), "Invalid path");
 
     if (isDirectoryExist(dirPath))
@@ -371,6 +370,7 @@ bool FileUtilsWin32::createDirectory(const std::string& dirPath)
 
 bool FileUtilsWin32::removeFile(const std::string &filepath)
 {
+    FilesChangedScope filesChanged(this);
     std::regex pat("\\/");
     std::string win32path = std::regex_replace(filepath, pat, "\\");
 
@@ -387,6 +387,7 @@ bool FileUtilsWin32::removeFile(const std::string &filepath)
 
 bool FileUtilsWin32::removeDirectory(const std::string& dirPath)
 {
+    FilesChangedScope filesChanged(this);
     std::wstring wpath = StringUtf8ToWideChar(dirPath);
     std::wstring files = wpath + L"*.*";
     WIN32_FIND_DATA wfd;
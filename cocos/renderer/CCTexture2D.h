@@ -510,7 +510,7 @@ protected:
     uint32_t flags_;
     bgfx::TextureHandle handle_;
     bgfx::TextureInfo info_;
-    COCOS_TYPE_OVERRIDE(Texture2D);
+    COCOS_TYPE_OVERRIDE(Texture2D, Ref);
 };
 
 
@@ -117,11 +117,9 @@ void TextureCache::addImageAsync(String filename, const std::function<void(Textu
         {
             bimg::ImageContainer* imageContainer = bimg::imageParse(&allocator_, data, static_cast<uint32_t>(size));
             free(data);
-            return TValues::create(imageContainer);
-        }, [this, file, callback](TValues* result) 
+            return imageContainer;
+        }, [this, file, callback](bimg::ImageContainer* imageContainer)
         {
-            bimg::ImageContainer* imageContainer;
-            result->get(imageContainer);
             if (imageContainer)
             {
                 uint64_t flags = BGFX_SAMPLER_U_CLAMP | BGFX_SAMPLER_V_CLAMP;
@@ -188,11 +186,9 @@ void TextureCache::addImageAsyncOnTexture(String filename, Texture2D* texInput,
         {
             bimg::ImageContainer* imageContainer = bimg::imageParse(&allocator_, data, static_cast<uint32_t>(size));
             free(data);
-            return TValues::create(imageContainer);
-        }, [this, file, texInput, callback](TValues* result)
+            return imageContainer;
+        }, [this, file, texInput, callback](bimg::ImageContainer* imageContainer)
         {
-            bimg::ImageContainer* imageContainer;
-            result->get(imageContainer);
             if (imageContainer)
             {
                 uint64_t flags = BGFX_SAMPLER_U_CLAMP | BGFX_SAMPLER_V_CLAMP;
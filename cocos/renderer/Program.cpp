@@ -3,6 +3,7 @@
 #include "ccHeader.h"
 #include "Program.h"
 #include "CCShaderCache.h"
+#include "SkinnedMesh.h"
 
 NS_CC_BEGIN
 
@@ -176,4 +177,36 @@ bgfx::UniformHandle SpriteProgram::getSampler() const
     return sampler_;
 }
 
+/*SkinnedProgram*/
+
+SkinnedProgram::SkinnedProgram(String vertShader, String fragShader)
+    : SpriteProgram(vertShader, fragShader)
+    , bones_(bgfx::createUniform("u_bones", bgfx::UniformType::Vec4, SkinnedMesh::MAX_BONES * 2))
+    , color_(bgfx::createUniform("u_skinColor", bgfx::UniformType::Vec4))
+{
+
+}
+
+SkinnedProgram::~SkinnedProgram()
+{
+    if (bgfx::isValid(bones_))
+    {
+        bgfx::destroy(bones_);
+    }
+    if (bgfx::isValid(color_))
+    {
+        bgfx::destroy(color_);
+    }
+}
+
+bgfx::UniformHandle SkinnedProgram::getBones() const
+{
+    return bones_;
+}
+
+bgfx::UniformHandle SkinnedProgram::getColor() const
+{
+    return color_;
+}
+
 NS_CC_END
\ No newline at end of file
@@ -41,7 +41,7 @@ private:
     SmartPtr<Shader> vertShader_;
     bgfx::ProgramHandle program_;
     std::unordered_map<std::string, SmartPtr<Uniform>> uniforms_;
-    COCOS_TYPE_OVERRIDE(Program);
+    COCOS_TYPE_OVERRIDE(Program, Ref);
 };
 
 class SpriteProgram : public Program
@@ -55,7 +55,22 @@ protected:
     SpriteProgram(String vertShader, String fragShader);
 private:
     bgfx::UniformHandle sampler_;
-    COCOS_TYPE_OVERRIDE(SpriteProgram);
+    COCOS_TYPE_OVERRIDE(SpriteProgram, Program);
+};
+
+class SkinnedProgram : public SpriteProgram
+{
+public:
+    virtual ~SkinnedProgram();
+    bgfx::UniformHandle getBones() const;
+    bgfx::UniformHandle getColor() const;
+    CREATE_FUNC(SkinnedProgram);
+protected:
+    SkinnedProgram(String vertShader, String fragShader);
+private:
+    bgfx::UniformHandle bones_;
+    bgfx::UniformHandle color_;
+    COCOS_TYPE_OVERRIDE(SkinnedProgram, SpriteProgram);
 };
 
 
@@ -6,6 +6,7 @@
 #include "base/Camera.h"
 #include "renderer/Program.h"
 #include "renderer/CCTexture2D.h"
+#include "renderer/SkinnedMesh.h"
 
 NS_CC_BEGIN
 
@@ -31,6 +32,8 @@ Renderer::Renderer()
     , gradientOutlineProgram_(SpriteProgram::create("vs_labelposition.bin"_slice, "fs_labelgradientoutline.bin"_slice))
     //, distanceFieldProgram_(SpriteProgram::create("vs_labelposition.bin"_slice, "fs_labeldf.bin"_slice))
     //, distanceFieldGlowProgram_(SpriteProgram::create("vs_labelposition.bin"_slice, "fs_labeldfglow.bin"_slice))
+    , twoColorProgram_(SpriteProgram::create("vs_spritetwocolor.bin"_slice, "fs_spritetwocolor.bin"_slice))
+    , skinnedProgram_(SkinnedProgram::create("vs_spriteskinned.bin"_slice, "fs_sprite.bin"_slice))
     , lastProgram_(nullptr)
     , lastTexture_(nullptr)
     , lastState_(0)
@@ -94,6 +97,16 @@ SpriteProgram* Renderer::getDistanceFieldGlowProgram() const
     return distanceFieldGlowProgram_;
 }
 
+SpriteProgram* Renderer::getTwoColorProgram() const
+{
+    return twoColorProgram_;
+}
+
+SkinnedProgram* Renderer::getSkinnedProgram() const
+{
+    return skinnedProgram_;
+}
+
 void Renderer::push(V3F_C4B_T2F* verts, uint32_t vsize,
     uint16_t* indices, uint32_t isize,
     SpriteProgram* program, Texture2D* texture, 
@@ -154,6 +167,26 @@ void Renderer::push(V3F_C4B_T2F* verts, uint32_t vsize,
     }
 }
 
+// 2D nodes keep their world in the xy plane, so most batches skip the full 4x4 point transform.
+template<typename Vertex>
+static void transformVertices(Vertex* verts, size_t count, const Mat4& modelWorld)
+{
+    if (modelWorld.isAffine2D())
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            modelWorld.transformPointAffine2D(verts[i].vertices, &verts[i].vertices);
+        }
+    }
+    else
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            modelWorld.transformPoint(&verts[i].vertices);
+        }
+    }
+}
+
 void Renderer::push(V3F_C4B_T2F* verts, uint32_t vsize, 
     uint16_t* indices, uint32_t isize,
     SpriteProgram* program, Texture2D* texture, 
@@ -172,10 +205,7 @@ void Renderer::push(V3F_C4B_T2F* verts, uint32_t vsize,
     size_t oldVertSize = vertices_.size();
     vertices_.resize(oldVertSize + vsize);
     std::memcpy(vertices_.data() + oldVertSize, verts, sizeof(verts[0]) * vsize);
-    for (size_t i = 0; i < vsize; ++i)
-    {
-        modelWorld.transformPoint(&vertices_[oldVertSize + i].vertices);
-    }
+    transformVertices(vertices_.data() + oldVertSize, vsize, modelWorld);
 
     size_t oldIndexSize = indices_.size();
     indices_.resize(oldIndexSize + isize);
@@ -206,13 +236,7 @@ void Renderer::push(V3F_C4B_T2F_Quad* quads, uint32_t quadsCount,
     size_t oldVertSize = vertices_.size();
     vertices_.resize(oldVertSize + vsize);
     std::memcpy(vertices_.data() + oldVertSize, &quads->tl, sizeof(V3F_C4B_T2F) * vsize);
-    for (size_t i = 0; i < vsize / 4; ++i)
-    {
-        modelWorld.transformPoint(quads[i].tl.vertices, &vertices_[oldVertSize + i * 4 + 0].vertices);
-        modelWorld.transformPoint(quads[i].bl.vertices, &vertices_[oldVertSize + i * 4 + 1].vertices);
-        modelWorld.transformPoint(quads[i].tr.vertices, &vertices_[oldVertSize + i * 4 + 2].vertices);
-        modelWorld.transformPoint(quads[i].br.vertices, &vertices_[oldVertSize + i * 4 + 3].vertices);
-    }
+    transformVertices(vertices_.data() + oldVertSize, vsize, modelWorld);
 
     size_t oldIndexSize = indices_.size();
     indices_.resize(oldIndexSize + isize);
@@ -227,38 +251,100 @@ void Renderer::push(V3F_C4B_T2F_Quad* quads, uint32_t quadsCount,
     }
 }
 
+void Renderer::push(V3F_C4B_C4B_T2F* verts, uint32_t vsize,
+    uint16_t* indices, uint32_t isize,
+    SpriteProgram* program, Texture2D* texture,
+    uint64_t state, uint32_t flags, const Mat4& modelWorld)
+{
+    if (!vertices_.empty() || program != lastProgram_ || texture != lastTexture_ || state != lastState_ || flags != lastFlags_
+        || twoColorVertices_.size() + vsize > UINT16_MAX)
+    {
+        render();
+    }
+
+    lastProgram_ = program;
+    lastTexture_ = texture;
+    lastState_ = state;
+    lastFlags_ = flags;
+
+    size_t oldVertSize = twoColorVertices_.size();
+    twoColorVertices_.resize(oldVertSize + vsize);
+    V3F_C4B_C4B_T2F* dst = twoColorVertices_.data() + oldVertSize;
+    std::memcpy(dst, verts, sizeof(verts[0]) * vsize);
+    transformVertices(dst, vsize, modelWorld);
+
+    size_t oldIndexSize = indices_.size();
+    indices_.resize(oldIndexSize + isize);
+    for (size_t i = 0; i < isize; ++i)
+    {
+        indices_[oldIndexSize + i] = indices[i] + oldVertSize;
+    }
+}
+
+void Renderer::push(SkinnedMesh* mesh, const Vec4* bones, const Color4B& color,
+    Texture2D* texture, uint64_t state, uint32_t flags, const Mat4& modelWorld)
+{
+    // the bone palette is per draw, so skinned meshes never join a batch
+    render();
+
+    IRenderer::render();
+    Vec4 skinColor(color.r / 255.0f, color.g / 255.0f, color.b / 255.0f, color.a / 255.0f);
+    bgfx::setTransform(modelWorld.m);
+    bgfx::setVertexBuffer(0, mesh->getVertexBuffer());
+    bgfx::setIndexBuffer(mesh->getIndexBuffer());
+    bgfx::setUniform(skinnedProgram_->getBones(), bones, static_cast<uint16_t>(mesh->getBoneCount() * 2));
+    bgfx::setUniform(skinnedProgram_->getColor(), &skinColor);
+    bgfx::setState(state);
+    bgfx::setTexture(0, skinnedProgram_->getSampler(), texture->getHandle(), flags);
+    bgfx::submit(SharedView.getId(), skinnedProgram_->apply());
+}
+
+template<typename Vertex>
+void Renderer::submit(std::vector<Vertex>& vertices)
+{
+    bgfx::TransientVertexBuffer vertexBuffer;
+    bgfx::TransientIndexBuffer indexBuffer;
+    uint32_t vertexCount = static_cast<uint32_t>(vertices.size());
+    uint32_t indexCount = static_cast<uint32_t>(indices_.size());
+    if (bgfx::allocTransientBuffers(
+        &vertexBuffer, Vertex::ms_decl, vertexCount,
+        &indexBuffer, indexCount))
+    {
+        IRenderer::render();
+        std::memcpy(vertexBuffer.data, vertices.data(), vertexCount * sizeof(vertices[0]));
+        bgfx::setVertexBuffer(0, &vertexBuffer);
+        std::memcpy(indexBuffer.data, indices_.data(), indexCount * sizeof(indices_[0]));
+        bgfx::setIndexBuffer(&indexBuffer);
+
+        uint8_t viewId = SharedView.getId();
+        //Mat4 viewProj; //set at director draw
+        //bx::mtxMul(viewProj, SharedDirector.getCamera()->getView(), SharedView.getProjection());
+        //bgfx::setViewTransform(viewId, SharedDirector.getCamera()->getView(), SharedView.getProjection());
+        bgfx::setState(lastState_);
+        bgfx::setTexture(0, lastProgram_->getSampler(), lastTexture_->getHandle(), lastFlags_);
+        bgfx::submit(viewId, lastProgram_->apply());
+    }
+    else
+    {
+        CCLOG("not enough transient buffer for %d vertices, %d indices.", vertexCount, indexCount);
+    }
+    vertices.clear();
+    indices_.clear();
+}
+
 void Renderer::render()
 {
-    if (!vertices_.empty())
+    if (!vertices_.empty() || !twoColorVertices_.empty())
     {
-        bgfx::TransientVertexBuffer vertexBuffer;
-        bgfx::TransientIndexBuffer indexBuffer;
-        uint32_t vertexCount = static_cast<uint32_t>(vertices_.size());
-        uint32_t indexCount = static_cast<uint32_t>(indices_.size());
-        if (bgfx::allocTransientBuffers(
-            &vertexBuffer, V3F_C4B_T2F::ms_decl, vertexCount,
-            &indexBuffer, indexCount))
+        // the vertex formats never share a batch, switching formats always switches the program too
+        if (!vertices_.empty())
         {
-            IRenderer::render();
-            std::memcpy(vertexBuffer.data, vertices_.data(), vertexCount * sizeof(vertices_[0]));
-            bgfx::setVertexBuffer(0, &vertexBuffer);
-            std::memcpy(indexBuffer.data, indices_.data(), indexCount * sizeof(indices_[0]));
-            bgfx::setIndexBuffer(&indexBuffer);
-
-            uint8_t viewId = SharedView.getId();
-            //Mat4 viewProj; //set at director draw
-            //bx::mtxMul(viewProj, SharedDirector.getCamera()->getView(), SharedView.getProjection());
-            //bgfx::setViewTransform(viewId, SharedDirector.getCamera()->getView(), SharedView.getProjection());
-            bgfx::setState(lastState_);
-            bgfx::setTexture(0, lastProgram_->getSampler(), lastTexture_->getHandle(), lastFlags_);
-            bgfx::submit(viewId, lastProgram_->apply());
+            submit(vertices_);
         }
         else
         {
-            CCLOG("not enough transient buffer for %d vertices, %d indices.", vertexCount, indexCount);
+            submit(twoColorVertices_);
         }
-        vertices_.clear();
-        indices_.clear();
         lastProgram_ = nullptr;
         lastTexture_ = nullptr;
         lastState_ = 0;
@@ -6,6 +6,8 @@ NS_CC_BEGIN
 
 class Node;
 class SpriteProgram;
+class SkinnedProgram;
+class SkinnedMesh;
 class Program;
 class Texture2D;
 
@@ -30,16 +32,24 @@ public:
     PROPERTY_READONLY(SpriteProgram*, GradientOutlineProgram);
     PROPERTY_READONLY(SpriteProgram*, DistanceField);
     PROPERTY_READONLY(SpriteProgram*, DistanceFieldGlowProgram);
+    PROPERTY_READONLY(SpriteProgram*, TwoColorProgram);
+    PROPERTY_READONLY(SkinnedProgram*, SkinnedProgram);
     void render() override;
     void push(V3F_C4B_T2F* verts, uint32_t vsize, uint16_t* indices, uint32_t isize, SpriteProgram* program, Texture2D* texture, uint64_t state, uint32_t flags);
     void push(V3F_C4B_T2F* verts, uint32_t vsize, uint16_t* indices, uint32_t isize, SpriteProgram* program, Texture2D* texture, uint64_t state, uint32_t flags, const float* modelWorld);
     void push(V3F_C4B_T2F* verts, uint32_t vsize, uint16_t* indices, uint32_t isize, SpriteProgram* program, Texture2D* texture, uint64_t state, uint32_t flags, const Mat4& modelWorld);
     void push(V3F_C4B_T2F_Quad* quads, uint32_t quadsCount, SpriteProgram* program, Texture2D* texture, uint64_t state, uint32_t flags, const Mat4& modelWorld);
+    /** two color tinted vertices, batched separately from the sprite vertices with their own vertex decl */
+    void push(V3F_C4B_C4B_T2F* verts, uint32_t vsize, uint16_t* indices, uint32_t isize, SpriteProgram* program, Texture2D* texture, uint64_t state, uint32_t flags, const Mat4& modelWorld);
+    /** draws a mesh skinned on the GPU right away, bones holds two rows per bone of the mesh palette */
+    void push(SkinnedMesh* mesh, const Vec4* bones, const Color4B& color, Texture2D* texture, uint64_t state, uint32_t flags, const Mat4& modelWorld);
     /** returns whether or not a rectangle is visible or not */
     bool checkVisibility(const Mat4& transform, const Size& size) { return true; }
 protected:
     Renderer();
 private:
+    template<typename Vertex>
+    void submit(std::vector<Vertex>& vertices);
     SmartPtr<SpriteProgram> defaultProgram_;
     SmartPtr<SpriteProgram> defaultProgramMVP_;
     SmartPtr<SpriteProgram> lightProgram_;
@@ -51,8 +61,11 @@ private:
     SmartPtr<SpriteProgram> gradientOutlineProgram_;
     SmartPtr<SpriteProgram> distanceFieldProgram_;
     SmartPtr<SpriteProgram> distanceFieldGlowProgram_;
+    SmartPtr<SpriteProgram> twoColorProgram_;
+    SmartPtr<SkinnedProgram> skinnedProgram_;
 
     std::vector<V3F_C4B_T2F> vertices_;
+    std::vector<V3F_C4B_C4B_T2F> twoColorVertices_;
     std::vector<uint16_t> indices_;
     uint64_t lastState_;
     uint32_t lastFlags_;
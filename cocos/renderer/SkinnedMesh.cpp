@@ -0,0 +1,46 @@
+#include "ccHeader.h"
+#include "SkinnedMesh.h"
+
+NS_CC_BEGIN
+
+SkinnedMesh::SkinnedMesh(const SkinnedVertex* verts, uint32_t vsize, const uint16_t* indices, uint32_t isize, uint32_t boneCount)
+    : vertexBuffer_(bgfx::createVertexBuffer(bgfx::copy(verts, vsize * sizeof(verts[0])), SkinnedVertex::ms_decl))
+    , indexBuffer_(bgfx::createIndexBuffer(bgfx::copy(indices, isize * sizeof(indices[0]))))
+    , boneCount_(boneCount)
+{
+
+}
+
+SkinnedMesh::~SkinnedMesh()
+{
+    if (bgfx::isValid(vertexBuffer_))
+    {
+        bgfx::destroy(vertexBuffer_);
+    }
+    if (bgfx::isValid(indexBuffer_))
+    {
+        bgfx::destroy(indexBuffer_);
+    }
+}
+
+bool SkinnedMesh::init()
+{
+    return boneCount_ <= MAX_BONES && bgfx::isValid(vertexBuffer_) && bgfx::isValid(indexBuffer_);
+}
+
+bgfx::VertexBufferHandle SkinnedMesh::getVertexBuffer() const
+{
+    return vertexBuffer_;
+}
+
+bgfx::IndexBufferHandle SkinnedMesh::getIndexBuffer() const
+{
+    return indexBuffer_;
+}
+
+uint32_t SkinnedMesh::getBoneCount() const
+{
+    return boneCount_;
+}
+
+NS_CC_END
@@ -0,0 +1,32 @@
+#pragma once
+
+#include "base/ccTypes.h"
+
+NS_CC_BEGIN
+
+/**
+ * Static vertex and index buffers of a mesh in its bind pose, skinned in the vertex shader.
+ * Each vertex blends up to MAX_INFLUENCES bone local positions, the bones are taken from a palette
+ * of at most MAX_BONES 2x3 matrices passed to Renderer::push every draw, two Vec4 rows per bone.
+ */
+class CC_DLL SkinnedMesh : public Ref
+{
+public:
+    static const uint32_t MAX_BONES = 60;
+    static const uint32_t MAX_INFLUENCES = 4;
+    PROPERTY_READONLY(bgfx::VertexBufferHandle, VertexBuffer);
+    PROPERTY_READONLY(bgfx::IndexBufferHandle, IndexBuffer);
+    PROPERTY_READONLY(uint32_t, BoneCount);
+    virtual ~SkinnedMesh();
+    bool init();
+    CREATE_FUNC(SkinnedMesh);
+protected:
+    SkinnedMesh(const SkinnedVertex* verts, uint32_t vsize, const uint16_t* indices, uint32_t isize, uint32_t boneCount);
+private:
+    bgfx::VertexBufferHandle vertexBuffer_;
+    bgfx::IndexBufferHandle indexBuffer_;
+    uint32_t boneCount_;
+    COCOS_TYPE_OVERRIDE(SkinnedMesh, Ref);
+};
+
+NS_CC_END
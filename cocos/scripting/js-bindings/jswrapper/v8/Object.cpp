@@ -35,6 +35,28 @@ namespace se {
     
     namespace {
         v8::Isolate* __isolate = nullptr;
+
+        // Property names are looked up as internalized strings made once, instead of a new string V8 has to hash and internalize every time
+        const size_t PROPERTY_KEY_MAX_LENGTH = 32;
+        const size_t PROPERTY_KEY_CACHE_SIZE = 1024;
+        std::unordered_map<std::string, v8::Global<v8::String>> __propertyKeys;
+
+        v8::MaybeLocal<v8::String> getPropertyKey(const char* name)
+        {
+            size_t length = strlen(name);
+            if (length > PROPERTY_KEY_MAX_LENGTH)
+                return v8::String::NewFromUtf8(__isolate, name, v8::NewStringType::kNormal, (int)length);
+
+            std::string key(name, length);
+            auto iter = __propertyKeys.find(key);
+            if (iter != __propertyKeys.end())
+                return iter->second.Get(__isolate);
+
+            v8::MaybeLocal<v8::String> nameValue = v8::String::NewFromUtf8(__isolate, name, v8::NewStringType::kInternalized, (int)length);
+            if (!nameValue.IsEmpty() && __propertyKeys.size() < PROPERTY_KEY_CACHE_SIZE)
+                __propertyKeys.emplace(std::move(key), v8::Global<v8::String>(__isolate, nameValue.ToLocalChecked()));
+            return nameValue;
+        }
     }
 
     Object::Object()
@@ -154,6 +176,7 @@ namespace se {
         }
 
         __objectMap.clear();
+        __propertyKeys.clear();
         __isolate = nullptr;
     }
 
@@ -304,31 +327,34 @@ namespace se {
             return false;
         }
 
-        v8::MaybeLocal<v8::String> nameValue = v8::String::NewFromUtf8(__isolate, name, v8::NewStringType::kNormal);
+        v8::MaybeLocal<v8::String> nameValue = getPropertyKey(name);
         if (nameValue.IsEmpty())
             return false;
 
         v8::Local<v8::String> nameValToLocal = nameValue.ToLocalChecked();
         v8::Local<v8::Context> context = __isolate->GetCurrentContext();
-        v8::Maybe<bool> maybeExist = _obj.handle(__isolate)->Has(context, nameValToLocal);
-        if (maybeExist.IsNothing())
-            return false;
-
-        if (!maybeExist.FromJust())
-            return false;
-
-        v8::MaybeLocal<v8::Value> result = _obj.handle(__isolate)->Get(context, nameValToLocal);
+        v8::Local<v8::Object> jsobj = _obj.handle(__isolate);
+        v8::MaybeLocal<v8::Value> result = jsobj->Get(context, nameValToLocal);
         if (result.IsEmpty())
             return false;
 
-        internal::jsToSeValue(__isolate, result.ToLocalChecked(), data);
+        v8::Local<v8::Value> resultValue = result.ToLocalChecked();
+        // Only undefined needs the second lookup telling a missing property from an undefined one
+        if (resultValue->IsUndefined())
+        {
+            v8::Maybe<bool> maybeExist = jsobj->Has(context, nameValToLocal);
+            if (maybeExist.IsNothing() || !maybeExist.FromJust())
+                return false;
+        }
+
+        internal::jsToSeValue(__isolate, resultValue, data);
 
         return true;
     }
 
     bool Object::setProperty(const char *name, const Value& data)
     {
-        v8::MaybeLocal<v8::String> nameValue = v8::String::NewFromUtf8(__isolate, name, v8::NewStringType::kNormal);
+        v8::MaybeLocal<v8::String> nameValue = getPropertyKey(name);
         if (nameValue.IsEmpty())
             return false;
 
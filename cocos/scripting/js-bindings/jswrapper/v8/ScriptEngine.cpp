@@ -31,6 +31,10 @@
 #include "../State.hpp"
 #include "../MappingUtils.hpp"
 
+#include "xxhash/xxhash.h"
+
+#include <stdio.h>
+
 #if SE_ENABLE_INSPECTOR
 #include "inspector_agent.h"
 #include "env.h"
@@ -47,6 +51,44 @@ namespace se {
     namespace {
         ScriptEngine* __instance = nullptr;
 
+        // Smaller scripts compile faster than their cache is read
+        const size_t CODE_CACHE_MIN_SOURCE_SIZE = 4096;
+        const uint32_t CODE_CACHE_MAGIC = 0x43434553; // "SECC"
+
+        // Begins the cache files, the cached data follows
+        struct CodeCacheHeader
+        {
+            uint32_t magic;
+            // Changes with the V8 version and flags
+            uint32_t versionTag;
+            uint32_t sourceHash;
+            uint32_t sourceLength;
+            uint32_t dataLength;
+        };
+
+        // One file per script, rewritten when the script changes, so the directory doesn't grow with every update
+        std::string getCodeCacheFile(const std::string& dir, const std::string& sourceUrl)
+        {
+            char name[32] = {0};
+            snprintf(name, sizeof(name), "%08x%08x.jscache", XXH32(sourceUrl.data(), (int)sourceUrl.size(), 0), (uint32_t)sourceUrl.size());
+            return dir + name;
+        }
+
+        bool checkCodeCache(const std::vector<uint8_t>& content, const CodeCacheHeader& expected)
+        {
+            if (content.size() < sizeof(CodeCacheHeader))
+                return false;
+
+            CodeCacheHeader header;
+            memcpy(&header, content.data(), sizeof(header));
+            return header.magic == expected.magic
+                && header.versionTag == expected.versionTag
+                && header.sourceHash == expected.sourceHash
+                && header.sourceLength == expected.sourceLength
+                && header.dataLength > 0
+                && content.size() == sizeof(header) + header.dataLength;
+        }
+
         void __log(const v8::FunctionCallbackInfo<v8::Value>& info)
         {
             if (info[0]->IsString())
@@ -617,6 +659,10 @@ namespace se {
         if (length < 0)
             length = strlen(script);
 
+        // Only the script files are cached, not the strings evaluated on the fly
+        bool useCodeCache = fileName != nullptr && !_codeCachePath.empty() && (size_t)length >= CODE_CACHE_MIN_SOURCE_SIZE
+            && _fileOperationDelegate.onReadCodeCache != nullptr && _fileOperationDelegate.onWriteCodeCache != nullptr;
+
         if (fileName == nullptr)
             fileName = "(no filename)";
 
@@ -640,7 +686,11 @@ namespace se {
             return false;
 
         v8::ScriptOrigin origin(originStr.ToLocalChecked());
-        v8::MaybeLocal<v8::Script> maybeScript = v8::Script::Compile(_context.Get(_isolate), source.ToLocalChecked(), &origin);
+        v8::MaybeLocal<v8::Script> maybeScript;
+        if (useCodeCache)
+            maybeScript = compileWithCodeCache(source.ToLocalChecked(), origin, script, length, sourceUrl);
+        else
+            maybeScript = v8::Script::Compile(_context.Get(_isolate), source.ToLocalChecked(), &origin);
 
         bool success = false;
 
@@ -666,6 +716,64 @@ namespace se {
         return success;
     }
 
+    v8::MaybeLocal<v8::Script> ScriptEngine::compileWithCodeCache(v8::Local<v8::String> source, const v8::ScriptOrigin& origin, const char* script, size_t length, const std::string& sourceUrl)
+    {
+        auto startTime = std::chrono::steady_clock::now();
+
+        CodeCacheHeader header;
+        header.magic = CODE_CACHE_MAGIC;
+        header.versionTag = v8::ScriptCompiler::CachedDataVersionTag();
+        header.sourceHash = XXH32(script, (int)length, 0);
+        header.sourceLength = (uint32_t)length;
+        header.dataLength = 0;
+        std::string cacheFile = getCodeCacheFile(_codeCachePath, sourceUrl);
+
+        v8::MaybeLocal<v8::Script> maybeScript;
+        const char* cacheState = nullptr;
+        std::vector<uint8_t> content = _fileOperationDelegate.onReadCodeCache(cacheFile);
+        if (checkCodeCache(content, header))
+        {
+            // Source owns the CachedData, content still owns the buffer
+            v8::ScriptCompiler::Source cachedSource(source, origin, new v8::ScriptCompiler::CachedData(content.data() + sizeof(CodeCacheHeader), (int)(content.size() - sizeof(CodeCacheHeader))));
+            maybeScript = v8::ScriptCompiler::Compile(_context.Get(_isolate), &cachedSource, v8::ScriptCompiler::kConsumeCodeCache);
+            if (cachedSource.GetCachedData()->rejected)
+            {
+                // V8 compiled the source instead, drop the cache so the next launch makes a new one
+                _fileOperationDelegate.onWriteCodeCache(cacheFile, std::vector<uint8_t>());
+                cacheState = "rejected";
+            }
+            else
+            {
+                cacheState = "hit";
+            }
+        }
+        else
+        {
+            v8::ScriptCompiler::Source newSource(source, origin);
+            maybeScript = v8::ScriptCompiler::Compile(_context.Get(_isolate), &newSource, v8::ScriptCompiler::kProduceCodeCache);
+            const v8::ScriptCompiler::CachedData* cachedData = newSource.GetCachedData();
+            if (!maybeScript.IsEmpty() && cachedData != nullptr && cachedData->length > 0)
+            {
+                // Replaces the cache of the script's previous version, if any
+                header.dataLength = (uint32_t)cachedData->length;
+                std::vector<uint8_t> newContent(sizeof(header) + cachedData->length);
+                memcpy(newContent.data(), &header, sizeof(header));
+                memcpy(newContent.data() + sizeof(header), cachedData->data, cachedData->length);
+                _fileOperationDelegate.onWriteCodeCache(cacheFile, std::move(newContent));
+            }
+            cacheState = "miss";
+        }
+
+        auto micro = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - startTime);
+        SE_LOGD("Compiled %s (%u bytes) in %.2f ms, code cache %s\n", sourceUrl.c_str(), (uint32_t)length, micro.count() / 1000.0, cacheState);
+        return maybeScript;
+    }
+
+    void ScriptEngine::setCodeCachePath(const std::string& path)
+    {
+        _codeCachePath = path;
+    }
+
     void ScriptEngine::setFileOperationDelegate(const FileOperationDelegate& delegate)
     {
         _fileOperationDelegate = delegate;
@@ -170,6 +170,8 @@ namespace se {
             , onGetStringFromFile(nullptr)
             , onCheckFileExist(nullptr)
             , onGetFullPath(nullptr)
+            , onReadCodeCache(nullptr)
+            , onWriteCodeCache(nullptr)
             {}
 
             /**
@@ -189,6 +191,10 @@ namespace se {
             std::function<bool(const std::string&)> onCheckFileExist;
             // path, return full path
             std::function<std::string(const std::string&)> onGetFullPath;
+            // path, return the content of a code cache file, empty if it doesn't exist. Optional, the code cache is off without it
+            std::function<std::vector<uint8_t>(const std::string&)> onReadCodeCache;
+            // path, content, replaces a code cache file without waiting for the write, empty content removes it
+            std::function<void(const std::string&, std::vector<uint8_t>&&)> onWriteCodeCache;
         };
 
         /**
@@ -205,6 +211,12 @@ namespace se {
          */
         bool runScript(const std::string& path, Value* rval = nullptr);
 
+        /**
+         *  @brief Sets the directory where the compiled code of the scripts is cached, so the next launches don't compile them again.
+         *  @param[in] path A writable directory ending with a path separator, empty disables the code cache.
+         */
+        void setCodeCachePath(const std::string& path);
+
         /**
          *  @brief Tests whether script engine is doing garbage collection.
          *  @return true if it's in garbage collection, otherwise false.
@@ -286,6 +298,8 @@ namespace se {
         static void onOOMErrorCallback(const char* location, bool is_heap_oom);
         static void onMessageCallback(v8::Local<v8::Message> message, v8::Local<v8::Value> data);
 
+        v8::MaybeLocal<v8::Script> compileWithCodeCache(v8::Local<v8::String> source, const v8::ScriptOrigin& origin, const char* script, size_t length, const std::string& sourceUrl);
+
         std::chrono::steady_clock::time_point _startTime;
         std::vector<RegisterCallback> _registerCallbackArray;
         std::vector<std::function<void()>> _beforeInitHookArray;
@@ -303,6 +317,7 @@ namespace se {
         Object* _globalObj;
 
         FileOperationDelegate _fileOperationDelegate;
+        std::string _codeCachePath;
         ExceptionCallback _exceptionCallback;
 
 #if SE_ENABLE_INSPECTOR
@@ -283,6 +283,70 @@ static bool JSB_localStorageClear(se::State& s)
 }
 SE_BIND_FUNC(JSB_localStorageClear)
 
+static bool JSB_localStorageBeginBatch(se::State& s)
+{
+    const auto& args = s.args();
+    size_t argc = args.size();
+    if (argc == 0)
+    {
+        localStorageBeginBatch();
+        return true;
+    }
+
+    SE_REPORT_ERROR("Invalid number of arguments");
+    return false;
+}
+SE_BIND_FUNC(JSB_localStorageBeginBatch)
+
+static bool JSB_localStorageEndBatch(se::State& s)
+{
+    const auto& args = s.args();
+    size_t argc = args.size();
+    if (argc == 0)
+    {
+        localStorageEndBatch();
+        return true;
+    }
+
+    SE_REPORT_ERROR("Invalid number of arguments");
+    return false;
+}
+SE_BIND_FUNC(JSB_localStorageEndBatch)
+
+static bool JSB_localStorageSetAsyncFlush(se::State& s)
+{
+    const auto& args = s.args();
+    size_t argc = args.size();
+    if (argc == 1)
+    {
+        bool ok = true;
+        bool enabled = false;
+        ok = seval_to_boolean(args[0], &enabled);
+        SE_PRECONDITION2(ok, false, "Error processing arguments");
+        localStorageSetAsyncFlush(enabled);
+        return true;
+    }
+
+    SE_REPORT_ERROR("Invalid number of arguments");
+    return false;
+}
+SE_BIND_FUNC(JSB_localStorageSetAsyncFlush)
+
+static bool JSB_localStorageFlush(se::State& s)
+{
+    const auto& args = s.args();
+    size_t argc = args.size();
+    if (argc == 0)
+    {
+        localStorageFlush();
+        return true;
+    }
+
+    SE_REPORT_ERROR("Invalid number of arguments");
+    return false;
+}
+SE_BIND_FUNC(JSB_localStorageFlush)
+
 
 static bool register_sys_localStorage(se::Object* obj)
 {
@@ -301,6 +365,10 @@ static bool register_sys_localStorage(se::Object* obj)
     localStorageObj->defineFunction("removeItem", _SE(JSB_localStorageRemoveItem));
     localStorageObj->defineFunction("setItem", _SE(JSB_localStorageSetItem));
     localStorageObj->defineFunction("clear", _SE(JSB_localStorageClear));
+    localStorageObj->defineFunction("beginBatch", _SE(JSB_localStorageBeginBatch));
+    localStorageObj->defineFunction("endBatch", _SE(JSB_localStorageEndBatch));
+    localStorageObj->defineFunction("setAsyncFlush", _SE(JSB_localStorageSetAsyncFlush));
+    localStorageObj->defineFunction("flush", _SE(JSB_localStorageFlush));
 
     std::string strFilePath = cocos2d::FileUtils::getInstance()->getWritablePath();
     strFilePath += "/jsb.sqlite";
@@ -701,10 +701,21 @@ bool seval_to_std_vector_float(const se::Value& v, std::vector<float>* ret)
     assert(ret != nullptr);
     assert(v.isObject());
     se::Object* obj = v.toObject();
+    // A Float32Array is copied at once
+    if (obj->isTypedArray() && obj->getTypedArrayType() == se::Object::TypedArrayType::FLOAT32)
+    {
+        uint8_t* data = nullptr;
+        size_t length = 0;
+        obj->getTypedArrayData(&data, &length);
+        const float* values = (const float*)data;
+        ret->assign(values, values + length / sizeof(float));
+        return true;
+    }
     assert(obj->isArray());
     uint32_t len = 0;
     if (obj->getArrayLength(&len))
     {
+        ret->reserve(len);
         se::Value value;
         for (uint32_t i = 0; i < len; ++i)
         {
@@ -724,10 +735,26 @@ bool seval_to_std_vector_Vec2(const se::Value& v, std::vector<cocos2d::Vec2>* re
     assert(ret != nullptr);
     assert(v.isObject());
     se::Object* obj = v.toObject();
+    // A Float32Array holds the x, y pairs
+    if (obj->isTypedArray() && obj->getTypedArrayType() == se::Object::TypedArrayType::FLOAT32)
+    {
+        uint8_t* data = nullptr;
+        size_t length = 0;
+        obj->getTypedArrayData(&data, &length);
+        const float* values = (const float*)data;
+        size_t count = length / (2 * sizeof(float));
+        ret->resize(count);
+        for (size_t i = 0; i < count; ++i)
+        {
+            (*ret)[i].set(values[i * 2], values[i * 2 + 1]);
+        }
+        return true;
+    }
     assert(obj->isArray());
     uint32_t len = 0;
     if (obj->getArrayLength(&len))
     {
+        ret->reserve(len);
         se::Value value;
         cocos2d::Vec2 pt;
         for (uint32_t i = 0; i < len; ++i)
@@ -1090,7 +1117,7 @@ bool seval_to_Data(const se::Value& v, cocos2d::Data* ret)
 
 bool seval_to_DownloaderHints(const se::Value& v, cocos2d::network::DownloaderHints* ret)
 {
-    static cocos2d::network::DownloaderHints ZERO = {0, 0, ""};
+    static cocos2d::network::DownloaderHints ZERO = {0, 0, "", false, 0, 0};
     assert(ret != nullptr);
     assert(v.isObject());
     se::Value tmp;
@@ -1109,6 +1136,23 @@ bool seval_to_DownloaderHints(const se::Value& v, cocos2d::network::DownloaderHi
     SE_PRECONDITION3(ok && tmp.isString(), false, *ret = ZERO);
     ret->tempFileNameSuffix = tmp.toString();
 
+    // optional
+    ret->adaptiveConcurrency = false;
+    if (obj->getProperty("adaptiveConcurrency", &tmp) && tmp.isBoolean())
+    {
+        ret->adaptiveConcurrency = tmp.toBoolean();
+    }
+    ret->countOfSegments = 0;
+    if (obj->getProperty("countOfSegments", &tmp) && tmp.isNumber())
+    {
+        ret->countOfSegments = tmp.toUint32();
+    }
+    ret->segmentThreshold = 0;
+    if (obj->getProperty("segmentThreshold", &tmp) && tmp.isNumber())
+    {
+        ret->segmentThreshold = (int64_t)tmp.toNumber();
+    }
+
     return ok;
 }
 
@@ -5,6 +5,7 @@
 #include "jsb_global.h"
 #include "jsb_conversions.hpp"
 #include "xxtea/xxtea.h"
+#include "base/Async.h"
 
 using namespace cocos2d;
 
@@ -138,9 +139,64 @@ void jsb_init_file_operation_delegate()
             return FileUtils::getInstance()->isFileExist(path);
         };
 
+#if SCRIPT_ENGINE_TYPE == SCRIPT_ENGINE_V8
+        delegate.onReadCodeCache = [](const std::string& path) -> std::vector<uint8_t>{
+            std::vector<uint8_t> content;
+            FILE* fp = fopen(FileUtils::getInstance()->getSuitableFOpen(path).c_str(), "rb");
+            if (fp == nullptr)
+                return content;
+
+            fseek(fp, 0, SEEK_END);
+            long size = ftell(fp);
+            fseek(fp, 0, SEEK_SET);
+            if (size > 0)
+            {
+                content.resize(size);
+                if (fread(content.data(), 1, size, fp) != (size_t)size)
+                    content.clear();
+            }
+            fclose(fp);
+            return content;
+        };
+
+        // Written on the FileIO thread so the startup doesn't wait for it, through a temporary file so an interrupted write is never read back
+        delegate.onWriteCodeCache = [](const std::string& path, std::vector<uint8_t>&& content) -> void{
+            std::string file = FileUtils::getInstance()->getSuitableFOpen(path);
+            auto buffer = std::make_shared<std::vector<uint8_t>>(std::move(content));
+            SharedAsyncThread.FileIO.run([file, buffer]() {
+                if (buffer->empty())
+                {
+                    remove(file.c_str());
+                    return;
+                }
+
+                std::string tempFile = file + ".tmp";
+                FILE* fp = fopen(tempFile.c_str(), "wb");
+                if (fp == nullptr)
+                    return;
+
+                bool ok = fwrite(buffer->data(), 1, buffer->size(), fp) == buffer->size();
+                ok = fclose(fp) == 0 && ok;
+                remove(file.c_str());
+                if (!ok || rename(tempFile.c_str(), file.c_str()) != 0)
+                {
+                    remove(tempFile.c_str());
+                }
+            });
+        };
+#endif
+
         assert(delegate.isValid());
 
         se::ScriptEngine::getInstance()->setFileOperationDelegate(delegate);
+
+#if SCRIPT_ENGINE_TYPE == SCRIPT_ENGINE_V8
+        std::string codeCachePath = FileUtils::getInstance()->getWritablePath() + "jsb-code-cache/";
+        if (FileUtils::getInstance()->isDirectoryExist(codeCachePath) || FileUtils::getInstance()->createDirectory(codeCachePath))
+        {
+            se::ScriptEngine::getInstance()->setCodeCachePath(codeCachePath);
+        }
+#endif
     }
 }
 
@@ -1499,6 +1499,233 @@ static bool onReceiveNodeEvent(void* node, ScriptingCore::NodeEventType type)
     return ret;
 }
 
+// Transform sync: instead of calling setPosition, setRotation, setScale or setOpacity through the bindings,
+// JS attaches nodes to slots of jsb.transformSync.buffer, writes their transforms there and marks them dirty.
+// The dirty slots are applied in one pass after the scheduler update, before the scene is visited.
+// A slot is TRANSFORM_SYNC_STRIDE floats: dirty flags, x, y, rotation, scaleX, scaleY, opacity and one unused.
+// An attached node is retained until it is detached.
+
+static const uint32_t TRANSFORM_SYNC_STRIDE = 8;
+static const uint32_t TRANSFORM_SYNC_INITIAL_SLOTS = 256;
+
+enum TransformSyncField
+{
+    TRANSFORM_SYNC_FLAGS = 0,
+    TRANSFORM_SYNC_X,
+    TRANSFORM_SYNC_Y,
+    TRANSFORM_SYNC_ROTATION,
+    TRANSFORM_SYNC_SCALE_X,
+    TRANSFORM_SYNC_SCALE_Y,
+    TRANSFORM_SYNC_OPACITY
+};
+
+enum TransformSyncDirty
+{
+    TRANSFORM_SYNC_DIRTY_POSITION = 1 << 0,
+    TRANSFORM_SYNC_DIRTY_ROTATION = 1 << 1,
+    TRANSFORM_SYNC_DIRTY_SCALE = 1 << 2,
+    TRANSFORM_SYNC_DIRTY_OPACITY = 1 << 3
+};
+
+static se::Object* __transformSyncObj = nullptr;
+static se::Object* __transformSyncBuffer = nullptr;
+static uint32_t __transformSyncCapacity = 0;
+static std::vector<Node*> __transformSyncNodes;
+static std::vector<uint32_t> __transformSyncFreeSlots;
+static EventListenerCustom* __transformSyncListener = nullptr;
+
+static float* getTransformSyncData()
+{
+    uint8_t* data = nullptr;
+    size_t length = 0;
+    __transformSyncBuffer->getTypedArrayData(&data, &length);
+    return (float*)data;
+}
+
+// The buffer is replaced when it grows, JS reads jsb.transformSync.buffer again after attaching
+static void resizeTransformSyncBuffer(uint32_t capacity)
+{
+    std::vector<float> data(capacity * TRANSFORM_SYNC_STRIDE, 0.0f);
+    if (__transformSyncBuffer != nullptr)
+    {
+        memcpy(data.data(), getTransformSyncData(), __transformSyncCapacity * TRANSFORM_SYNC_STRIDE * sizeof(float));
+        __transformSyncBuffer->unroot();
+        __transformSyncBuffer->decRef();
+    }
+
+    __transformSyncBuffer = se::Object::createTypedArray(se::Object::TypedArrayType::FLOAT32, data.data(), data.size() * sizeof(float));
+    __transformSyncBuffer->root();
+    __transformSyncCapacity = capacity;
+    __transformSyncObj->setProperty("buffer", se::Value(__transformSyncBuffer));
+}
+
+static void applyTransformSync()
+{
+    if (__transformSyncBuffer == nullptr)
+        return;
+
+    float* data = getTransformSyncData();
+    for (size_t slot = 0, count = __transformSyncNodes.size(); slot < count; ++slot)
+    {
+        float* entry = data + slot * TRANSFORM_SYNC_STRIDE;
+        // written by JS, NaN, negative and out of range flags are ignored rather than converted
+        float flags = entry[TRANSFORM_SYNC_FLAGS];
+        uint32_t dirty = (flags >= 1.0f && flags < 256.0f) ? (uint32_t)flags : 0;
+        Node* node = __transformSyncNodes[slot];
+        if (dirty == 0 || node == nullptr)
+            continue;
+
+        entry[TRANSFORM_SYNC_FLAGS] = 0;
+        if (dirty & TRANSFORM_SYNC_DIRTY_POSITION)
+            node->setPosition(entry[TRANSFORM_SYNC_X], entry[TRANSFORM_SYNC_Y]);
+        if (dirty & TRANSFORM_SYNC_DIRTY_ROTATION)
+            node->setRotation(entry[TRANSFORM_SYNC_ROTATION]);
+        if (dirty & TRANSFORM_SYNC_DIRTY_SCALE)
+            node->setScale(entry[TRANSFORM_SYNC_SCALE_X], entry[TRANSFORM_SYNC_SCALE_Y]);
+        if (dirty & TRANSFORM_SYNC_DIRTY_OPACITY)
+            node->setOpacity((uint8_t)clampf(entry[TRANSFORM_SYNC_OPACITY], 0.0f, 255.0f));
+    }
+}
+
+static void cleanupTransformSync()
+{
+    if (__transformSyncListener != nullptr)
+    {
+        SharedDirector.getEventDispatcher()->removeEventListener(__transformSyncListener);
+        __transformSyncListener = nullptr;
+    }
+
+    for (auto node : __transformSyncNodes)
+    {
+        CC_SAFE_RELEASE(node);
+    }
+    __transformSyncNodes.clear();
+    __transformSyncFreeSlots.clear();
+
+    if (__transformSyncBuffer != nullptr)
+    {
+        __transformSyncBuffer->unroot();
+        __transformSyncBuffer->decRef();
+        __transformSyncBuffer = nullptr;
+    }
+    __transformSyncCapacity = 0;
+
+    if (__transformSyncObj != nullptr)
+    {
+        __transformSyncObj->decRef();
+        __transformSyncObj = nullptr;
+    }
+}
+
+static bool js_transformSync_attach(se::State& s)
+{
+    const auto& args = s.args();
+    int argc = (int)args.size();
+    if (argc == 1)
+    {
+        Node* node = nullptr;
+        bool ok = seval_to_native_ptr(args[0], &node);
+        SE_PRECONDITION2(ok && node != nullptr, false, "js_transformSync_attach : Error processing arguments");
+
+        if (__transformSyncListener == nullptr)
+        {
+            __transformSyncListener = SharedDirector.getEventDispatcher()->addCustomEventListener(Director::EVENT_AFTER_UPDATE, [](EventCustom*){
+                applyTransformSync();
+            });
+        }
+
+        uint32_t slot = 0;
+        if (!__transformSyncFreeSlots.empty())
+        {
+            slot = __transformSyncFreeSlots.back();
+            __transformSyncFreeSlots.pop_back();
+        }
+        else
+        {
+            slot = (uint32_t)__transformSyncNodes.size();
+            __transformSyncNodes.push_back(nullptr);
+            if (slot >= __transformSyncCapacity)
+                resizeTransformSyncBuffer(__transformSyncCapacity == 0 ? TRANSFORM_SYNC_INITIAL_SLOTS : __transformSyncCapacity * 2);
+        }
+
+        node->retain();
+        __transformSyncNodes[slot] = node;
+
+        // Starts from the current transform, so JS may write only some of it
+        float* entry = getTransformSyncData() + slot * TRANSFORM_SYNC_STRIDE;
+        entry[TRANSFORM_SYNC_FLAGS] = 0;
+        entry[TRANSFORM_SYNC_X] = node->getPositionX();
+        entry[TRANSFORM_SYNC_Y] = node->getPositionY();
+        entry[TRANSFORM_SYNC_ROTATION] = node->getRotation();
+        entry[TRANSFORM_SYNC_SCALE_X] = node->getScaleX();
+        entry[TRANSFORM_SYNC_SCALE_Y] = node->getScaleY();
+        entry[TRANSFORM_SYNC_OPACITY] = node->getOpacity();
+
+        s.rval().setUint32(slot);
+        return true;
+    }
+
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", argc, 1);
+    return false;
+}
+SE_BIND_FUNC(js_transformSync_attach)
+
+static bool js_transformSync_detach(se::State& s)
+{
+    const auto& args = s.args();
+    int argc = (int)args.size();
+    if (argc == 1)
+    {
+        uint32_t slot = 0;
+        bool ok = seval_to_uint32(args[0], &slot);
+        SE_PRECONDITION2(ok && slot < __transformSyncNodes.size() && __transformSyncNodes[slot] != nullptr, false, "js_transformSync_detach : Invalid slot");
+
+        __transformSyncNodes[slot]->release();
+        __transformSyncNodes[slot] = nullptr;
+        getTransformSyncData()[slot * TRANSFORM_SYNC_STRIDE + TRANSFORM_SYNC_FLAGS] = 0;
+        __transformSyncFreeSlots.push_back(slot);
+        return true;
+    }
+
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", argc, 1);
+    return false;
+}
+SE_BIND_FUNC(js_transformSync_detach)
+
+static bool js_transformSync_apply(se::State& s)
+{
+    applyTransformSync();
+    return true;
+}
+SE_BIND_FUNC(js_transformSync_apply)
+
+static void registerTransformSync()
+{
+    cleanupTransformSync();
+
+    __transformSyncObj = se::Object::createPlainObject();
+    __jsbObj->setProperty("transformSync", se::Value(__transformSyncObj));
+    __transformSyncObj->defineFunction("attach", _SE(js_transformSync_attach));
+    __transformSyncObj->defineFunction("detach", _SE(js_transformSync_detach));
+    __transformSyncObj->defineFunction("apply", _SE(js_transformSync_apply));
+    __transformSyncObj->setProperty("STRIDE", se::Value(TRANSFORM_SYNC_STRIDE));
+    __transformSyncObj->setProperty("FLAGS", se::Value((uint32_t)TRANSFORM_SYNC_FLAGS));
+    __transformSyncObj->setProperty("X", se::Value((uint32_t)TRANSFORM_SYNC_X));
+    __transformSyncObj->setProperty("Y", se::Value((uint32_t)TRANSFORM_SYNC_Y));
+    __transformSyncObj->setProperty("ROTATION", se::Value((uint32_t)TRANSFORM_SYNC_ROTATION));
+    __transformSyncObj->setProperty("SCALE_X", se::Value((uint32_t)TRANSFORM_SYNC_SCALE_X));
+    __transformSyncObj->setProperty("SCALE_Y", se::Value((uint32_t)TRANSFORM_SYNC_SCALE_Y));
+    __transformSyncObj->setProperty("OPACITY", se::Value((uint32_t)TRANSFORM_SYNC_OPACITY));
+    __transformSyncObj->setProperty("DIRTY_POSITION", se::Value((uint32_t)TRANSFORM_SYNC_DIRTY_POSITION));
+    __transformSyncObj->setProperty("DIRTY_ROTATION", se::Value((uint32_t)TRANSFORM_SYNC_DIRTY_ROTATION));
+    __transformSyncObj->setProperty("DIRTY_SCALE", se::Value((uint32_t)TRANSFORM_SYNC_DIRTY_SCALE));
+    __transformSyncObj->setProperty("DIRTY_OPACITY", se::Value((uint32_t)TRANSFORM_SYNC_DIRTY_OPACITY));
+
+    se::ScriptEngine::getInstance()->addBeforeCleanupHook([](){
+        cleanupTransformSync();
+    });
+}
+
 bool jsb_register_Node_manual(se::Object* global)
 {
 #if STANDALONE_TEST
@@ -1559,6 +1786,8 @@ bool jsb_register_Node_manual(se::Object* global)
     __jsb_Node_proto->setProperty("var2", se::Value(10000.323));
 #endif
 
+    registerTransformSync();
+
     ScriptingCore::getInstance()->setNodeEventListener(onReceiveNodeEvent);
     se::ScriptEngine::getInstance()->clearException();
 
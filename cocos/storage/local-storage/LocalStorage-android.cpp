@@ -36,12 +36,24 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <assert.h>
+#include <unordered_map>
 #include "jni.h"
 #include "platform/android/jni/JniHelper.h"
 
 USING_NS_CC;
 static int _initialized = 0;
 
+// Read-through cache of the table, entries of missing keys included, saves a JNI call per read
+struct CacheEntry
+{
+    bool exists;
+    std::string value;
+};
+static std::unordered_map<std::string, CacheEntry> _cache;
+// after a clear the cache holds every key, misses need no query
+static bool _cacheComplete = false;
+static int _batchDepth = 0;
+
 static std::string className = "org/cocos2dx/lib/Cocos2dxLocalStorage";
 
 static void splitFilename (std::string& str)
@@ -72,7 +84,14 @@ void localStorageInit( const std::string& fullpath)
 void localStorageFree()
 {
     if (_initialized) {
+        if (_batchDepth > 0)
+        {
+            _batchDepth = 1;
+            localStorageEndBatch();
+        }
         JniHelper::callStaticVoidMethod(className, "destroy");
+        _cache.clear();
+        _cacheComplete = false;
         _initialized = 0;
     }
 }
@@ -81,6 +100,9 @@ void localStorageFree()
 void localStorageSetItem( const std::string& key, const std::string& value)
 {
     assert( _initialized );
+    CacheEntry& entry = _cache[key];
+    entry.exists = true;
+    entry.value = value;
     JniHelper::callStaticVoidMethod(className, "setItem", key, value);
 }
 
@@ -88,6 +110,16 @@ void localStorageSetItem( const std::string& key, const std::string& value)
 bool localStorageGetItem( const std::string& key, std::string *outItem )
 {
     assert( _initialized );
+
+    auto it = _cache.find(key);
+    if (it != _cache.end() || _cacheComplete)
+    {
+        if (it == _cache.end() || !it->second.exists)
+            return false;
+        outItem->assign(it->second.value);
+        return true;
+    }
+
     JniMethodInfo t;
 
     if (JniHelper::getStaticMethodInfo(t, "org/cocos2dx/lib/Cocos2dxLocalStorage", "getItem", "(Ljava/lang/String;)Ljava/lang/String;"))
@@ -99,11 +131,15 @@ bool localStorageGetItem( const std::string& key, std::string *outItem )
             t.env->DeleteLocalRef(jret);
             t.env->DeleteLocalRef(jkey);
             t.env->DeleteLocalRef(t.classID);
+            _cache[key].exists = false;
             return false;
         }
         else
         {
             outItem->assign(JniHelper::jstring2string(jret));
+            CacheEntry& entry = _cache[key];
+            entry.exists = true;
+            entry.value = *outItem;
             t.env->DeleteLocalRef(jret);
             t.env->DeleteLocalRef(jkey);
             t.env->DeleteLocalRef(t.classID);
@@ -120,6 +156,9 @@ bool localStorageGetItem( const std::string& key, std::string *outItem )
 void localStorageRemoveItem( const std::string& key )
 {
     assert( _initialized );
+    CacheEntry& entry = _cache[key];
+    entry.exists = false;
+    entry.value.clear();
     JniHelper::callStaticVoidMethod(className, "removeItem", key);
 }
 
@@ -127,7 +166,32 @@ void localStorageRemoveItem( const std::string& key )
 void localStorageClear()
 {
     assert( _initialized );
+    _cache.clear();
+    _cacheComplete = true;
     JniHelper::callStaticVoidMethod(className, "clear");
 }
 
+void localStorageBeginBatch()
+{
+    assert( _initialized );
+    if (_batchDepth++ == 0)
+        JniHelper::callStaticVoidMethod(className, "beginBatch");
+}
+
+void localStorageEndBatch()
+{
+    assert( _initialized );
+    if (_batchDepth > 0 && --_batchDepth == 0)
+        JniHelper::callStaticVoidMethod(className, "endBatch");
+}
+
+/** the Java database commits on the calling thread */
+void localStorageSetAsyncFlush(bool enabled)
+{
+}
+
+void localStorageFlush()
+{
+}
+
 #endif // #if (CC_TARGET_PLATFORM == CC_PLATFORM_ANDROID)
@@ -35,6 +35,13 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <assert.h>
+#include <string>
+#include <vector>
+#include <iterator>
+#include <unordered_map>
+#include <mutex>
+#include <thread>
+#include <condition_variable>
 #if (CC_TARGET_PLATFORM == CC_PLATFORM_WIN32)
 #include <sqlite3/sqlite3.h>
 #else
@@ -48,6 +55,47 @@ static sqlite3_stmt *_stmt_remove;
 static sqlite3_stmt *_stmt_update;
 static sqlite3_stmt *_stmt_clear;
 
+static std::string _path;
+
+// Read-through cache of the table, entries of missing keys included
+struct CacheEntry
+{
+    bool exists;
+    std::string value;
+};
+static std::unordered_map<std::string, CacheEntry> _cache;
+// after a clear the cache holds every key, misses need no query
+static bool _cacheComplete = false;
+
+enum class OpType
+{
+    SET,
+    REMOVE,
+    CLEAR
+};
+struct Op
+{
+    OpType type;
+    std::string key;
+    std::string value;
+};
+
+static int _batchDepth = 0;
+// with the background flush, the changes of the open batch, handed to the thread when it ends
+static std::vector<Op> _batchOps;
+
+// Background flush: the changes are written on a thread, through its own connection
+static bool _asyncFlush = false;
+static std::thread _flushThread;
+static std::mutex _flushMutex;
+static std::condition_variable _flushCondition;
+static std::condition_variable _flushedCondition;
+static std::vector<Op> _pendingOps;
+static unsigned long long _queuedCount = 0;
+static unsigned long long _flushedCount = 0;
+static bool _flushThreadExit = false;
+
+#define BUSY_TIMEOUT_MS 1000
 
 static void localStorageCreateTable()
 {
@@ -61,6 +109,127 @@ static void localStorageCreateTable()
         printf("Error in CREATE TABLE\n");
 }
 
+static int localStoragePrepareWrites(sqlite3 *db, sqlite3_stmt **update, sqlite3_stmt **remove, sqlite3_stmt **clear)
+{
+    // REPLACE
+    const char *sql_update = "REPLACE INTO data (key, value) VALUES (?,?);";
+    int ret = sqlite3_prepare_v2(db, sql_update, -1, update, nullptr);
+
+    // DELETE
+    const char *sql_remove = "DELETE FROM data WHERE key=?;";
+    ret |= sqlite3_prepare_v2(db, sql_remove, -1, remove, nullptr);
+
+    // Clear
+    const char *sql_clear = "DELETE FROM data;";
+    ret |= sqlite3_prepare_v2(db, sql_clear, -1, clear, nullptr);
+    return ret;
+}
+
+static void localStorageExecute(sqlite3_stmt *update, sqlite3_stmt *remove, sqlite3_stmt *clear, const Op& op)
+{
+    int ok = SQLITE_OK;
+    switch (op.type)
+    {
+        case OpType::SET:
+            ok |= sqlite3_bind_text(update, 1, op.key.c_str(), (int)op.key.size(), SQLITE_STATIC);
+            ok |= sqlite3_bind_text(update, 2, op.value.c_str(), (int)op.value.size(), SQLITE_STATIC);
+            ok |= sqlite3_step(update);
+            ok |= sqlite3_reset(update);
+            if( ok != SQLITE_OK && ok != SQLITE_DONE)
+                printf("Error in localStorage.setItem()\n");
+            break;
+        case OpType::REMOVE:
+            ok |= sqlite3_bind_text(remove, 1, op.key.c_str(), (int)op.key.size(), SQLITE_STATIC);
+            ok |= sqlite3_step(remove);
+            ok |= sqlite3_reset(remove);
+            if( ok != SQLITE_OK && ok != SQLITE_DONE)
+                printf("Error in localStorage.removeItem()\n");
+            break;
+        case OpType::CLEAR:
+            ok |= sqlite3_step(clear);
+            ok |= sqlite3_reset(clear);
+            if( ok != SQLITE_OK && ok != SQLITE_DONE)
+                printf("Error in localStorage.clear()\n");
+            break;
+    }
+}
+
+static void localStorageFlushThread(sqlite3 *db)
+{
+    sqlite3_stmt *update = nullptr;
+    sqlite3_stmt *remove = nullptr;
+    sqlite3_stmt *clear = nullptr;
+    if (localStoragePrepareWrites(db, &update, &remove, &clear) != SQLITE_OK)
+        printf("Error initializing localStorage flush thread\n");
+
+    std::vector<Op> ops;
+    std::unique_lock<std::mutex> lock(_flushMutex);
+    while (true)
+    {
+        _flushCondition.wait(lock, [] { return _flushThreadExit || !_pendingOps.empty(); });
+        if (_pendingOps.empty())
+            break;
+
+        ops.swap(_pendingOps);
+        lock.unlock();
+
+        // everything queued since the last flush goes in one transaction
+        sqlite3_exec(db, "BEGIN;", nullptr, nullptr, nullptr);
+        for (const auto& op : ops)
+            localStorageExecute(update, remove, clear, op);
+        if (sqlite3_exec(db, "COMMIT;", nullptr, nullptr, nullptr) != SQLITE_OK)
+            printf("Error committing localStorage: %s\n", sqlite3_errmsg(db));
+
+        lock.lock();
+        _flushedCount += ops.size();
+        ops.clear();
+        _flushedCondition.notify_all();
+    }
+
+    sqlite3_finalize(update);
+    sqlite3_finalize(remove);
+    sqlite3_finalize(clear);
+    sqlite3_close(db);
+}
+
+static void localStorageStopFlushThread()
+{
+    if (!_flushThread.joinable())
+        return;
+
+    {
+        std::lock_guard<std::mutex> lock(_flushMutex);
+        _flushThreadExit = true;
+    }
+    _flushCondition.notify_one();
+    // the thread empties the queue before it exits
+    _flushThread.join();
+    _flushThreadExit = false;
+}
+
+static void localStorageQueue(Op&& op)
+{
+    if (_batchDepth > 0)
+    {
+        _batchOps.push_back(std::move(op));
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(_flushMutex);
+        _pendingOps.push_back(std::move(op));
+        ++_queuedCount;
+    }
+    _flushCondition.notify_one();
+}
+
+static void localStorageWrite(Op&& op)
+{
+    if (_asyncFlush)
+        localStorageQueue(std::move(op));
+    else
+        localStorageExecute(_stmt_update, _stmt_remove, _stmt_clear, op);
+}
+
 void localStorageInit( const std::string& fullpath/* = "" */)
 {
     if (!_initialized) {
@@ -70,31 +239,30 @@ void localStorageInit( const std::string& fullpath/* = "" */)
         if (fullpath.empty())
             ret = sqlite3_open(":memory:", &_db);
         else
+        {
             ret = sqlite3_open(fullpath.c_str(), &_db);
 
+            // readers and the writer don't block each other, and a commit needs no fsync of its own
+            sqlite3_exec(_db, "PRAGMA journal_mode=WAL;", nullptr, nullptr, nullptr);
+            sqlite3_exec(_db, "PRAGMA synchronous=NORMAL;", nullptr, nullptr, nullptr);
+            sqlite3_busy_timeout(_db, BUSY_TIMEOUT_MS);
+        }
+        _path = fullpath;
+
         localStorageCreateTable();
 
         // SELECT
         const char *sql_select = "SELECT value FROM data WHERE key=?;";
         ret |= sqlite3_prepare_v2(_db, sql_select, -1, &_stmt_select, nullptr);
 
-        // REPLACE
-        const char *sql_update = "REPLACE INTO data (key, value) VALUES (?,?);";
-        ret |= sqlite3_prepare_v2(_db, sql_update, -1, &_stmt_update, nullptr);
-
-        // DELETE
-        const char *sql_remove = "DELETE FROM data WHERE key=?;";
-        ret |= sqlite3_prepare_v2(_db, sql_remove, -1, &_stmt_remove, nullptr);
-        
-        // Clear
-        const char *sql_clear = "DELETE FROM data;";
-        ret |= sqlite3_prepare_v2(_db, sql_clear, -1, &_stmt_clear, nullptr);
+        // REPLACE, DELETE, Clear
+        ret |= localStoragePrepareWrites(_db, &_stmt_update, &_stmt_remove, &_stmt_clear);
 
         if( ret != SQLITE_OK ) {
             printf("Error initializing DB\n");
             // report error
         }
-		
+
         _initialized = 1;
     }
 }
@@ -102,12 +270,22 @@ void localStorageInit( const std::string& fullpath/* = "" */)
 void localStorageFree()
 {
     if (_initialized) {
+        if (_batchDepth > 0)
+        {
+            _batchDepth = 1;
+            localStorageEndBatch();
+        }
+        localStorageSetAsyncFlush(false);
+
         sqlite3_finalize(_stmt_select);
         sqlite3_finalize(_stmt_remove);
         sqlite3_finalize(_stmt_update);
+        sqlite3_finalize(_stmt_clear);
 
         sqlite3_close(_db);
-		
+
+        _cache.clear();
+        _cacheComplete = false;
         _initialized = 0;
     }
 }
@@ -116,16 +294,12 @@ void localStorageFree()
 void localStorageSetItem( const std::string& key, const std::string& value)
 {
     assert( _initialized );
-	
-    int ok = sqlite3_bind_text(_stmt_update, 1, key.c_str(), -1, SQLITE_TRANSIENT);
-    ok |= sqlite3_bind_text(_stmt_update, 2, value.c_str(), -1, SQLITE_TRANSIENT);
-
-    ok |= sqlite3_step(_stmt_update);
 
-    ok |= sqlite3_reset(_stmt_update);
+    CacheEntry& entry = _cache[key];
+    entry.exists = true;
+    entry.value = value;
 
-    if( ok != SQLITE_OK && ok != SQLITE_DONE)
-        printf("Error in localStorage.setItem()\n");
+    localStorageWrite(Op{OpType::SET, key, value});
 }
 
 /** gets an item from the LS */
@@ -133,26 +307,39 @@ bool localStorageGetItem( const std::string& key, std::string *outItem )
 {
     assert( _initialized );
 
+    auto it = _cache.find(key);
+    if (it != _cache.end() || _cacheComplete)
+    {
+        if (it == _cache.end() || !it->second.exists)
+            return false;
+        outItem->assign(it->second.value);
+        return true;
+    }
+
+    // the keys with changes not flushed yet are all cached, the database is up to date for this one
     int ok = sqlite3_reset(_stmt_select);
 
-    ok |= sqlite3_bind_text(_stmt_select, 1, key.c_str(), -1, SQLITE_TRANSIENT);
+    ok |= sqlite3_bind_text(_stmt_select, 1, key.c_str(), (int)key.size(), SQLITE_STATIC);
     ok |= sqlite3_step(_stmt_select);
     const unsigned char *text = sqlite3_column_text(_stmt_select, 0);
 
     if ( ok != SQLITE_OK && ok != SQLITE_DONE && ok != SQLITE_ROW )
     {
         printf("Error in localStorage.getItem()\n");
+        sqlite3_reset(_stmt_select);
         return false;
     }
-    else if (!text)
-    {
+
+    CacheEntry& entry = _cache[key];
+    entry.exists = text != nullptr;
+    if (text)
+        entry.value.assign((const char*)text, sqlite3_column_bytes(_stmt_select, 0));
+    sqlite3_reset(_stmt_select);
+
+    if (!entry.exists)
         return false;
-    }
-    else
-    {
-        outItem->assign((const char*)text);
-        return true;
-    }
+    outItem->assign(entry.value);
+    return true;
 }
 
 /** removes an item from the LS */
@@ -160,27 +347,112 @@ void localStorageRemoveItem( const std::string& key )
 {
     assert( _initialized );
 
-    int ok = sqlite3_bind_text(_stmt_remove, 1, key.c_str(), -1, SQLITE_TRANSIENT);
-
-    ok |= sqlite3_step(_stmt_remove);
-
-    ok |= sqlite3_reset(_stmt_remove);
+    CacheEntry& entry = _cache[key];
+    entry.exists = false;
+    entry.value.clear();
 
-    if( ok != SQLITE_OK && ok != SQLITE_DONE)
-        printf("Error in localStorage.removeItem()\n");
+    localStorageWrite(Op{OpType::REMOVE, key, std::string()});
 }
 
 /** removes all items from the LS */
 void localStorageClear()
 {
     assert( _initialized );
-    
-    int ok = sqlite3_step(_stmt_clear);
 
-    ok |= sqlite3_reset(_stmt_clear);
+    _cache.clear();
+    _cacheComplete = true;
 
-    if( ok != SQLITE_OK && ok != SQLITE_DONE)
-        printf("Error in localStorage.clear()\n");
+    localStorageWrite(Op{OpType::CLEAR, std::string(), std::string()});
+}
+
+void localStorageBeginBatch()
+{
+    assert( _initialized );
+
+    if (_batchDepth++ > 0 || _asyncFlush)
+        return;
+
+    if (sqlite3_exec(_db, "BEGIN;", nullptr, nullptr, nullptr) != SQLITE_OK)
+        printf("Error in localStorage.beginBatch(): %s\n", sqlite3_errmsg(_db));
+}
+
+void localStorageEndBatch()
+{
+    assert( _initialized );
+
+    if (_batchDepth == 0 || --_batchDepth > 0)
+        return;
+
+    if (_asyncFlush)
+    {
+        if (_batchOps.empty())
+            return;
+        {
+            std::lock_guard<std::mutex> lock(_flushMutex);
+            _queuedCount += _batchOps.size();
+            if (_pendingOps.empty())
+                _pendingOps.swap(_batchOps);
+            else
+            {
+                std::move(_batchOps.begin(), _batchOps.end(), std::back_inserter(_pendingOps));
+                _batchOps.clear();
+            }
+        }
+        _flushCondition.notify_one();
+        return;
+    }
+
+    if (sqlite3_exec(_db, "COMMIT;", nullptr, nullptr, nullptr) != SQLITE_OK)
+        printf("Error in localStorage.endBatch(): %s\n", sqlite3_errmsg(_db));
+}
+
+void localStorageSetAsyncFlush(bool enabled)
+{
+    assert( _initialized );
+
+    if (enabled == _asyncFlush)
+        return;
+    if (_batchDepth > 0)
+    {
+        printf("Error in localStorage.setAsyncFlush(): a batch is open\n");
+        return;
+    }
+
+    if (!enabled)
+    {
+        localStorageStopFlushThread();
+        _asyncFlush = false;
+        return;
+    }
+
+    // an in-memory database can't be shared with another connection
+    if (_path.empty())
+        return;
+
+    sqlite3 *db = nullptr;
+    if (sqlite3_open(_path.c_str(), &db) != SQLITE_OK)
+    {
+        printf("Error in localStorage.setAsyncFlush(): %s\n", sqlite3_errmsg(db));
+        sqlite3_close(db);
+        return;
+    }
+    sqlite3_exec(db, "PRAGMA synchronous=NORMAL;", nullptr, nullptr, nullptr);
+    sqlite3_busy_timeout(db, BUSY_TIMEOUT_MS);
+
+    _asyncFlush = true;
+    _flushThread = std::thread(localStorageFlushThread, db);
+}
+
+void localStorageFlush()
+{
+    assert( _initialized );
+
+    if (!_asyncFlush)
+        return;
+
+    std::unique_lock<std::mutex> lock(_flushMutex);
+    unsigned long long target = _queuedCount;
+    _flushedCondition.wait(lock, [target] { return _flushedCount >= target; });
 }
 
 #endif // #if (CC_TARGET_PLATFORM != CC_PLATFORM_ANDROID)
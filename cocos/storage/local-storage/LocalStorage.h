@@ -54,6 +54,19 @@ void CC_DLL localStorageRemoveItem( const std::string& key );
 /** Removes all items from the JS. */
 void CC_DLL localStorageClear();
 
+/** Groups the changes until the matching localStorageEndBatch into one transaction. Batches nest. */
+void CC_DLL localStorageBeginBatch();
+
+/** Commits the changes made since the matching localStorageBeginBatch. */
+void CC_DLL localStorageEndBatch();
+
+/** Writes the changes on a background thread, in one transaction per wake up. Reads are served from
+ * memory meanwhile. Not available for the in-memory DB, nor on Android. */
+void CC_DLL localStorageSetAsyncFlush(bool enabled);
+
+/** Blocks until every change made so far is committed to the DB. */
+void CC_DLL localStorageFlush();
+
 // end group
 /// @}
 
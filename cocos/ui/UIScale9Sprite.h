@@ -683,7 +683,7 @@ namespace ui {
         DrawNode *_debugDrawNode;
 #endif //CC_SPRITE_DEBUG_DRAW
         bool _insideBounds;   /// whether or not the sprite was inside bounds the previous frame
-        COCOS_TYPE_OVERRIDE(Scale9Sprite);
+        COCOS_TYPE_OVERRIDE(Scale9Sprite, Node);
     };
 
 }}  //end of namespace
@@ -841,7 +841,7 @@ protected:
 private:
     class FocusNavigationController;
     static FocusNavigationController* _focusNavigationController;
-    COCOS_TYPE_OVERRIDE(Widget);
+    COCOS_TYPE_OVERRIDE(Widget, ProtectedNode);
 };
 }
 
@@ -26,9 +26,16 @@
 #include "CCEventListenerAssetsManagerEx.h"
 #include "base/ccUTF8.h"
 #include "base/CCDirector.h"
+#include "base/ccUtils.h"
 #include "platform/CCApplication.h"
 
 #include <stdio.h>
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <unordered_set>
 
 #ifdef MINIZIP_FROM_SYSTEM
 #include <minizip/unzip.h>
@@ -36,6 +43,9 @@
 #include "unzip/unzip.h"
 #endif
 #include "base/CCAsyncTaskPool.h"
+#include "base/CCThreadPool.h"
+#include "xxhash/xxhash.h"
+#include <zlib.h>
 
 NS_CC_EXT_BEGIN
 
@@ -46,8 +56,20 @@ NS_CC_EXT_BEGIN
 
 #define BUFFER_SIZE    8192
 #define MAX_FILENAME   512
+#define HASH_BUFFER_SIZE 65536
+
+#define PATCH_SUFFIX    ".patch"
+#define PATCH_MAGIC     "CCDF"
+#define PATCH_VERSION   1
+#define PATCH_COPY      0
+#define PATCH_ADD       1
+
+#define MAX_DECOMPRESS_THREADS      4
+#define PARALLEL_DECOMPRESS_SIZE    (4 * 1024 * 1024)
 
 #define DEFAULT_CONNECTION_TIMEOUT 45
+#define SEGMENTS_PER_ASSET          4
+#define SEGMENT_THRESHOLD           (16 * 1024 * 1024)
 
 #define SAVE_POINT_INTERVAL 0.1f
 
@@ -125,7 +147,10 @@ void AssetsManagerEx::init(const std::string& manifestUrl, const std::string& st
     {
         static_cast<uint32_t>(_maxConcurrentTask),
         DEFAULT_CONNECTION_TIMEOUT,
-        ".tmp"
+        ".tmp",
+        true,
+        SEGMENTS_PER_ASSET,
+        SEGMENT_THRESHOLD
     };
     _downloader = std::shared_ptr<network::Downloader>(new network::Downloader(hints));
     _downloader->onTaskError = std::bind(&AssetsManagerEx::onError, this, std::placeholders::_1, std::placeholders::_2, std::placeholders::_3, std::placeholders::_4);
@@ -140,6 +165,19 @@ void AssetsManagerEx::init(const std::string& manifestUrl, const std::string& st
     {
         this->onSuccess(task.requestURL, task.storagePath, task.identifier);
     };
+    // Owned with the downloader thread, which may still write after this is destroyed
+    auto streamHashes = std::make_shared<StreamHashes>();
+    _streamHashes = streamHashes;
+    _downloader->onTaskDataProc = [streamHashes](const network::DownloadTask& task, const unsigned char* data, size_t size)
+    {
+        std::lock_guard<std::mutex> lock(streamHashes->mutex);
+        auto it = streamHashes->hashers.find(task.identifier);
+        if (it != streamHashes->hashers.end())
+        {
+            it->second.first->update(data, size);
+            it->second.second += size;
+        }
+    };
     setStoragePath(storagePath);
     _tempVersionPath = _tempStoragePath + VERSION_FILENAME;
     _cacheManifestPath = _storagePath + MANIFEST_FILENAME;
@@ -156,6 +194,7 @@ AssetsManagerEx::~AssetsManagerEx()
     _downloader->onTaskError = (nullptr);
     _downloader->onFileTaskSuccess = (nullptr);
     _downloader->onTaskProgress = (nullptr);
+    _downloader->onTaskDataProc = (nullptr);
     CC_SAFE_RELEASE(_localManifest);
     // _tempManifest could share a ptr with _remoteManifest or _localManifest
     if (_tempManifest != _localManifest && _tempManifest != _remoteManifest)
@@ -280,6 +319,7 @@ bool AssetsManagerEx::loadLocalManifest(Manifest* localManifest, const std::stri
             // Recreate storage, to empty the content
             _fileUtils->removeDirectory(_storagePath);
             _fileUtils->createDirectory(_storagePath);
+            _fileUtils->notifyFilesChanged(_storagePath);
             CC_SAFE_RELEASE(cachedManifest);
         }
         else
@@ -372,6 +412,7 @@ bool AssetsManagerEx::loadLocalManifest(const std::string& manifestUrl)
                 // Recreate storage, to empty the content
                 _fileUtils->removeDirectory(_storagePath);
                 _fileUtils->createDirectory(_storagePath);
+                _fileUtils->notifyFilesChanged(_storagePath);
                 CC_SAFE_RELEASE(cachedManifest);
             }
             else
@@ -484,6 +525,185 @@ void AssetsManagerEx::adjustPath(std::string &path)
     }
 }
 
+namespace {
+
+struct ZipEntry
+{
+    unz_file_pos pos;
+    std::string path;
+    uLong size;
+};
+
+// Extracts the batches of large archives besides the task decompressing them, shared by every manager.
+// Fixed size, so tasks can be pushed from the AsyncTaskPool thread.
+ThreadPool* getDecompressPool()
+{
+    static ThreadPool* pool = ThreadPool::newFixedThreadPool(MAX_DECOMPRESS_THREADS - 1);
+    return pool;
+}
+
+// Extracts entries with its own handle on the zip, each file is written next to its destination then renamed over it.
+bool extractZipEntries(FileUtils* fileUtils, const std::string& zip, const std::vector<const ZipEntry*>& entries, std::atomic<bool>& failed)
+{
+    unzFile zipfile = unzOpen(fileUtils->getSuitableFOpen(zip).c_str());
+    if (! zipfile)
+    {
+        CCLOG("AssetsManagerEx : can not open downloaded zip file %s\n", zip.c_str());
+        return false;
+    }
+
+    // Buffer to hold data read from the zip file
+    std::unique_ptr<char[]> readBuffer(new char[BUFFER_SIZE]);
+    bool ok = true;
+    for (auto entry : entries)
+    {
+        if (failed.load(std::memory_order_relaxed))
+        {
+            ok = false;
+            break;
+        }
+        unz_file_pos pos = entry->pos;
+        if (unzGoToFilePos(zipfile, &pos) != UNZ_OK || unzOpenCurrentFile(zipfile) != UNZ_OK)
+        {
+            CCLOG("AssetsManagerEx : can not extract file %s\n", entry->path.c_str());
+            ok = false;
+            break;
+        }
+
+        // Create a file to store current file.
+        const std::string tempPath = entry->path + ".tmp";
+        FILE *out = fopen(fileUtils->getSuitableFOpen(tempPath).c_str(), "wb");
+        if (!out)
+        {
+            CCLOG("AssetsManagerEx : can not create decompress destination file %s (errno: %d)\n", tempPath.c_str(), errno);
+            unzCloseCurrentFile(zipfile);
+            ok = false;
+            break;
+        }
+
+        // Write current file content to destinate file.
+        int error = UNZ_OK;
+        do
+        {
+            error = unzReadCurrentFile(zipfile, readBuffer.get(), BUFFER_SIZE);
+            if (error > 0 && fwrite(readBuffer.get(), error, 1, out) != 1)
+            {
+                CCLOG("AssetsManagerEx : can not write decompressed file %s\n", tempPath.c_str());
+                error = UNZ_ERRNO;
+            }
+        } while (error > 0);
+
+        bool written = fclose(out) == 0 && error == UNZ_OK;
+        // Reports a CRC mismatch once the whole entry was read
+        bool checked = unzCloseCurrentFile(zipfile) == UNZ_OK;
+        if (!written || !checked || !fileUtils->renameFile(tempPath, entry->path))
+        {
+            CCLOG("AssetsManagerEx : can not read zip file %s, error code is %d\n", entry->path.c_str(), error);
+            fileUtils->removeFile(tempPath);
+            ok = false;
+            break;
+        }
+    }
+
+    unzClose(zipfile);
+    return ok;
+}
+
+bool readPatch(gzFile patch, void* data, unsigned size)
+{
+    return gzread(patch, data, size) == (int)size;
+}
+
+bool readPatchInteger(gzFile patch, uint64_t* value, unsigned size)
+{
+    unsigned char bytes[8];
+    if (!readPatch(patch, bytes, size))
+    {
+        return false;
+    }
+    *value = 0;
+    for (unsigned i = size; i > 0; --i)
+    {
+        *value = (*value << 8) | bytes[i - 1];
+    }
+    return true;
+}
+
+// Rebuilds targetPath from basePath and a patch made by tools/assets-delta/mkpatch.py, reading the patch once
+// in order. The gzip compressed patch holds, little endian: "CCDF", version, base size (u64), target size (u64),
+// the xxhash32 of the target, then instructions until the target is complete, each an op byte and a u32 length:
+// PATCH_COPY is followed by the u64 offset of the bytes in the base, PATCH_ADD by the bytes themselves.
+bool applyPatch(FileUtils* fileUtils, const std::string& basePath, const std::string& patchPath, const std::string& targetPath)
+{
+    gzFile patch = gzopen(fileUtils->getSuitableFOpen(patchPath).c_str(), "rb");
+    FILE* base = fopen(fileUtils->getSuitableFOpen(basePath).c_str(), "rb");
+    const std::string tempPath = targetPath + ".tmp";
+    FILE* out = fopen(fileUtils->getSuitableFOpen(tempPath).c_str(), "wb");
+    void* hashState = XXH32_init(0);
+    bool ok = patch && base && out;
+    
+    char magic[4];
+    uint64_t version = 0, baseSize = 0, targetSize = 0, targetHash = 0;
+    if (ok)
+    {
+        utils::fseek64(base, 0, SEEK_END);
+        ok = readPatch(patch, magic, sizeof(magic)) && memcmp(magic, PATCH_MAGIC, sizeof(magic)) == 0 &&
+            readPatchInteger(patch, &version, 4) && version == PATCH_VERSION &&
+            readPatchInteger(patch, &baseSize, 8) && baseSize == (uint64_t)utils::ftell64(base) &&
+            readPatchInteger(patch, &targetSize, 8) &&
+            readPatchInteger(patch, &targetHash, 4);
+    }
+    
+    std::unique_ptr<char[]> buffer(new char[BUFFER_SIZE]);
+    uint64_t written = 0;
+    while (ok && written < targetSize)
+    {
+        uint64_t op = 0, length = 0, offset = 0;
+        ok = readPatchInteger(patch, &op, 1) && readPatchInteger(patch, &length, 4) && written + length <= targetSize;
+        if (ok && op == PATCH_COPY)
+        {
+            ok = readPatchInteger(patch, &offset, 8) && offset + length <= baseSize && utils::fseek64(base, (int64_t)offset, SEEK_SET) == 0;
+        }
+        else if (op != PATCH_ADD)
+        {
+            ok = false;
+        }
+        for (uint64_t left = length; ok && left > 0;)
+        {
+            unsigned chunk = (unsigned)std::min<uint64_t>(left, BUFFER_SIZE);
+            ok = (op == PATCH_COPY ? fread(buffer.get(), chunk, 1, base) == 1 : readPatch(patch, buffer.get(), chunk)) &&
+                fwrite(buffer.get(), chunk, 1, out) == 1;
+            XXH32_update(hashState, buffer.get(), chunk);
+            left -= chunk;
+        }
+        written += length;
+    }
+    
+    unsigned hash = XXH32_digest(hashState);
+    ok = ok && hash == targetHash;
+    if (out && fclose(out) != 0)
+    {
+        ok = false;
+    }
+    if (base)
+    {
+        fclose(base);
+    }
+    if (patch)
+    {
+        gzclose(patch);
+    }
+    if (!ok || !fileUtils->renameFile(tempPath, targetPath))
+    {
+        CCLOG("AssetsManagerEx : can not apply patch %s to %s\n", patchPath.c_str(), basePath.c_str());
+        fileUtils->removeFile(tempPath);
+        return false;
+    }
+    return true;
+}
+
+} // namespace
+
 bool AssetsManagerEx::decompress(const std::string &zip)
 {
     // Find root path for zip file
@@ -512,15 +732,17 @@ bool AssetsManagerEx::decompress(const std::string &zip)
         return false;
     }
     
-    // Buffer to hold data read from the zip file
-    char readBuffer[BUFFER_SIZE];
-    // Loop to extract all files.
-    uLong i;
-    for (i = 0; i < global_info.number_entry; ++i)
+    // Collect the file entries from the central directory and create their directories up front.
+    std::vector<ZipEntry> entries;
+    entries.reserve(global_info.number_entry);
+    std::unordered_set<std::string> directories;
+    uLong totalSize = 0;
+    for (uLong i = 0; i < global_info.number_entry; ++i)
     {
         // Get info about current file.
         unz_file_info fileInfo;
         char fileName[MAX_FILENAME];
+        ZipEntry entry;
         if (unzGetCurrentFileInfo(zipfile,
                                   &fileInfo,
                                   fileName,
@@ -528,120 +750,215 @@ bool AssetsManagerEx::decompress(const std::string &zip)
                                   NULL,
                                   0,
                                   NULL,
-                                  0) != UNZ_OK)
+                                  0) != UNZ_OK ||
+            unzGetFilePos(zipfile, &entry.pos) != UNZ_OK)
         {
             CCLOG("AssetsManagerEx : can not read compressed file info\n");
             unzClose(zipfile);
             return false;
         }
-        const std::string fullPath = rootPath + fileName;
+        entry.path = rootPath + fileName;
+        entry.size = fileInfo.uncompressed_size;
         
-        // Check if this entry is a directory or a file.
-        const size_t filenameLength = strlen(fileName);
-        if (fileName[filenameLength-1] == '/')
+        //There are not directory entry in some case.
+        //So we need to create directory when decompressing file entry
+        std::string dir = basename(entry.path);
+        if (directories.insert(dir).second && !_fileUtils->isDirectoryExist(dir) && !_fileUtils->createDirectory(dir))
         {
-            //There are not directory entry in some case.
-            //So we need to create directory when decompressing file entry
-            if ( !_fileUtils->createDirectory(basename(fullPath)) )
-            {
-                // Failed to create directory
-                CCLOG("AssetsManagerEx : can not create directory %s\n", fullPath.c_str());
-                unzClose(zipfile);
-                return false;
-            }
+            // Failed to create directory
+            CCLOG("AssetsManagerEx : can not create directory %s\n", entry.path.c_str());
+            unzClose(zipfile);
+            return false;
         }
-        else
+        
+        // Check if this entry is a directory or a file.
+        const size_t filenameLength = strlen(fileName);
+        if (filenameLength > 0 && fileName[filenameLength-1] != '/')
         {
-            // Create all directories in advance to avoid issue
-            std::string dir = basename(fullPath);
-            if (!_fileUtils->isDirectoryExist(dir)) {
-                if (!_fileUtils->createDirectory(dir)) {
-                    // Failed to create directory
-                    CCLOG("AssetsManagerEx : can not create directory %s\n", fullPath.c_str());
-                    unzClose(zipfile);
-                    return false;
-                }
-            }
-            // Entry is a file, so extract it.
-            // Open current file.
-            if (unzOpenCurrentFile(zipfile) != UNZ_OK)
-            {
-                CCLOG("AssetsManagerEx : can not extract file %s\n", fileName);
-                unzClose(zipfile);
-                return false;
-            }
-            
-            // Create a file to store current file.
-            FILE *out = fopen(FileUtils::getInstance()->getSuitableFOpen(fullPath).c_str(), "wb");
-            if (!out)
-            {
-                CCLOG("AssetsManagerEx : can not create decompress destination file %s (errno: %d)\n", fullPath.c_str(), errno);
-                unzCloseCurrentFile(zipfile);
-                unzClose(zipfile);
-                return false;
-            }
-            
-            // Write current file content to destinate file.
-            int error = UNZ_OK;
-            do
-            {
-                error = unzReadCurrentFile(zipfile, readBuffer, BUFFER_SIZE);
-                if (error < 0)
-                {
-                    CCLOG("AssetsManagerEx : can not read zip file %s, error code is %d\n", fileName, error);
-                    fclose(out);
-                    unzCloseCurrentFile(zipfile);
-                    unzClose(zipfile);
-                    return false;
-                }
-                
-                if (error > 0)
-                {
-                    fwrite(readBuffer, error, 1, out);
-                }
-            } while(error > 0);
-            
-            fclose(out);
+            totalSize += entry.size;
+            entries.push_back(std::move(entry));
         }
         
-        unzCloseCurrentFile(zipfile);
-        
         // Goto next entry listed in the zip file.
-        if ((i+1) < global_info.number_entry)
+        if ((i+1) < global_info.number_entry && unzGoToNextFile(zipfile) != UNZ_OK)
         {
-            if (unzGoToNextFile(zipfile) != UNZ_OK)
+            CCLOG("AssetsManagerEx : can not read next file for decompressing\n");
+            unzClose(zipfile);
+            return false;
+        }
+    }
+    unzClose(zipfile);
+    
+    // Entries are independent, large archives are inflated by several threads balanced by uncompressed size.
+    size_t threadCount = std::min<size_t>(std::max(std::thread::hardware_concurrency(), 1u), MAX_DECOMPRESS_THREADS);
+    threadCount = std::max<size_t>(1, std::min<size_t>(threadCount, totalSize / PARALLEL_DECOMPRESS_SIZE));
+    threadCount = std::min(threadCount, std::max<size_t>(1, entries.size()));
+    
+    std::vector<const ZipEntry*> sorted;
+    sorted.reserve(entries.size());
+    for (const auto& entry : entries)
+    {
+        sorted.push_back(&entry);
+    }
+    std::sort(sorted.begin(), sorted.end(), [](const ZipEntry* a, const ZipEntry* b) {
+        return a->size > b->size;
+    });
+    std::vector<std::vector<const ZipEntry*>> batches(threadCount);
+    std::vector<uLong> batchSizes(threadCount, 0);
+    for (auto entry : sorted)
+    {
+        size_t smallest = std::min_element(batchSizes.begin(), batchSizes.end()) - batchSizes.begin();
+        batches[smallest].push_back(entry);
+        batchSizes[smallest] += entry->size;
+    }
+    
+    std::atomic<bool> failed(false);
+    std::mutex pendingMutex;
+    std::condition_variable pendingCondition;
+    size_t pending = threadCount - 1;
+    for (size_t i = 1; i < threadCount; ++i)
+    {
+        getDecompressPool()->pushTask([this, &zip, &batches, &failed, &pendingMutex, &pendingCondition, &pending, i](int /*threadId*/) {
+            if (!extractZipEntries(_fileUtils, zip, batches[i], failed))
             {
-                CCLOG("AssetsManagerEx : can not read next file for decompressing\n");
-                unzClose(zipfile);
-                return false;
+                failed = true;
             }
-        }
+            std::lock_guard<std::mutex> lock(pendingMutex);
+            if (--pending == 0)
+            {
+                pendingCondition.notify_one();
+            }
+        });
+    }
+    if (!extractZipEntries(_fileUtils, zip, batches[0], failed))
+    {
+        failed = true;
+    }
+    std::unique_lock<std::mutex> lock(pendingMutex);
+    pendingCondition.wait(lock, [&pending]() { return pending == 0; });
+    return !failed;
+}
+
+void AssetsManagerEx::preparePatch(const Manifest::Asset &asset, DownloadUnit *unit)
+{
+    auto localIt = _localManifest->getAssets().find(unit->customId);
+    if (localIt == _localManifest->getAssets().end())
+    {
+        return;
+    }
+    auto patchIt = asset.patches.find(localIt->second.md5);
+    if (patchIt == asset.patches.end() || asset.compressed)
+    {
+        return;
     }
     
-    unzClose(zipfile);
-    return true;
+    // The installed version must be a plain file, not inside the APK
+    std::string basePath = _localManifest->getManifestRoot() + localIt->second.path;
+    FILE* base = fopen(_fileUtils->getSuitableFOpen(basePath).c_str(), "rb");
+    if (!base)
+    {
+        return;
+    }
+    fclose(base);
+    
+    unit->srcUrl = _remoteManifest->getPackageUrl() + patchIt->second.path;
+    unit->storagePath.append(PATCH_SUFFIX);
+    unit->size = patchIt->second.size;
+    unit->basePath = basePath;
+}
+
+void AssetsManagerEx::downloadWholeAsset(const std::string &customId)
+{
+    CCLOG("AssetsManagerEx : can not patch %s, downloading the whole file\n", customId.c_str());
+    DownloadUnit& unit = _downloadUnits[customId];
+    const Manifest::Asset& asset = _remoteManifest->getAssets().at(customId);
+    unit.srcUrl = _remoteManifest->getPackageUrl() + asset.path;
+    unit.storagePath = _tempStoragePath + asset.path;
+    unit.size = asset.size;
+    unit.basePath.clear();
+    
+    _queue.push_back(customId);
+    _currConcurrentTask = MAX(0, _currConcurrentTask-1);
+    queueDowload();
 }
 
 void AssetsManagerEx::decompressDownloadedZip(const std::string &customId, const std::string &storagePath)
+{
+    Manifest::Asset asset = Manifest::Asset();
+    asset.compressed = true;
+    processDownloadedAsset(customId, storagePath, asset, nullptr, false);
+}
+
+void AssetsManagerEx::processDownloadedAsset(const std::string &customId, const std::string &storagePath, const Manifest::Asset &asset, AssetHasher *hasher, bool hashFile, const std::string &basePath)
 {
     struct AsyncData
     {
         std::string customId;
         std::string zipFile;
+        std::string basePath;
+        Manifest::Asset asset;
+        std::unique_ptr<AssetHasher> hasher;
+        bool hashFile;
+        // Patched files without a hasher go through the verify callback on the cocos thread, as downloaded ones do
+        bool verifyPatched;
+        bool patched;
+        bool verified;
         bool succeed;
+        // Set when the downloaded file could not be read, it was not verified at all
+        std::string error;
+        int errorCode;
     };
     
     AsyncData* asyncData = new AsyncData;
     asyncData->customId = customId;
     asyncData->zipFile = storagePath;
+    asyncData->basePath = basePath;
+    asyncData->asset = asset;
+    asyncData->hasher.reset(hasher);
+    asyncData->hashFile = hashFile;
+    asyncData->verifyPatched = !basePath.empty() && !hasher && _verifyCallback != nullptr;
+    asyncData->patched = false;
+    asyncData->verified = false;
     asyncData->succeed = false;
+    asyncData->errorCode = 0;
     
     std::function<void(void*)> decompressFinished = [this](void* param) {
         auto dataInner = reinterpret_cast<AsyncData*>(param);
-        if (dataInner->succeed)
+        if (dataInner->patched)
+        {
+            if (_verifyCallback == nullptr || _verifyCallback(dataInner->zipFile, dataInner->asset))
+            {
+                if (dataInner->asset.compressed)
+                {
+                    decompressDownloadedZip(dataInner->customId, dataInner->zipFile);
+                }
+                else
+                {
+                    fileSuccess(dataInner->customId, dataInner->zipFile);
+                }
+            }
+            else
+            {
+                downloadWholeAsset(dataInner->customId);
+            }
+        }
+        else if (dataInner->succeed)
         {
             fileSuccess(dataInner->customId, dataInner->zipFile);
         }
+        else if (!dataInner->error.empty())
+        {
+            fileError(dataInner->customId, dataInner->error, 0, dataInner->errorCode);
+        }
+        else if (!dataInner->basePath.empty() && !dataInner->verified)
+        {
+            // The patch is only an optimization, the whole file is downloaded instead
+            downloadWholeAsset(dataInner->customId);
+        }
+        else if (!dataInner->verified)
+        {
+            fileError(dataInner->customId, "Asset file verification failed after downloaded");
+        }
         else
         {
             std::string errorMsg = "Unable to decompress file " + dataInner->zipFile;
@@ -653,6 +970,60 @@ void AssetsManagerEx::decompressDownloadedZip(const std::string &customId, const
         delete dataInner;
     };
     AsyncTaskPool::getInstance()->enqueue(AsyncTaskPool::TaskType::TASK_OTHER, decompressFinished, (void*)asyncData, [this, asyncData]() {
+        if (!asyncData->basePath.empty())
+        {
+            const std::string patchPath = asyncData->zipFile + PATCH_SUFFIX;
+            bool patched = applyPatch(_fileUtils, asyncData->basePath, patchPath, asyncData->zipFile);
+            _fileUtils->removeFile(patchPath);
+            if (!patched)
+            {
+                return;
+            }
+            if (asyncData->verifyPatched)
+            {
+                asyncData->patched = true;
+                return;
+            }
+        }
+        
+        // Check the digest fed while downloading, resumed downloads are hashed from the file
+        if (asyncData->hasher)
+        {
+            if (asyncData->hashFile)
+            {
+                FILE* file = fopen(_fileUtils->getSuitableFOpen(asyncData->zipFile).c_str(), "rb");
+                if (!file)
+                {
+                    asyncData->errorCode = errno;
+                    asyncData->error = StringUtils::format("Unable to open downloaded file %s: %s", asyncData->zipFile.c_str(), strerror(errno));
+                    return;
+                }
+                std::unique_ptr<unsigned char[]> buffer(new unsigned char[HASH_BUFFER_SIZE]);
+                size_t size = 0;
+                while ((size = fread(buffer.get(), 1, HASH_BUFFER_SIZE, file)) > 0)
+                {
+                    asyncData->hasher->update(buffer.get(), size);
+                }
+                if (ferror(file))
+                {
+                    asyncData->errorCode = errno;
+                    asyncData->error = StringUtils::format("Unable to read downloaded file %s: %s", asyncData->zipFile.c_str(), strerror(errno));
+                    fclose(file);
+                    return;
+                }
+                fclose(file);
+            }
+            if (!asyncData->hasher->verify(asyncData->asset))
+            {
+                return;
+            }
+        }
+        asyncData->verified = true;
+        if (!asyncData->asset.compressed)
+        {
+            asyncData->succeed = true;
+            return;
+        }
         // Decompress all compressed files
         if (decompress(asyncData->zipFile))
         {
@@ -890,6 +1261,10 @@ void AssetsManagerEx::prepareUpdate()
                     unit.srcUrl = packageUrl + path;
                     unit.storagePath = _tempStoragePath + path;
                     unit.size = diff.asset.size;
+                    if (diff.type == Manifest::DiffType::MODIFIED && !diff.asset.patches.empty())
+                    {
+                        preparePatch(diff.asset, &unit);
+                    }
                     _downloadUnits.emplace(unit.customId, unit);
                     _tempManifest->setAssetDownloadState(it->first, Manifest::DownloadState::UNSTARTED);
                 }
@@ -936,6 +1311,10 @@ void AssetsManagerEx::updateSucceed()
     // Every thing is correctly downloaded, do the following
     // 1. rename temporary manifest to valid manifest
     _fileUtils->renameFile(_tempStoragePath, TEMP_MANIFEST_FILENAME, MANIFEST_FILENAME);
+    if (_fileUtils->isFileExist(Manifest::getCachePath(_tempManifestPath)))
+    {
+        _fileUtils->renameFile(_tempStoragePath, Manifest::getCachePath(TEMP_MANIFEST_FILENAME), Manifest::getCachePath(MANIFEST_FILENAME));
+    }
     // 2. merge temporary storage path to storage path so that temporary version turns to cached version
     if (_fileUtils->isDirectoryExist(_tempStoragePath))
     {
@@ -965,6 +1344,8 @@ void AssetsManagerEx::updateSucceed()
         }
         // Remove temp storage path
         _fileUtils->removeDirectory(_tempStoragePath);
+        // Let relative lookups find the merged files
+        _fileUtils->notifyFilesChanged(_storagePath);
     }
     // 3. swap the localManifest
     CC_SAFE_RELEASE(_localManifest);
@@ -1204,6 +1585,12 @@ void AssetsManagerEx::onError(const network::DownloadTask& task,
     }
     else
     {
+        auto unitIt = _downloadUnits.find(task.identifier);
+        if (unitIt != _downloadUnits.end() && !unitIt->second.basePath.empty())
+        {
+            downloadWholeAsset(task.identifier);
+            return;
+        }
         fileError(task.identifier, errorStr, errorCode, errorCodeInternal);
     }
 }
@@ -1282,6 +1669,39 @@ void AssetsManagerEx::onSuccess(const std::string &/*srcUrl*/, const std::string
         bool ok = true;
         auto &assets = _remoteManifest->getAssets();
         auto assetIt = assets.find(customId);
+        
+        std::unique_ptr<AssetHasher> hasher;
+        int64_t hashedSize = 0;
+        {
+            std::lock_guard<std::mutex> lock(_streamHashes->mutex);
+            auto hashIt = _streamHashes->hashers.find(customId);
+            if (hashIt != _streamHashes->hashers.end())
+            {
+                hasher = std::move(hashIt->second.first);
+                hashedSize = hashIt->second.second;
+                _streamHashes->hashers.erase(hashIt);
+            }
+        }
+        auto unitIt = _downloadUnits.find(customId);
+        if (unitIt != _downloadUnits.end() && !unitIt->second.basePath.empty() && assetIt != assets.end())
+        {
+            const std::string targetPath = storagePath.substr(0, storagePath.size() - strlen(PATCH_SUFFIX));
+            processDownloadedAsset(customId, targetPath, assetIt->second, _hasherFactory ? _hasherFactory() : nullptr, true, unitIt->second.basePath);
+            return;
+        }
+        
+        if (hasher && assetIt != assets.end())
+        {
+            // Part of a resumed file was downloaded before this hasher existed
+            bool hashFile = hashedSize != _fileUtils->getFileSize(storagePath);
+            if (hashFile)
+            {
+                hasher.reset(_hasherFactory());
+            }
+            processDownloadedAsset(customId, storagePath, assetIt->second, hasher.release(), hashFile);
+            return;
+        }
+        
         if (assetIt != assets.end())
         {
             Manifest::Asset asset = assetIt->second;
@@ -1314,6 +1734,7 @@ void AssetsManagerEx::destroyDownloadedVersion()
 {
     _fileUtils->removeDirectory(_storagePath);
     _fileUtils->removeDirectory(_tempStoragePath);
+    _fileUtils->notifyFilesChanged(_storagePath);
 }
 
 void AssetsManagerEx::batchDownload()
@@ -1355,6 +1776,12 @@ void AssetsManagerEx::queueDowload()
         _currConcurrentTask++;
         DownloadUnit& unit = _downloadUnits[key];
         _fileUtils->createDirectory(basename(unit.storagePath));
+        // Hashers check the patched file, not the patch
+        if (_hasherFactory && unit.basePath.empty())
+        {
+            std::lock_guard<std::mutex> lock(_streamHashes->mutex);
+            _streamHashes->hashers[key] = std::make_pair(std::unique_ptr<AssetHasher>(_hasherFactory()), (int64_t)0);
+        }
         _downloader->createDownloadFileTask(unit.srcUrl, unit.storagePath, unit.customId);
         
         _tempManifest->setAssetDownloadState(key, Manifest::DownloadState::DOWNLOADING);
@@ -37,6 +37,8 @@
 #include "extensions/ExtensionExport.h"
 #include "json/document-wrapper.h"
 
+#include <mutex>
+
 
 NS_CC_EXT_BEGIN
 
@@ -72,6 +74,18 @@ public:
     typedef std::function<int(const std::string& versionA, const std::string& versionB)> VersionCompareHandle;
     typedef std::function<bool(const std::string& path, Manifest::Asset asset)> VerifyCallback;
     
+    /** @brief Incremental digest of one asset, fed with the asset data while it is downloaded.
+     */
+    class AssetHasher
+    {
+    public:
+        virtual ~AssetHasher() {}
+        virtual void update(const unsigned char* data, size_t size) = 0;
+        /** @brief Checks the digest against the asset, e.g. its md5, returns false to reject the file. */
+        virtual bool verify(const Manifest::Asset& asset) = 0;
+    };
+    typedef std::function<AssetHasher*()> HasherFactory;
+    
     /** @brief Create function for creating a new AssetsManagerEx
      @param manifestUrl   The url for the local manifest file
      @param storagePath   The storage path for downloaded assets
@@ -183,6 +197,13 @@ public:
      */
     void setVerifyCallback(const VerifyCallback& callback) {_verifyCallback = callback;};
     
+    /** @brief Set the factory of hashers verifying assets while they are downloaded, it takes precedence over the verify callback.
+     * Hashers are fed from the downloader thread, then verified and decompressed on a worker thread, so files are never read back
+     * on the main thread. Resumed downloads and downloaders without data streaming are hashed from the file instead.
+     * @param factory  Creates a hasher for each asset, called on the main thread
+     */
+    void setHasherFactory(const HasherFactory& factory) {_hasherFactory = factory;};
+    
 CC_CONSTRUCTOR_ACCESS:
     
     AssetsManagerEx(const std::string& manifestUrl, const std::string& storagePath);
@@ -217,6 +238,15 @@ protected:
     void updateSucceed();
     bool decompress(const std::string &filename);
     void decompressDownloadedZip(const std::string &customId, const std::string &storagePath);
+    void processDownloadedAsset(const std::string &customId, const std::string &storagePath, const Manifest::Asset &asset, AssetHasher *hasher, bool hashFile, const std::string &basePath = "");
+    
+    /** @brief Switches a modified asset to its patch when the manifest has one for the installed version
+     */
+    void preparePatch(const Manifest::Asset &asset, DownloadUnit *unit);
+    
+    /** @brief Queues the full download of an asset whose patch failed
+     */
+    void downloadWholeAsset(const std::string &customId);
     
     /** @brief Update a list of assets under the current AssetsManagerEx context
      */
@@ -383,6 +413,17 @@ private:
     //! Callback function to verify the downloaded assets
     VerifyCallback _verifyCallback;
     
+    //! Factory of the hashers verifying assets while they download
+    HasherFactory _hasherFactory;
+    
+    //! Hashers of the assets being downloaded with the size they were fed, shared with the downloader thread
+    struct StreamHashes
+    {
+        std::mutex mutex;
+        std::unordered_map<std::string, std::pair<std::unique_ptr<AssetHasher>, int64_t>> hashers;
+    };
+    std::shared_ptr<StreamHashes> _streamHashes;
+    
     //! Marker for whether the assets manager is inited
     bool _inited;
 };
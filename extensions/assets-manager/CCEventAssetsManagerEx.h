@@ -97,7 +97,7 @@ private:
     int _curle_code;
     
     int _curlm_code;
-    COCOS_TYPE_OVERRIDE(EventAssetsManagerEx);
+    COCOS_TYPE_OVERRIDE(EventAssetsManagerEx, cocos2d::EventCustom);
 };
 
 NS_CC_EXT_END
@@ -24,9 +24,12 @@
 
 #include "ccHeader.h"
 #include "Manifest.h"
+#include "json/reader.h"
 #include "json/prettywriter.h"
 #include "json/stringbuffer.h"
+#include "xxhash/xxhash.h"
 
+#include <climits>
 #include <fstream>
 #include <stdio.h>
 
@@ -48,6 +51,11 @@
 #define KEY_SIZE                "size"
 #define KEY_COMPRESSED_FILE     "compressedFile"
 #define KEY_DOWNLOAD_STATE      "downloadState"
+#define KEY_PATCHES             "patches"
+
+#define CACHE_SUFFIX            ".bin"
+#define CACHE_MAGIC             "CCMF"
+#define CACHE_VERSION           2
 
 NS_CC_EXT_BEGIN
 
@@ -104,7 +112,379 @@ Manifest::Manifest(const std::string& content, const std::string& manifestRoot)
         parseJSONString(content, manifestRoot);
 }
 
-void Manifest::loadJson(const std::string& url)
+// Fills a manifest while rapidjson reads the text, no document is built.
+// Unknown members of the root and of the assets are written aside as raw json, others are skipped.
+class Manifest::JsonHandler : public rapidjson::BaseReaderHandler<rapidjson::UTF8<>, Manifest::JsonHandler>
+{
+public:
+    JsonHandler(Manifest* manifest, bool versionOnly)
+    : _manifest(manifest)
+    , _versionOnly(versionOnly)
+    , _asset(nullptr)
+    , _patch(nullptr)
+    , _raw(nullptr)
+    {
+    }
+    
+    bool Null()
+    {
+        if (raw())
+            return _rawWriter.Null() && endRaw();
+        return scalar();
+    }
+    bool Bool(bool b)
+    {
+        if (raw())
+            return _rawWriter.Bool(b) && endRaw();
+        if (_key == KEY_UPDATING && top() == Scope::ROOT)
+            _manifest->_updating = b;
+        else if (_key == KEY_COMPRESSED && top() == Scope::ASSET)
+            _asset->compressed = b;
+        return scalar();
+    }
+    bool Int(int i) { return raw() ? _rawWriter.Int(i) && endRaw() : integer(i, true); }
+    bool Uint(unsigned u) { return raw() ? _rawWriter.Uint(u) && endRaw() : integer((double)u, u <= INT_MAX); }
+    bool Int64(int64_t i) { return raw() ? _rawWriter.Int64(i) && endRaw() : integer((double)i, false); }
+    bool Uint64(uint64_t u) { return raw() ? _rawWriter.Uint64(u) && endRaw() : integer((double)u, false); }
+    bool Double(double d) { return raw() ? _rawWriter.Double(d) && endRaw() : scalar(); }
+    bool String(const char* str, rapidjson::SizeType length, bool copy)
+    {
+        if (raw())
+            return _rawWriter.String(str, length) && endRaw();
+        switch (top())
+        {
+            case Scope::ROOT:
+                if (_key == KEY_VERSION)
+                    _manifest->_version.assign(str, length);
+                else if (_key == KEY_PACKAGE_URL)
+                    _manifest->_packageUrl.assign(str, length);
+                else if (_key == KEY_MANIFEST_URL)
+                    _manifest->_remoteManifestUrl.assign(str, length);
+                else if (_key == KEY_VERSION_URL)
+                    _manifest->_remoteVersionUrl.assign(str, length);
+                else if (_key == KEY_ENGINE_VERSION)
+                    _manifest->_engineVer.assign(str, length);
+                break;
+            case Scope::GROUP_VERSIONS:
+                _manifest->_groups.push_back(_key);
+                _manifest->_groupVer.emplace(_key, std::string(str, length));
+                return true;
+            case Scope::ASSET:
+                if (_key == KEY_MD5)
+                    _asset->md5.assign(str, length);
+                else if (_key == KEY_PATH)
+                    _asset->path.assign(str, length);
+                break;
+            case Scope::PATCH:
+                if (_key == KEY_PATH)
+                    _patch->path.assign(str, length);
+                break;
+            case Scope::SEARCH_PATHS:
+                _manifest->_searchPaths.emplace_back(str, length);
+                break;
+            default:
+                break;
+        }
+        return true;
+    }
+    bool Key(const char* str, rapidjson::SizeType length, bool copy)
+    {
+        if (_raw)
+            return _rawWriter.Key(str, length);
+        _key.assign(str, length);
+        return true;
+    }
+    bool StartObject()
+    {
+        if (raw())
+            return _rawWriter.StartObject();
+        Scope scope = Scope::SKIP;
+        switch (top())
+        {
+            case Scope::NONE:
+                scope = Scope::ROOT;
+                break;
+            case Scope::ROOT:
+                if (_key == KEY_GROUP_VERSIONS)
+                    scope = Scope::GROUP_VERSIONS;
+                else if (_key == KEY_ASSETS && !_versionOnly)
+                    scope = Scope::ASSETS;
+                break;
+            case Scope::ASSETS:
+            {
+                scope = Scope::ASSET;
+                Asset asset;
+                asset.path = _key;
+                asset.compressed = false;
+                asset.size = 0;
+                asset.downloadState = DownloadState::UNMARKED;
+                _asset = &_manifest->_assets.emplace(_key, std::move(asset)).first->second;
+                break;
+            }
+            case Scope::ASSET:
+                if (_key == KEY_PATCHES)
+                    scope = Scope::PATCHES;
+                break;
+            case Scope::PATCHES:
+            {
+                scope = Scope::PATCH;
+                ManifestPatch patch;
+                patch.size = 0;
+                _patchKey = _key;
+                _patch = &_asset->patches.emplace(_key, std::move(patch)).first->second;
+                break;
+            }
+            default:
+                break;
+        }
+        if (top() == Scope::GROUP_VERSIONS)
+        {
+            scalar();
+        }
+        _scopes.push_back(scope);
+        return true;
+    }
+    bool EndObject(rapidjson::SizeType memberCount)
+    {
+        if (_raw)
+            return _rawWriter.EndObject(memberCount) && endRaw();
+        // Patches without a path are left out
+        if (top() == Scope::PATCH && _patch->path.empty())
+        {
+            _asset->patches.erase(_patchKey);
+        }
+        _scopes.pop_back();
+        return true;
+    }
+    bool StartArray()
+    {
+        if (raw())
+            return _rawWriter.StartArray();
+        scalar();
+        _scopes.push_back(top() == Scope::ROOT && _key == KEY_SEARCH_PATHS && !_versionOnly ? Scope::SEARCH_PATHS : Scope::SKIP);
+        return true;
+    }
+    bool EndArray(rapidjson::SizeType elementCount)
+    {
+        if (_raw)
+            return _rawWriter.EndArray(elementCount) && endRaw();
+        _scopes.pop_back();
+        return true;
+    }
+    
+private:
+    enum class Scope
+    {
+        NONE,
+        ROOT,
+        GROUP_VERSIONS,
+        ASSETS,
+        ASSET,
+        PATCHES,
+        PATCH,
+        SEARCH_PATHS,
+        SKIP
+    };
+    
+    Scope top() const { return _scopes.empty() ? Scope::NONE : _scopes.back(); }
+    
+    static bool isRootKey(const std::string& key)
+    {
+        return key == KEY_VERSION || key == KEY_PACKAGE_URL || key == KEY_MANIFEST_URL || key == KEY_VERSION_URL ||
+            key == KEY_GROUP_VERSIONS || key == KEY_ENGINE_VERSION || key == KEY_UPDATING || key == KEY_ASSETS ||
+            key == KEY_SEARCH_PATHS;
+    }
+    
+    static bool isAssetKey(const std::string& key)
+    {
+        return key == KEY_PATH || key == KEY_MD5 || key == KEY_COMPRESSED || key == KEY_SIZE ||
+            key == KEY_DOWNLOAD_STATE || key == KEY_PATCHES;
+    }
+    
+    // Whether the value starting or going on belongs to an unknown member, which is then written aside
+    bool raw()
+    {
+        if (_raw)
+            return true;
+        if (top() == Scope::ROOT && !isRootKey(_key))
+            _raw = &_manifest->_unknownMembers;
+        else if (top() == Scope::ASSET && !isAssetKey(_key))
+            _raw = &_asset->unknownMembers;
+        else
+            return false;
+        _rawBuffer.Clear();
+        _rawWriter.Reset(_rawBuffer);
+        return true;
+    }
+    
+    bool endRaw()
+    {
+        if (_rawWriter.IsComplete())
+        {
+            _raw->emplace_back(_key, std::string(_rawBuffer.GetString(), _rawBuffer.GetSize()));
+            _raw = nullptr;
+        }
+        return true;
+    }
+    
+    // Group versions which are not strings count as "0"
+    bool scalar()
+    {
+        if (top() == Scope::GROUP_VERSIONS)
+        {
+            _manifest->_groups.push_back(_key);
+            _manifest->_groupVer.emplace(_key, "0");
+        }
+        return true;
+    }
+    
+    bool integer(double value, bool isInt)
+    {
+        if (isInt && _key == KEY_SIZE && top() == Scope::ASSET)
+            _asset->size = (float)value;
+        else if (isInt && _key == KEY_DOWNLOAD_STATE && top() == Scope::ASSET)
+            _asset->downloadState = (int)value;
+        else if (isInt && _key == KEY_SIZE && top() == Scope::PATCH)
+            _patch->size = (float)value;
+        return scalar();
+    }
+    
+    Manifest* _manifest;
+    bool _versionOnly;
+    std::vector<Scope> _scopes;
+    std::string _key;
+    std::string _patchKey;
+    Asset* _asset;
+    ManifestPatch* _patch;
+    ManifestRawMembers* _raw;
+    rapidjson::StringBuffer _rawBuffer;
+    rapidjson::Writer<rapidjson::StringBuffer> _rawWriter;
+};
+
+namespace {
+
+// The binary cache is only read on the device which wrote it, so it uses the native byte order.
+class CacheReader
+{
+public:
+    CacheReader(const unsigned char* data, ssize_t size)
+    : _cursor(data)
+    , _end(data + size)
+    {
+    }
+    
+    template <typename T>
+    bool read(T* value)
+    {
+        if (_end - _cursor < (ssize_t)sizeof(T))
+            return false;
+        memcpy(value, _cursor, sizeof(T));
+        _cursor += sizeof(T);
+        return true;
+    }
+    
+    bool read(std::string* value)
+    {
+        uint32_t length = 0;
+        if (!read(&length) || _end - _cursor < (ssize_t)length)
+            return false;
+        value->assign((const char*)_cursor, length);
+        _cursor += length;
+        return true;
+    }
+    
+    // Reads a count of records taking at least recordSize bytes each, a count the bytes left can't hold is corrupt
+    bool readCount(uint32_t* count, size_t recordSize)
+    {
+        return read(count) && (uint64_t)*count * recordSize <= (uint64_t)(_end - _cursor);
+    }
+    
+    bool read(ManifestRawMembers* members)
+    {
+        uint32_t count = 0;
+        if (!readCount(&count, sizeof(uint32_t) * 2))
+            return false;
+        members->resize(count);
+        for (auto& member : *members)
+        {
+            if (!read(&member.first) || !read(&member.second))
+                return false;
+        }
+        return true;
+    }
+    
+private:
+    const unsigned char* _cursor;
+    const unsigned char* _end;
+};
+
+class CacheWriter
+{
+public:
+    template <typename T>
+    void write(const T& value)
+    {
+        _buffer.append((const char*)&value, sizeof(T));
+    }
+    
+    void write(const std::string& value)
+    {
+        write((uint32_t)value.size());
+        _buffer.append(value);
+    }
+    
+    void write(const ManifestRawMembers& members)
+    {
+        write((uint32_t)members.size());
+        for (const auto& member : members)
+        {
+            write(member.first);
+            write(member.second);
+        }
+    }
+    
+    const std::string& getBuffer() const { return _buffer; }
+    
+private:
+    std::string _buffer;
+};
+
+template <typename Writer>
+void writeRawMembers(Writer& writer, const ManifestRawMembers& members)
+{
+    for (const auto& member : members)
+    {
+        writer.Key(member.first.c_str(), (rapidjson::SizeType)member.first.size());
+        // Replayed through the writer, which keeps its indentation
+        rapidjson::Reader reader;
+        rapidjson::StringStream stream(member.second.c_str());
+        reader.Parse(stream, writer);
+    }
+}
+
+bool writeFileAtomically(FileUtils* fileUtils, const std::string& path, const std::string& content)
+{
+    // Written aside then renamed, an interrupted save never leaves a truncated file
+    const std::string tempPath = path + ".tmp";
+    {
+        std::ofstream output(fileUtils->getSuitableFOpen(tempPath), std::ofstream::out | std::ofstream::binary);
+        if (!output)
+            return false;
+        output.write(content.data(), content.size());
+        if (!output.flush())
+            return false;
+    }
+    return fileUtils->renameFile(tempPath, path);
+}
+
+} // namespace
+
+std::string Manifest::getCachePath(const std::string &manifestPath)
+{
+    return manifestPath + CACHE_SUFFIX;
+}
+
+bool Manifest::loadJson(const std::string& url, bool versionOnly)
 {
     clear();
     std::string content;
@@ -117,49 +497,64 @@ void Manifest::loadJson(const std::string& url)
         {
             CCLOG("Fail to retrieve local file content: %s\n", url.c_str());
         }
+        else if (!versionOnly && loadCache(getCachePath(url), content))
+        {
+            return true;
+        }
         else
         {
-            loadJsonFromString(content);
+            return loadJsonFromString(content, versionOnly);
         }
     }
+    return false;
 }
 
-void Manifest::loadJsonFromString(const std::string& content)
+bool Manifest::loadJsonFromString(const std::string& content, bool versionOnly)
 {
     if (content.size() == 0)
     {
         CCLOG("Fail to parse empty json content.");
+        return false;
     }
-    else
+    
+    // Parse file with rapid json
+    JsonHandler handler(this, versionOnly);
+    rapidjson::Reader reader;
+    rapidjson::StringStream stream(content.c_str());
+    rapidjson::ParseResult result = reader.Parse(stream, handler);
+    // Print error
+    if (result.IsError())
     {
-        // Parse file with rapid json
-        _json.Parse<0>(content.c_str());
-        // Print error
-        if (_json.HasParseError()) {
-            size_t offset = _json.GetErrorOffset();
-            if (offset > 0)
-                offset--;
-            std::string errorSnippet = content.substr(offset, 10);
-            CCLOG("File parse error %d at <%s>\n", _json.GetParseError(), errorSnippet.c_str());
-        }
+        size_t offset = result.Offset();
+        if (offset > 0)
+            offset--;
+        std::string errorSnippet = content.substr(offset, 10);
+        CCLOG("File parse error %d at <%s>\n", result.Code(), errorSnippet.c_str());
+        // Fields read before the error are dropped
+        _versionLoaded = _loaded = true;
+        clear();
+        return false;
+    }
+    
+    // Append automatically "/"
+    if (_packageUrl.size() > 0 && _packageUrl[_packageUrl.size() - 1] != '/')
+    {
+        _packageUrl.append("/");
     }
+    return true;
 }
 
 void Manifest::parseVersion(const std::string& versionUrl)
 {
-    loadJson(versionUrl);
-    
-    if (_json.IsObject())
+    if (loadJson(versionUrl, true))
     {
-        loadVersion(_json);
+        _versionLoaded = true;
     }
 }
 
 void Manifest::parseFile(const std::string& manifestUrl)
 {
-    loadJson(manifestUrl);
-	
-    if (!_json.HasParseError() && _json.IsObject())
+    if (loadJson(manifestUrl, false))
     {
         // Register the local manifest root
         size_t found = manifestUrl.find_last_of("/\\");
@@ -167,19 +562,18 @@ void Manifest::parseFile(const std::string& manifestUrl)
         {
             _manifestRoot = manifestUrl.substr(0, found+1);
         }
-        loadManifest(_json);
+        _versionLoaded = _loaded = true;
     }
 }
 
 void Manifest::parseJSONString(const std::string& content, const std::string& manifestRoot)
 {
-    loadJsonFromString(content);
-    
-    if (!_json.HasParseError() && _json.IsObject())
+    clear();
+    if (loadJsonFromString(content, false))
     {
         // Register the local manifest root
         _manifestRoot = manifestRoot;
-        loadManifest(_json);
+        _versionLoaded = _loaded = true;
     }
 }
 
@@ -192,18 +586,11 @@ bool Manifest::isLoaded() const
     return _loaded;
 }
 
+
 void Manifest::setUpdating(bool updating)
 {
-    if (_loaded && _json.IsObject())
+    if (_loaded)
     {
-        if (_json.HasMember(KEY_UPDATING) && _json[KEY_UPDATING].IsBool())
-        {
-            _json[KEY_UPDATING].SetBool(updating);
-        }
-        else
-        {
-            _json.AddMember<bool>(KEY_UPDATING, updating, _json.GetAllocator());
-        }
         _updating = updating;
     }
 }
@@ -259,48 +646,34 @@ std::unordered_map<std::string, Manifest::AssetDiff> Manifest::genDiff(const Man
     std::unordered_map<std::string, AssetDiff> diff_map;
     const std::unordered_map<std::string, Asset> &bAssets = b->getAssets();
     
-    std::string key;
-    Asset valueA;
-    Asset valueB;
-    
-    std::unordered_map<std::string, Asset>::const_iterator valueIt, it;
-    for (it = _assets.begin(); it != _assets.end(); ++it)
+    // Assets are compared in place, only the differences are copied
+    for (const auto& it : _assets)
     {
-        key = it->first;
-        valueA = it->second;
-        
+        auto valueIt = bAssets.find(it.first);
         // Deleted
-        valueIt = bAssets.find(key);
         if (valueIt == bAssets.cend()) {
             AssetDiff diff;
-            diff.asset = valueA;
+            diff.asset = it.second;
             diff.type = DiffType::DELETED;
-            diff_map.emplace(key, diff);
-            continue;
+            diff_map.emplace(it.first, std::move(diff));
         }
-        
         // Modified
-        valueB = valueIt->second;
-        if (valueA.md5 != valueB.md5) {
+        else if (it.second.md5 != valueIt->second.md5) {
             AssetDiff diff;
-            diff.asset = valueB;
+            diff.asset = valueIt->second;
             diff.type = DiffType::MODIFIED;
-            diff_map.emplace(key, diff);
+            diff_map.emplace(it.first, std::move(diff));
         }
     }
     
-    for (it = bAssets.begin(); it != bAssets.end(); ++it)
+    for (const auto& it : bAssets)
     {
-        key = it->first;
-        valueB = it->second;
-        
         // Added
-        valueIt = _assets.find(key);
-        if (valueIt == _assets.cend()) {
+        if (_assets.find(it.first) == _assets.cend()) {
             AssetDiff diff;
-            diff.asset = valueB;
+            diff.asset = it.second;
             diff.type = DiffType::ADDED;
-            diff_map.emplace(key, diff);
+            diff_map.emplace(it.first, std::move(diff));
         }
     }
     
@@ -415,30 +788,6 @@ void Manifest::setAssetDownloadState(const std::string &key, const Manifest::Dow
     if (valueIt != _assets.end())
     {
         valueIt->second.downloadState = state;
-        
-        // Update json object
-        if(_json.IsObject())
-        {
-            if ( _json.HasMember(KEY_ASSETS) )
-            {
-                rapidjson::Value &assets = _json[KEY_ASSETS];
-                if (assets.IsObject())
-                {
-                    if (assets.HasMember(key.c_str()))
-                    {
-                        rapidjson::Value &entry = assets[key.c_str()];
-                        if (entry.HasMember(KEY_DOWNLOAD_STATE) && entry[KEY_DOWNLOAD_STATE].IsInt())
-                        {
-                            entry[KEY_DOWNLOAD_STATE].SetInt((int) state);
-                        }
-                        else
-                        {
-                            entry.AddMember<int>(KEY_DOWNLOAD_STATE, (int)state, _json.GetAllocator());
-                        }
-                    }
-                }
-            }
-        }
     }
 }
 
@@ -449,10 +798,13 @@ void Manifest::clear()
         _groups.clear();
         _groupVer.clear();
         
+        _packageUrl = "";
         _remoteManifestUrl = "";
         _remoteVersionUrl = "";
         _version = "";
         _engineVer = "";
+        _updating = false;
+        _unknownMembers.clear();
         
         _versionLoaded = false;
     }
@@ -465,156 +817,230 @@ void Manifest::clear()
     }
 }
 
-Manifest::Asset Manifest::parseAsset(const std::string &path, const rapidjson::Value &json)
+
+bool Manifest::loadCache(const std::string &cachePath, const std::string &content)
 {
-    Asset asset;
-    asset.path = path;
-	
-    if ( json.HasMember(KEY_MD5) && json[KEY_MD5].IsString() )
+    if (!_fileUtils->isFileExist(cachePath))
     {
-        asset.md5 = json[KEY_MD5].GetString();
+        return false;
     }
-    else asset.md5 = "";
+    Data data = _fileUtils->getDataFromFile(cachePath);
+    CacheReader reader(data.getBytes(), data.getSize());
     
-    if ( json.HasMember(KEY_PATH) && json[KEY_PATH].IsString() )
+    char magic[4];
+    uint32_t version = 0, contentSize = 0, contentHash = 0;
+    if (!reader.read(&magic) || memcmp(magic, CACHE_MAGIC, sizeof(magic)) != 0 ||
+        !reader.read(&version) || version != CACHE_VERSION ||
+        !reader.read(&contentSize) || contentSize != content.size() ||
+        !reader.read(&contentHash) || contentHash != XXH32(content.data(), (int)content.size(), 0))
     {
-        asset.path = json[KEY_PATH].GetString();
+        return false;
     }
     
-    if ( json.HasMember(KEY_COMPRESSED) && json[KEY_COMPRESSED].IsBool() )
+    uint8_t updating = 0;
+    uint32_t groupCount = 0, searchPathCount = 0, assetCount = 0;
+    bool ok = reader.read(&_version) && reader.read(&_packageUrl) && reader.read(&_remoteManifestUrl) &&
+        reader.read(&_remoteVersionUrl) && reader.read(&_engineVer) && reader.read(&updating) &&
+        reader.read(&_unknownMembers) && reader.readCount(&groupCount, sizeof(uint32_t) * 2);
+    for (uint32_t i = 0; ok && i < groupCount; ++i)
     {
-        asset.compressed = json[KEY_COMPRESSED].GetBool();
+        std::string group, groupVersion;
+        ok = reader.read(&group) && reader.read(&groupVersion);
+        _groups.push_back(group);
+        _groupVer.emplace(std::move(group), std::move(groupVersion));
     }
-    else asset.compressed = false;
-    
-    if ( json.HasMember(KEY_SIZE) && json[KEY_SIZE].IsInt() )
+    ok = ok && reader.readCount(&searchPathCount, sizeof(uint32_t));
+    for (uint32_t i = 0; ok && i < searchPathCount; ++i)
     {
-        asset.size = json[KEY_SIZE].GetInt();
+        _searchPaths.emplace_back();
+        ok = reader.read(&_searchPaths.back());
     }
-    else asset.size = 0;
-    
-    if ( json.HasMember(KEY_DOWNLOAD_STATE) && json[KEY_DOWNLOAD_STATE].IsInt() )
+    // key, md5, path, compressed, size, download state, unknown members and patch count
+    const size_t assetRecordSize = sizeof(uint32_t) * 3 + sizeof(uint8_t) + sizeof(Asset::size) +
+        sizeof(Asset::downloadState) + sizeof(uint32_t) * 2;
+    ok = ok && reader.readCount(&assetCount, assetRecordSize);
+    if (ok)
     {
-        asset.downloadState = (json[KEY_DOWNLOAD_STATE].GetInt());
+        _assets.reserve(assetCount);
+    }
+    for (uint32_t i = 0; ok && i < assetCount; ++i)
+    {
+        std::string key;
+        Asset asset;
+        uint8_t compressed = 0;
+        uint32_t patchCount = 0;
+        ok = reader.read(&key) && reader.read(&asset.md5) && reader.read(&asset.path) && reader.read(&compressed) &&
+            reader.read(&asset.size) && reader.read(&asset.downloadState) && reader.read(&asset.unknownMembers) &&
+            reader.readCount(&patchCount, sizeof(uint32_t) * 2 + sizeof(ManifestPatch::size));
+        for (uint32_t j = 0; ok && j < patchCount; ++j)
+        {
+            std::string md5;
+            ManifestPatch patch;
+            ok = reader.read(&md5) && reader.read(&patch.path) && reader.read(&patch.size);
+            asset.patches.emplace(std::move(md5), std::move(patch));
+        }
+        asset.compressed = compressed != 0;
+        _assets.emplace(std::move(key), std::move(asset));
     }
-    else asset.downloadState = DownloadState::UNMARKED;
     
-    return asset;
+    if (!ok)
+    {
+        CCLOG("Fail to read manifest cache %s\n", cachePath.c_str());
+        _versionLoaded = _loaded = true;
+        clear();
+        return false;
+    }
+    _updating = updating != 0;
+    return true;
 }
 
-void Manifest::loadVersion(const rapidjson::Document &json)
+void Manifest::saveCache(const std::string &cachePath, const std::string &content) const
 {
-    // Retrieve remote manifest url
-    if ( json.HasMember(KEY_MANIFEST_URL) && json[KEY_MANIFEST_URL].IsString() )
-    {
-        _remoteManifestUrl = json[KEY_MANIFEST_URL].GetString();
-    }
+    CacheWriter writer;
+    char magic[4];
+    memcpy(magic, CACHE_MAGIC, sizeof(magic));
+    writer.write(magic);
+    writer.write((uint32_t)CACHE_VERSION);
+    writer.write((uint32_t)content.size());
+    writer.write((uint32_t)XXH32(content.data(), (int)content.size(), 0));
     
-    // Retrieve remote version url
-    if ( json.HasMember(KEY_VERSION_URL) && json[KEY_VERSION_URL].IsString() )
+    writer.write(_version);
+    writer.write(_packageUrl);
+    writer.write(_remoteManifestUrl);
+    writer.write(_remoteVersionUrl);
+    writer.write(_engineVer);
+    writer.write((uint8_t)_updating);
+    writer.write(_unknownMembers);
+    writer.write((uint32_t)_groups.size());
+    for (const auto& group : _groups)
     {
-        _remoteVersionUrl = json[KEY_VERSION_URL].GetString();
+        writer.write(group);
+        writer.write(_groupVer.at(group));
     }
-    
-    // Retrieve local version
-    if ( json.HasMember(KEY_VERSION) && json[KEY_VERSION].IsString() )
+    writer.write((uint32_t)_searchPaths.size());
+    for (const auto& path : _searchPaths)
     {
-        _version = json[KEY_VERSION].GetString();
+        writer.write(path);
     }
-    
-    // Retrieve local group version
-    if ( json.HasMember(KEY_GROUP_VERSIONS) )
+    writer.write((uint32_t)_assets.size());
+    for (const auto& it : _assets)
     {
-        const rapidjson::Value& groupVers = json[KEY_GROUP_VERSIONS];
-        if (groupVers.IsObject())
+        const Asset& asset = it.second;
+        writer.write(it.first);
+        writer.write(asset.md5);
+        writer.write(asset.path);
+        writer.write((uint8_t)asset.compressed);
+        writer.write(asset.size);
+        writer.write(asset.downloadState);
+        writer.write(asset.unknownMembers);
+        writer.write((uint32_t)asset.patches.size());
+        for (const auto& patch : asset.patches)
         {
-            for (rapidjson::Value::ConstMemberIterator itr = groupVers.MemberBegin(); itr != groupVers.MemberEnd(); ++itr)
-            {
-                std::string group = itr->name.GetString();
-                std::string version = "0";
-                if (itr->value.IsString())
-                {
-                    version = itr->value.GetString();
-                }
-                _groups.push_back(group);
-                _groupVer.emplace(group, version);
-            }
+            writer.write(patch.first);
+            writer.write(patch.second.path);
+            writer.write(patch.second.size);
         }
     }
-    
-    // Retrieve local engine version
-    if ( json.HasMember(KEY_ENGINE_VERSION) && json[KEY_ENGINE_VERSION].IsString() )
-    {
-        _engineVer = json[KEY_ENGINE_VERSION].GetString();
-    }
-    
-    // Retrieve updating flag
-    if ( json.HasMember(KEY_UPDATING) && json[KEY_UPDATING].IsBool() )
-    {
-        _updating = json[KEY_UPDATING].GetBool();
-    }
-    
-    _versionLoaded = true;
+    writeFileAtomically(_fileUtils, cachePath, writer.getBuffer());
 }
 
-void Manifest::loadManifest(const rapidjson::Document &json)
+void Manifest::saveToFile(const std::string &filepath)
 {
-    loadVersion(json);
-    
-    // Retrieve package url
-    if ( json.HasMember(KEY_PACKAGE_URL) && json[KEY_PACKAGE_URL].IsString() )
+    rapidjson::StringBuffer buffer;
+    rapidjson::PrettyWriter<rapidjson::StringBuffer> writer(buffer);
+    writer.StartObject();
+    writer.Key(KEY_PACKAGE_URL);
+    writer.String(_packageUrl.c_str(), (rapidjson::SizeType)_packageUrl.size());
+    writer.Key(KEY_MANIFEST_URL);
+    writer.String(_remoteManifestUrl.c_str(), (rapidjson::SizeType)_remoteManifestUrl.size());
+    writer.Key(KEY_VERSION_URL);
+    writer.String(_remoteVersionUrl.c_str(), (rapidjson::SizeType)_remoteVersionUrl.size());
+    writer.Key(KEY_VERSION);
+    writer.String(_version.c_str(), (rapidjson::SizeType)_version.size());
+    if (!_engineVer.empty())
     {
-        _packageUrl = json[KEY_PACKAGE_URL].GetString();
-        // Append automatically "/"
-        if (_packageUrl.size() > 0 && _packageUrl[_packageUrl.size() - 1] != '/')
-        {
-            _packageUrl.append("/");
-        }
+        writer.Key(KEY_ENGINE_VERSION);
+        writer.String(_engineVer.c_str(), (rapidjson::SizeType)_engineVer.size());
     }
-    
-    // Retrieve all assets
-    if ( json.HasMember(KEY_ASSETS) )
+    if (!_groups.empty())
     {
-        const rapidjson::Value& assets = json[KEY_ASSETS];
-        if (assets.IsObject())
+        writer.Key(KEY_GROUP_VERSIONS);
+        writer.StartObject();
+        for (const auto& group : _groups)
         {
-            for (rapidjson::Value::ConstMemberIterator itr = assets.MemberBegin(); itr != assets.MemberEnd(); ++itr)
-            {
-                std::string key = itr->name.GetString();
-                Asset asset = parseAsset(key, itr->value);
-                _assets.emplace(key, asset);
-            }
+            const std::string& groupVersion = _groupVer.at(group);
+            writer.Key(group.c_str(), (rapidjson::SizeType)group.size());
+            writer.String(groupVersion.c_str(), (rapidjson::SizeType)groupVersion.size());
         }
+        writer.EndObject();
     }
+    writer.Key(KEY_UPDATING);
+    writer.Bool(_updating);
     
-    // Retrieve all search paths
-    if ( json.HasMember(KEY_SEARCH_PATHS) )
+    writer.Key(KEY_ASSETS);
+    writer.StartObject();
+    for (const auto& it : _assets)
     {
-        const rapidjson::Value& paths = json[KEY_SEARCH_PATHS];
-        if (paths.IsArray())
+        const Asset& asset = it.second;
+        writer.Key(it.first.c_str(), (rapidjson::SizeType)it.first.size());
+        writer.StartObject();
+        writer.Key(KEY_MD5);
+        writer.String(asset.md5.c_str(), (rapidjson::SizeType)asset.md5.size());
+        if (asset.path != it.first)
+        {
+            writer.Key(KEY_PATH);
+            writer.String(asset.path.c_str(), (rapidjson::SizeType)asset.path.size());
+        }
+        if (asset.compressed)
+        {
+            writer.Key(KEY_COMPRESSED);
+            writer.Bool(true);
+        }
+        writer.Key(KEY_SIZE);
+        writer.Int((int)asset.size);
+        if (asset.downloadState != DownloadState::UNMARKED)
+        {
+            writer.Key(KEY_DOWNLOAD_STATE);
+            writer.Int(asset.downloadState);
+        }
+        if (!asset.patches.empty())
         {
-            for (rapidjson::SizeType i = 0; i < paths.Size(); ++i)
+            writer.Key(KEY_PATCHES);
+            writer.StartObject();
+            for (const auto& patch : asset.patches)
             {
-                if (paths[i].IsString()) {
-                    _searchPaths.push_back(paths[i].GetString());
-                }
+                writer.Key(patch.first.c_str(), (rapidjson::SizeType)patch.first.size());
+                writer.StartObject();
+                writer.Key(KEY_PATH);
+                writer.String(patch.second.path.c_str(), (rapidjson::SizeType)patch.second.path.size());
+                writer.Key(KEY_SIZE);
+                writer.Int((int)patch.second.size);
+                writer.EndObject();
             }
+            writer.EndObject();
         }
+        writeRawMembers(writer, asset.unknownMembers);
+        writer.EndObject();
     }
+    writer.EndObject();
     
-    _loaded = true;
-}
-
-void Manifest::saveToFile(const std::string &filepath)
-{
-    rapidjson::StringBuffer buffer;
-    rapidjson::PrettyWriter<rapidjson::StringBuffer> writer(buffer);
-    _json.Accept(writer);
+    writer.Key(KEY_SEARCH_PATHS);
+    writer.StartArray();
+    for (const auto& path : _searchPaths)
+    {
+        writer.String(path.c_str(), (rapidjson::SizeType)path.size());
+    }
+    writer.EndArray();
+    writeRawMembers(writer, _unknownMembers);
+    writer.EndObject();
     
-    std::ofstream output(FileUtils::getInstance()->getSuitableFOpen(filepath), std::ofstream::out);
-
-    if(!output.bad())
-        output << buffer.GetString() << std::endl;
+    std::string content(buffer.GetString(), buffer.GetSize());
+    content.push_back('\n');
+    if (writeFileAtomically(_fileUtils, filepath, content))
+    {
+        // Next parseFile() of this manifest reads the cache instead of the json
+        saveCache(getCachePath(filepath), content);
+    }
 }
 
 NS_CC_EXT_END
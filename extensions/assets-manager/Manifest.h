@@ -30,8 +30,6 @@
 #include "network/CCDownloader.h"
 #include "platform/CCFileUtils.h"
 
-#include "json/document-wrapper.h"
-
 NS_CC_EXT_BEGIN
 
 struct DownloadUnit
@@ -40,6 +38,17 @@ struct DownloadUnit
     std::string storagePath;
     std::string customId;
     float       size;
+    // Installed file the downloaded patch applies to, empty for full downloads
+    std::string basePath;
+};
+
+//! Binary delta from a previous version of an asset, see tools/assets-delta
+//! Members of a manifest object this runtime doesn't read, each key with its raw json value
+typedef std::vector<std::pair<std::string, std::string>> ManifestRawMembers;
+
+struct ManifestPatch {
+    std::string path;
+    float size;
 };
 
 struct ManifestAsset {
@@ -48,6 +57,10 @@ struct ManifestAsset {
     bool compressed;
     float size;
     int downloadState;
+    //! Patches keyed by the md5 of the version they apply to
+    std::unordered_map<std::string, ManifestPatch> patches;
+    //! Kept so saveToFile writes them back
+    ManifestRawMembers unknownMembers;
 };
 
 typedef std::unordered_map<std::string, DownloadUnit> DownloadUnits;
@@ -147,15 +160,27 @@ public:
     
 protected:
     
-    /** @brief Load the json file into local json object
+    /** @brief Load the json file into this manifest, from its binary cache when it is up to date
      * @param url Url of the json file
+     * @param versionOnly Skip the assets and search paths
      */
-    void loadJson(const std::string& url);
+    bool loadJson(const std::string& url, bool versionOnly);
     
-    /** @brief Load the json from a string into local json object
+    /** @brief Load the json from a string into this manifest, it is read as a stream without building a document
      * @param content The json content string
+     * @param versionOnly Skip the assets and search paths
+     */
+    bool loadJsonFromString(const std::string& content, bool versionOnly);
+    
+    /** @brief Load the binary cache saveToFile() writes next to a manifest
+     * @param cachePath Path of the cache
+     * @param content The json the cache must have been made from
      */
-    void loadJsonFromString(const std::string& content);
+    bool loadCache(const std::string &cachePath, const std::string &content);
+    
+    void saveCache(const std::string &cachePath, const std::string &content) const;
+    
+    static std::string getCachePath(const std::string &manifestPath);
     
     /** @brief Parse the version file information into this manifest
      * @param versionUrl Url of the local version file
@@ -189,14 +214,8 @@ protected:
      */
     void prependSearchPaths();
     
-    void loadVersion(const rapidjson::Document &json);
-    
-    void loadManifest(const rapidjson::Document &json);
-    
     void saveToFile(const std::string &filepath);
     
-    Asset parseAsset(const std::string &path, const rapidjson::Value &json);
-    
     void clear();
     
     /** @brief Gets all groups.
@@ -270,7 +289,10 @@ private:
     //! All search paths
     std::vector<std::string> _searchPaths;
     
-    rapidjson::Document _json;
+    //! Root members this runtime doesn't read, kept so saveToFile writes them back
+    ManifestRawMembers _unknownMembers;
+    
+    class JsonHandler;
 };
 
 NS_CC_EXT_END
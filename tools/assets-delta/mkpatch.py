@@ -0,0 +1,148 @@
+#!/usr/bin/env python
+# -*- coding: utf-8 -*-
+"""
+Makes binary patches for AssetsManagerEx, applied by applyPatch() in extensions/assets-manager/AssetsManagerEx.cpp.
+
+usage: mkpatch.py <old file> <new file> <output patch>
+       mkpatch.py --apply <old file> <patch> <output file>
+
+The patch is gzip compressed and holds, little endian: "CCDF", version, old size (u64), new size (u64),
+the xxhash32 of the new file, then instructions until the new file is complete, each an op byte and a u32 length:
+COPY is followed by the u64 offset of the bytes in the old file, ADD by the bytes themselves.
+
+The manifest entry of the new asset lists the patch under the md5 of the old version, the one printed here:
+
+    "patches" : { "<md5 of old file>" : { "path" : "<patch path from packageUrl>", "size" : <patch size> } }
+
+Assets without a patch for the installed version, or whose patch fails, are downloaded whole.
+"""
+
+import argparse
+import gzip
+import hashlib
+import os
+import struct
+import sys
+
+MAGIC = b'CCDF'
+VERSION = 1
+COPY, ADD = 0, 1
+
+BLOCK = 16
+MAX_LENGTH = 0xffffffff
+
+sys.path.insert(0, os.path.join(os.path.dirname(os.path.abspath(__file__)), '..', 'respack'))
+from respack import xxh32  # noqa: E402
+
+
+def index_blocks(old):
+    """Offsets of the BLOCK sized slices of the old file, the first one wins."""
+    blocks = {}
+    for offset in range(0, len(old) - BLOCK + 1, BLOCK):
+        blocks.setdefault(old[offset:offset + BLOCK], offset)
+    return blocks
+
+
+def match_length(old, old_offset, new, new_offset):
+    length = 0
+    limit = min(len(old) - old_offset, len(new) - new_offset)
+    step = 256
+    while length + step <= limit and old[old_offset + length:old_offset + length + step] == \
+            new[new_offset + length:new_offset + length + step]:
+        length += step
+    while length < limit and old[old_offset + length] == new[new_offset + length]:
+        length += 1
+    return length
+
+
+def diff(old, new):
+    """Yields (COPY, offset, length) and (ADD, bytes) instructions rebuilding new from old."""
+    blocks = index_blocks(old)
+    literal_start = 0
+    position = 0
+    while position + BLOCK <= len(new):
+        offset = blocks.get(new[position:position + BLOCK])
+        if offset is None:
+            position += 1
+            continue
+
+        # Grow the match back over the pending literal bytes
+        back = 0
+        while back < position - literal_start and back < offset and \
+                old[offset - back - 1] == new[position - back - 1]:
+            back += 1
+        start, offset = position - back, offset - back
+        length = match_length(old, offset, new, start)
+
+        if start > literal_start:
+            yield ADD, new[literal_start:start]
+        yield COPY, offset, length
+        position = literal_start = start + length
+
+    if literal_start < len(new):
+        yield ADD, new[literal_start:]
+
+
+def write_patch(old, new, output):
+    with gzip.open(output, 'wb', 9) as f:
+        f.write(MAGIC + struct.pack('<IQQI', VERSION, len(old), len(new), xxh32(new)))
+        for instruction in diff(old, new):
+            if instruction[0] == COPY:
+                _, offset, length = instruction
+                while length > 0:
+                    chunk = min(length, MAX_LENGTH)
+                    f.write(struct.pack('<BIQ', COPY, chunk, offset))
+                    offset += chunk
+                    length -= chunk
+            else:
+                data = instruction[1]
+                for start in range(0, len(data), MAX_LENGTH):
+                    chunk = data[start:start + MAX_LENGTH]
+                    f.write(struct.pack('<BI', ADD, len(chunk)) + chunk)
+
+
+def apply_patch(old, patch):
+    with gzip.open(patch, 'rb') as f:
+        magic, version, old_size, new_size, new_hash = struct.unpack('<4sIQQI', f.read(28))
+        if magic != MAGIC or version != VERSION or old_size != len(old):
+            raise ValueError('patch does not apply to this file')
+        new = bytearray()
+        while len(new) < new_size:
+            op, length = struct.unpack('<BI', f.read(5))
+            if op == COPY:
+                offset, = struct.unpack('<Q', f.read(8))
+                new += old[offset:offset + length]
+            else:
+                new += f.read(length)
+    new = bytes(new)
+    if len(new) != new_size or xxh32(new) != new_hash:
+        raise ValueError('patched file does not match')
+    return new
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Makes binary patches for AssetsManagerEx.')
+    parser.add_argument('--apply', action='store_true', help='apply a patch instead of making one')
+    parser.add_argument('old')
+    parser.add_argument('input')
+    parser.add_argument('output')
+    args = parser.parse_args()
+
+    with open(args.old, 'rb') as f:
+        old = f.read()
+    if args.apply:
+        with open(args.output, 'wb') as f:
+            f.write(apply_patch(old, args.input))
+        return
+
+    with open(args.input, 'rb') as f:
+        new = f.read()
+    write_patch(old, new, args.output)
+    if apply_patch(old, args.output) != new:
+        sys.exit('%s: round trip failed' % args.output)
+    size = os.path.getsize(args.output)
+    print('%s: %d bytes for %d, base md5 %s' % (args.output, size, len(new), hashlib.md5(old).hexdigest()))
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,161 @@
+#!/usr/bin/env python
+# -*- coding: utf-8 -*-
+"""
+Builds a resource pack for cocos2d::ResourcePack, see cocos/platform/CCResourcePack.h.
+
+usage: respack.py [-c none|deflate|lzma] [--store EXT,...] <resource dir> <output pack>
+
+Files are named by their path relative to the resource dir, with '/' separators.
+Entries only stay compressed when it saves space, and the extensions given to --store
+(textures and shaders by default) are always stored so they can be handed out without copies.
+"""
+
+import argparse
+import lzma
+import os
+import struct
+import sys
+import zlib
+
+MAGIC = b'CCPK'
+VERSION = 1
+ALIGNMENT = 16
+
+NONE, DEFLATE, LZMA = 0, 1, 2
+COMPRESSIONS = {'none': NONE, 'deflate': DEFLATE, 'lzma': LZMA}
+DEFAULT_STORED = '.bin,.png,.jpg,.jpeg,.pvr,.pkm,.ktx,.dds,.astc,.webp,.mp3,.ogg'
+
+PRIME32_1 = 2654435761
+PRIME32_2 = 2246822519
+PRIME32_3 = 3266489917
+PRIME32_4 = 668265263
+PRIME32_5 = 374761393
+MASK32 = 0xffffffff
+
+
+def _rotl(value, count):
+    return ((value << count) | (value >> (32 - count))) & MASK32
+
+
+def xxh32(data, seed=0):
+    """xxHash32, matches XXH32() of external/sources/xxhash."""
+    length = len(data)
+    offset = 0
+    if length >= 16:
+        v1 = (seed + PRIME32_1 + PRIME32_2) & MASK32
+        v2 = (seed + PRIME32_2) & MASK32
+        v3 = seed & MASK32
+        v4 = (seed - PRIME32_1) & MASK32
+        limit = length - 16
+        while offset <= limit:
+            lanes = struct.unpack_from('<4I', data, offset)
+            v1 = (_rotl((v1 + lanes[0] * PRIME32_2) & MASK32, 13) * PRIME32_1) & MASK32
+            v2 = (_rotl((v2 + lanes[1] * PRIME32_2) & MASK32, 13) * PRIME32_1) & MASK32
+            v3 = (_rotl((v3 + lanes[2] * PRIME32_2) & MASK32, 13) * PRIME32_1) & MASK32
+            v4 = (_rotl((v4 + lanes[3] * PRIME32_2) & MASK32, 13) * PRIME32_1) & MASK32
+            offset += 16
+        h32 = (_rotl(v1, 1) + _rotl(v2, 7) + _rotl(v3, 12) + _rotl(v4, 18)) & MASK32
+    else:
+        h32 = (seed + PRIME32_5) & MASK32
+
+    h32 = (h32 + length) & MASK32
+
+    while offset + 4 <= length:
+        lane, = struct.unpack_from('<I', data, offset)
+        h32 = (_rotl((h32 + lane * PRIME32_3) & MASK32, 17) * PRIME32_4) & MASK32
+        offset += 4
+
+    while offset < length:
+        byte = data[offset] if isinstance(data[offset], int) else ord(data[offset])
+        h32 = (_rotl((h32 + byte * PRIME32_5) & MASK32, 11) * PRIME32_1) & MASK32
+        offset += 1
+
+    h32 ^= h32 >> 15
+    h32 = (h32 * PRIME32_2) & MASK32
+    h32 ^= h32 >> 13
+    h32 = (h32 * PRIME32_3) & MASK32
+    h32 ^= h32 >> 16
+    return h32
+
+
+def compress_lzma(raw):
+    # LzmaDecode takes the 5 property bytes (lc=3, lp=0, pb=2, dictionary size) then the raw stream.
+    dict_size = 1 << 20
+    compressor = lzma.LZMACompressor(format=lzma.FORMAT_RAW, filters=[
+        {'id': lzma.FILTER_LZMA1, 'dict_size': dict_size, 'lc': 3, 'lp': 0, 'pb': 2}])
+    props = struct.pack('<BI', (2 * 5 + 0) * 9 + 3, dict_size)
+    return props + compressor.compress(raw) + compressor.flush()
+
+
+def compress(raw, compression):
+    if compression == DEFLATE:
+        return zlib.compress(raw, 9)
+    if compression == LZMA:
+        return compress_lzma(raw)
+    return raw
+
+
+def collect(root):
+    files = []
+    for directory, _, names in os.walk(root):
+        for name in names:
+            path = os.path.join(directory, name)
+            files.append((os.path.relpath(path, root).replace(os.sep, '/'), path))
+    return files
+
+
+def build(root, output, compression, stored):
+    entries = []
+    for name, path in collect(root):
+        with open(path, 'rb') as f:
+            raw = f.read()
+        method = NONE if os.path.splitext(name)[1].lower() in stored else compression
+        data = compress(raw, method) if method != NONE else raw
+        if method != NONE and len(data) >= len(raw):
+            method, data = NONE, raw
+        name_bytes = name.encode('utf-8')
+        entries.append((xxh32(name_bytes), name_bytes, method, data, len(raw)))
+
+    entries.sort(key=lambda entry: (entry[0], entry[1]))
+
+    names = b''.join(entry[1] for entry in entries)
+    header_size = 16 + 32 * len(entries) + len(names)
+    offset = (header_size + ALIGNMENT - 1) // ALIGNMENT * ALIGNMENT
+
+    index = []
+    blobs = []
+    name_offset = 0
+    for hash32, name_bytes, method, data, raw_size in entries:
+        index.append(struct.pack('<IIIIQII', hash32, name_offset, len(name_bytes), method, offset, len(data), raw_size))
+        padding = (ALIGNMENT - len(data) % ALIGNMENT) % ALIGNMENT
+        blobs.append(data + b'\0' * padding)
+        name_offset += len(name_bytes)
+        offset += len(data) + padding
+
+    with open(output, 'wb') as f:
+        f.write(MAGIC + struct.pack('<III', VERSION, len(entries), len(names)))
+        f.write(b''.join(index))
+        f.write(names)
+        f.write(b'\0' * ((ALIGNMENT - header_size % ALIGNMENT) % ALIGNMENT))
+        for blob in blobs:
+            f.write(blob)
+
+    print('%s: %d files, %d bytes' % (output, len(entries), offset))
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Builds a resource pack for cocos2d::ResourcePack.')
+    parser.add_argument('-c', '--compression', choices=sorted(COMPRESSIONS), default='lzma')
+    parser.add_argument('--store', default=DEFAULT_STORED, help='comma separated extensions never compressed')
+    parser.add_argument('root')
+    parser.add_argument('output')
+    args = parser.parse_args()
+
+    if not os.path.isdir(args.root):
+        sys.exit('%s is not a directory' % args.root)
+    stored = set(ext.strip().lower() for ext in args.store.split(',') if ext.strip())
+    build(args.root, args.output, COMPRESSIONS[args.compression], stored)
+
+
+if __name__ == '__main__':
+    main()